@@ -198,6 +198,11 @@ ifxConnCache_add(Oid foreignTableOid, IfxConnectionInfo *coninfo, bool *found)
 		/* also initialize usage counter */
 		item->con.usage = 1;
 
+		/* empty statement cache */
+		item->stmt_cache      = NIL;
+		item->stmt_cache_size = coninfo->stmt_cache_size;
+		item->keysets         = NIL;
+
 		MemoryContextSwitchTo(old_cxt);
 	}
 	else
@@ -254,6 +259,33 @@ ifxConnCache_rm(char *conname, bool *found)
 	item = hash_search(ifxCache.connections, (void *) conname,
 					   HASH_REMOVE, found);
 
+	/*
+	 * Cached statements don't survive the connection, release
+	 * their memory. The remote resources go away with the
+	 * connection itself.
+	 */
+	if (item != NULL)
+	{
+		ListCell *cell;
+
+		foreach(cell, item->stmt_cache)
+			ifxStmtCache_free((IfxCachedStatement *) lfirst(cell));
+
+		list_free(item->stmt_cache);
+		item->stmt_cache = NIL;
+
+		foreach(cell, item->keysets)
+		{
+			IfxCachedKeySet *keyset = (IfxCachedKeySet *) lfirst(cell);
+
+			pfree(keyset->tablename);
+			pfree(keyset);
+		}
+
+		list_free(item->keysets);
+		item->keysets = NIL;
+	}
+
 	/*
 	 * If something found, return it, otherwise
 	 * NULL is returned.
@@ -261,6 +293,166 @@ ifxConnCache_rm(char *conname, bool *found)
 	return item;
 }
 
+/*
+ * Looks up the statement cache of the specified connection for
+ * a prepared statement with the given query text and cursor type.
+ * A statement found is moved to the head of the cache, so the
+ * cache is maintained in LRU order.
+ *
+ * Returns NULL if no such statement is cached.
+ */
+IfxCachedStatement *
+ifxStmtCache_lookup(IfxCachedConnection *cached, char *query,
+					IfxCursorUsage cursorUsage)
+{
+	ListCell *cell;
+
+	foreach(cell, cached->stmt_cache)
+	{
+		IfxCachedStatement *stmt = (IfxCachedStatement *) lfirst(cell);
+
+		if ((stmt->cursorUsage == cursorUsage)
+			&& (strcmp(stmt->query, query) == 0))
+		{
+			MemoryContext old_cxt;
+
+			old_cxt = MemoryContextSwitchTo(TopMemoryContext);
+			cached->stmt_cache = lcons(stmt,
+									   list_delete_ptr(cached->stmt_cache, stmt));
+			MemoryContextSwitchTo(old_cxt);
+
+			return stmt;
+		}
+	}
+
+	return NULL;
+}
+
+/*
+ * Returns the cached statement with the specified statement
+ * identifier, NULL if not cached (anymore).
+ */
+IfxCachedStatement *
+ifxStmtCache_find(IfxCachedConnection *cached, char *stmt_name)
+{
+	ListCell *cell;
+
+	if (stmt_name == NULL)
+		return NULL;
+
+	foreach(cell, cached->stmt_cache)
+	{
+		IfxCachedStatement *stmt = (IfxCachedStatement *) lfirst(cell);
+
+		if (strcmp(stmt->stmt_name, stmt_name) == 0)
+			return stmt;
+	}
+
+	return NULL;
+}
+
+/*
+ * Adds the prepared statement and cursor of the specified
+ * statement info to the statement cache of the connection.
+ * The caller is responsible to make room for the new
+ * statement, see ifxStmtCache_victim().
+ */
+IfxCachedStatement *
+ifxStmtCache_add(IfxCachedConnection *cached, IfxStatementInfo *info,
+				 double estimated_rows, double costs)
+{
+	IfxCachedStatement *stmt;
+	MemoryContext       old_cxt;
+
+	/*
+	 * Cached statements must survive the current
+	 * transaction.
+	 */
+	old_cxt = MemoryContextSwitchTo(TopMemoryContext);
+
+	stmt = (IfxCachedStatement *) palloc0(sizeof(IfxCachedStatement));
+	stmt->query          = pstrdup(info->query);
+	stmt->cursorUsage    = info->cursorUsage;
+	stmt->stmt_name      = pstrdup(info->stmt_name);
+	stmt->cursor_name    = pstrdup(info->cursor_name);
+	stmt->estimated_rows = estimated_rows;
+	stmt->costs          = costs;
+	stmt->sqlda          = NULL;
+	stmt->ifxAttrDefs    = NULL;
+	stmt->in_use         = InvalidLocalTransactionId;
+
+	cached->stmt_cache = lcons(stmt, cached->stmt_cache);
+
+	MemoryContextSwitchTo(old_cxt);
+
+	return stmt;
+}
+
+/*
+ * Returns the least recently used statement which should be
+ * removed from the statement cache to make room for a new one.
+ * Statements with a cursor opened by the specified local
+ * transaction are never choosen.
+ *
+ * Returns NULL if the cache isn't full yet or all statements
+ * are in use.
+ */
+IfxCachedStatement *
+ifxStmtCache_victim(IfxCachedConnection *cached, LocalTransactionId lxid)
+{
+	IfxCachedStatement *victim = NULL;
+	ListCell           *cell;
+
+	if (list_length(cached->stmt_cache) < cached->stmt_cache_size)
+		return NULL;
+
+	foreach(cell, cached->stmt_cache)
+	{
+		IfxCachedStatement *stmt = (IfxCachedStatement *) lfirst(cell);
+
+		if (stmt->in_use != lxid)
+			victim = stmt;
+	}
+
+	return victim;
+}
+
+/*
+ * Removes the specified statement from the statement cache.
+ * The statement itself isn't freed.
+ */
+void ifxStmtCache_rm(IfxCachedConnection *cached, IfxCachedStatement *stmt)
+{
+	MemoryContext old_cxt;
+
+	old_cxt = MemoryContextSwitchTo(TopMemoryContext);
+	cached->stmt_cache = list_delete_ptr(cached->stmt_cache, stmt);
+	MemoryContextSwitchTo(old_cxt);
+}
+
+/*
+ * Releases all memory of a cached statement, including
+ * its SQLDA structure. Resources on the INFORMIX server
+ * must have been freed by the caller already.
+ */
+void ifxStmtCache_free(IfxCachedStatement *stmt)
+{
+	/*
+	 * The SQLDA structure was allocated by
+	 * ESQL/C, see ifxDeallocateSQLDA().
+	 */
+	if (stmt->sqlda != NULL)
+		free(stmt->sqlda);
+
+	if (stmt->ifxAttrDefs != NULL)
+		pfree(stmt->ifxAttrDefs);
+
+	pfree(stmt->query);
+	pfree(stmt->stmt_name);
+	pfree(stmt->cursor_name);
+	pfree(stmt);
+}
+
 /*
  * Registers or updates the given foreign table (FT) in the
  * local backend cache. Returns a pointer to the cached FT structure.
@@ -286,11 +478,392 @@ IfxFTCacheItem *ifxFTCache_add(Oid foreignTableOid, char *conname)
 	 */
 	if (!found)
 	{
-		/* TO DO: initialize cached table properties */
 		item->foreignTableOid = foreignTableOid;
 		bzero(item->ifx_connection_name, IFX_CONNAME_LEN);
 		StrNCpy(item->ifx_connection_name, conname, strlen(conname));
+		item->estimates = NIL;
+		item->feedback  = NIL;
+		item->nindexes  = -1;
+		item->indexes   = NULL;
 	}
 
 	return item;
 }
+
+/*
+ * Frees a single cached estimate.
+ */
+static void ifxFTCache_freeEstimate(IfxCachedEstimate *estimate)
+{
+	pfree(estimate->shape);
+
+	if (estimate->widths != NULL)
+		pfree(estimate->widths);
+
+	pfree(estimate);
+}
+
+/*
+ * Frees all cached estimates of the given foreign table
+ * cache item.
+ */
+static void ifxFTCache_freeEstimates(IfxFTCacheItem *item)
+{
+	ListCell *cell;
+
+	foreach(cell, item->estimates)
+	{
+		ifxFTCache_freeEstimate((IfxCachedEstimate *) lfirst(cell));
+	}
+
+	list_free(item->estimates);
+	item->estimates = NIL;
+}
+
+/*
+ * Frees the row feedback of the given foreign table
+ * cache item.
+ */
+static void ifxFTCache_freeFeedback(IfxFTCacheItem *item)
+{
+	ListCell *cell;
+
+	foreach(cell, item->feedback)
+	{
+		IfxRowFeedback *feedback = (IfxRowFeedback *) lfirst(cell);
+
+		pfree(feedback->shape);
+		pfree(feedback);
+	}
+
+	list_free(item->feedback);
+	item->feedback = NIL;
+}
+
+/*
+ * Frees the cached index definitions of the given foreign
+ * table cache item.
+ */
+static void ifxFTCache_freeIndexes(IfxFTCacheItem *item)
+{
+	if (item->indexes != NULL)
+		pfree(item->indexes);
+
+	item->nindexes = -1;
+	item->indexes  = NULL;
+}
+
+/*
+ * Returns the cached estimates for a query of the given shape
+ * on the specified foreign table, NULL if there are none or they
+ * are expired already. Expired entries are dropped from the cache.
+ */
+IfxCachedEstimate *ifxFTCache_getEstimate(Oid foreignTableOid,
+										  char *shape)
+{
+	IfxFTCacheItem *item;
+	ListCell       *cell;
+	bool            found;
+
+	Assert(IfxCacheIsInitialized);
+
+	item = hash_search(ifxCache.tables, (void *) &foreignTableOid,
+					   HASH_FIND, &found);
+
+	if (!found)
+		return NULL;
+
+	foreach(cell, item->estimates)
+	{
+		IfxCachedEstimate *estimate = (IfxCachedEstimate *) lfirst(cell);
+		MemoryContext      old_ctxt;
+
+		if (strcmp(estimate->shape, shape) != 0)
+			continue;
+
+		if (GetCurrentTimestamp() < estimate->valid_until)
+			return estimate;
+
+		old_ctxt = MemoryContextSwitchTo(TopMemoryContext);
+		item->estimates = list_delete_ptr(item->estimates, estimate);
+		MemoryContextSwitchTo(old_ctxt);
+
+		ifxFTCache_freeEstimate(estimate);
+		break;
+	}
+
+	return NULL;
+}
+
+/*
+ * Saves the estimates for a query of the given shape to the
+ * foreign table cache item, valid for ttl seconds. widths holds the
+ * column widths of the attributes 1 to natts, it might be NULL. If
+ * the maximum number of estimates per foreign table is reached, the
+ * oldest entry is replaced.
+ */
+void ifxFTCache_putEstimate(IfxFTCacheItem *item,
+							char *shape,
+							double estimated_rows,
+							double costs,
+							int *widths,
+							int natts,
+							int ttl)
+{
+	IfxCachedEstimate *estimate;
+	MemoryContext      old_ctxt;
+
+	old_ctxt = MemoryContextSwitchTo(TopMemoryContext);
+
+	if (list_length(item->estimates) >= IFX_FTCACHE_ESTIMATES)
+	{
+		estimate = (IfxCachedEstimate *) llast(item->estimates);
+		item->estimates = list_delete_ptr(item->estimates, estimate);
+
+		ifxFTCache_freeEstimate(estimate);
+	}
+
+	estimate = (IfxCachedEstimate *) palloc(sizeof(IfxCachedEstimate));
+	estimate->shape          = pstrdup(shape);
+	estimate->estimated_rows = estimated_rows;
+	estimate->costs          = costs;
+	estimate->valid_until    = TimestampTzPlusMilliseconds(GetCurrentTimestamp(),
+															 ttl * 1000L);
+	estimate->natts          = natts;
+	estimate->widths         = NULL;
+
+	if (widths != NULL)
+	{
+		estimate->widths = (int *) palloc((natts + 1) * sizeof(int));
+		memcpy(estimate->widths, widths, (natts + 1) * sizeof(int));
+	}
+
+	item->estimates = lcons(estimate, item->estimates);
+
+	MemoryContextSwitchTo(old_ctxt);
+}
+
+/*
+ * Drops all cached estimates, row feedback and index definitions
+ * of the specified foreign table. If InvalidOid is passed, the cached
+ * data of all foreign tables is dropped.
+ */
+void ifxFTCache_invalidate(Oid foreignTableOid)
+{
+	IfxFTCacheItem *item;
+
+	if (!IfxCacheIsInitialized)
+		return;
+
+	if (foreignTableOid == InvalidOid)
+	{
+		HASH_SEQ_STATUS hash_seq;
+
+		hash_seq_init(&hash_seq, ifxCache.tables);
+
+		while ((item = (IfxFTCacheItem *) hash_seq_search(&hash_seq)) != NULL)
+		{
+			ifxFTCache_freeEstimates(item);
+			ifxFTCache_freeFeedback(item);
+			ifxFTCache_freeIndexes(item);
+		}
+	}
+	else
+	{
+		bool found;
+
+		item = hash_search(ifxCache.tables, (void *) &foreignTableOid,
+						   HASH_FIND, &found);
+
+		if (found)
+		{
+			ifxFTCache_freeEstimates(item);
+			ifxFTCache_freeFeedback(item);
+			ifxFTCache_freeIndexes(item);
+		}
+	}
+}
+
+/*
+ * Returns the number of cached index definitions of the specified
+ * foreign table and stores them in *indexes. Returns -1 if they
+ * weren't retrieved yet.
+ */
+int ifxFTCache_getIndexes(Oid foreignTableOid,
+						  IfxIndexDef **indexes)
+{
+	IfxFTCacheItem *item;
+	bool            found;
+
+	*indexes = NULL;
+
+	if (!IfxCacheIsInitialized)
+		return -1;
+
+	item = hash_search(ifxCache.tables, (void *) &foreignTableOid,
+					   HASH_FIND, &found);
+
+	if (!found)
+		return -1;
+
+	*indexes = item->indexes;
+	return item->nindexes;
+}
+
+/*
+ * Caches the index definitions of a foreign table,
+ * replacing any former ones.
+ */
+void ifxFTCache_putIndexes(IfxFTCacheItem *item,
+						   IfxIndexDef *indexes,
+						   int nindexes)
+{
+	ifxFTCache_freeIndexes(item);
+
+	if (nindexes > 0)
+	{
+		item->indexes = (IfxIndexDef *) MemoryContextAlloc(TopMemoryContext,
+														   nindexes * sizeof(IfxIndexDef));
+		memcpy(item->indexes, indexes, nindexes * sizeof(IfxIndexDef));
+	}
+
+	item->nindexes = nindexes;
+}
+
+/*
+ * Returns the row feedback for queries of the given shape on
+ * the specified foreign table, NULL if there is none.
+ */
+IfxRowFeedback *ifxFTCache_getFeedback(Oid foreignTableOid,
+									   char *shape)
+{
+	IfxFTCacheItem *item;
+	ListCell       *cell;
+	bool            found;
+
+	if (!IfxCacheIsInitialized)
+		return NULL;
+
+	item = hash_search(ifxCache.tables, (void *) &foreignTableOid,
+					   HASH_FIND, &found);
+
+	if (!found)
+		return NULL;
+
+	foreach(cell, item->feedback)
+	{
+		IfxRowFeedback *feedback = (IfxRowFeedback *) lfirst(cell);
+
+		if (strcmp(feedback->shape, shape) == 0)
+			return feedback;
+	}
+
+	return NULL;
+}
+
+/*
+ * Records the number of rows returned by a completed scan
+ * with a query of the given shape. The feedback averages the
+ * last IFX_FEEDBACK_WINDOW scans. If the maximum number of
+ * entries per foreign table is reached, the least recently
+ * updated entry is replaced.
+ */
+void ifxFTCache_putFeedback(IfxFTCacheItem *item,
+							char *shape,
+							double rows)
+{
+	IfxRowFeedback *feedback = NULL;
+	ListCell       *cell;
+	MemoryContext   old_ctxt;
+
+	old_ctxt = MemoryContextSwitchTo(TopMemoryContext);
+
+	foreach(cell, item->feedback)
+	{
+		if (strcmp(((IfxRowFeedback *) lfirst(cell))->shape, shape) == 0)
+		{
+			feedback = (IfxRowFeedback *) lfirst(cell);
+			item->feedback = list_delete_ptr(item->feedback, feedback);
+			break;
+		}
+	}
+
+	if (feedback == NULL)
+	{
+		if (list_length(item->feedback) >= IFX_FTCACHE_ESTIMATES)
+		{
+			feedback = (IfxRowFeedback *) llast(item->feedback);
+			item->feedback = list_delete_ptr(item->feedback, feedback);
+
+			pfree(feedback->shape);
+			pfree(feedback);
+		}
+
+		feedback = (IfxRowFeedback *) palloc(sizeof(IfxRowFeedback));
+		feedback->shape    = pstrdup(shape);
+		feedback->rows     = 0;
+		feedback->nsamples = 0;
+	}
+
+	if (feedback->nsamples < IFX_FEEDBACK_WINDOW)
+		feedback->nsamples++;
+
+	feedback->rows += (rows - feedback->rows) / feedback->nsamples;
+
+	item->feedback = lcons(feedback, item->feedback);
+
+	MemoryContextSwitchTo(old_ctxt);
+}
+
+/*
+ * Remembers a key set table created on the specified connection
+ * by the given subtransaction, until ifxKeySetCache_rm() is called
+ * for it.
+ */
+void ifxKeySetCache_add(IfxCachedConnection *cached, char *tablename,
+						SubTransactionId subid)
+{
+	IfxCachedKeySet *keyset;
+	MemoryContext    old_cxt;
+
+	/*
+	 * The table might outlive the scan and the current
+	 * memory context after an error.
+	 */
+	old_cxt = MemoryContextSwitchTo(TopMemoryContext);
+
+	keyset = (IfxCachedKeySet *) palloc(sizeof(IfxCachedKeySet));
+	keyset->tablename = pstrdup(tablename);
+	keyset->subid     = subid;
+
+	cached->keysets = lappend(cached->keysets, keyset);
+
+	MemoryContextSwitchTo(old_cxt);
+}
+
+/*
+ * Forgets the specified key set table of the connection,
+ * once it was dropped.
+ */
+void ifxKeySetCache_rm(IfxCachedConnection *cached, char *tablename)
+{
+	ListCell *cell;
+
+	foreach(cell, cached->keysets)
+	{
+		IfxCachedKeySet *keyset = (IfxCachedKeySet *) lfirst(cell);
+
+		if (strcmp(keyset->tablename, tablename) == 0)
+		{
+			MemoryContext old_cxt;
+
+			old_cxt = MemoryContextSwitchTo(TopMemoryContext);
+			cached->keysets = list_delete_ptr(cached->keysets, keyset);
+			MemoryContextSwitchTo(old_cxt);
+
+			pfree(keyset->tablename);
+			pfree(keyset);
+			return;
+		}
+	}
+}
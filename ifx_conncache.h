@@ -18,6 +18,60 @@
 #include "nodes/pg_list.h"
 #include "utils/hsearch.h"
 #include "utils/dynahash.h"
+#include "utils/timestamp.h"
+
+/*
+ * Default number of seconds plan-time estimates of
+ * a foreign table are cached.
+ */
+#define IFX_ESTIMATE_CACHE_TTL 60
+
+/*
+ * Maximum number of cached estimates and row feedback
+ * entries per foreign table.
+ */
+#define IFX_FTCACHE_ESTIMATES 16
+
+/*
+ * Cost estimates reported by the INFORMIX server for
+ * a query of a foreign table. The shape is the remote query text
+ * with all literals replaced by placeholders, so queries just differing
+ * in their constant values share the same estimates.
+ */
+typedef struct IfxCachedEstimate
+{
+	char       *shape;
+	double      estimated_rows;
+	double      costs;
+	TimestampTz valid_until;
+
+	/*
+	 * Column widths reported by the INFORMIX server, indexed by
+	 * the attribute numbers 1 to natts of the foreign table.
+	 * NULL if not known.
+	 */
+	int         natts;
+	int        *widths;
+} IfxCachedEstimate;
+
+/*
+ * Number of executed scans a row feedback entry averages
+ * over. Older observations lose their weight, so the feedback
+ * follows changes of the remote table.
+ */
+#define IFX_FEEDBACK_WINDOW 8
+
+/*
+ * Number of rows actually returned by completed scans of
+ * a foreign table with a query of the same shape, see
+ * IfxCachedEstimate.
+ */
+typedef struct IfxRowFeedback
+{
+	char   *shape;
+	double  rows;
+	int     nsamples;
+} IfxRowFeedback;
 
 /*
  * Cached information for an INFORMIX
@@ -34,10 +88,86 @@ typedef struct IfxFTCacheItem
 	Oid foreignTableOid;
 
 	/*
-	 * XXX: Cached cost estimates for this foreign table
+	 * Cached cost estimates for this foreign table, a list
+	 * of IfxCachedEstimate with the most recent entry first.
+	 */
+	List *estimates;
+
+	/*
+	 * Row feedback of executed scans, a list of IfxRowFeedback
+	 * with the most recent entry first.
 	 */
+	List *feedback;
+
+	/*
+	 * Indexes of the remote table, with the column numbers of
+	 * their parts mapped to attribute numbers of the foreign table.
+	 * nindexes is -1 as long as they weren't retrieved.
+	 */
+	int          nindexes;
+	IfxIndexDef *indexes;
 } IfxFTCacheItem;
 
+/*
+ * Default number of prepared statements cached
+ * per INFORMIX database connection.
+ */
+#define IFX_STMT_CACHE_SIZE 32
+
+/*
+ * Prepared statement and cursor kept in the statement cache
+ * of an INFORMIX database connection. Cached statements are
+ * identified by their query text and cursor type, repeated scans
+ * with the same query just need to OPEN the cursor again.
+ */
+typedef struct IfxCachedStatement
+{
+	char           *query;
+	IfxCursorUsage  cursorUsage;
+
+	/*
+	 * Identifiers of the prepared statement and
+	 * its cursor on the INFORMIX server.
+	 */
+	char *stmt_name;
+	char *cursor_name;
+
+	/*
+	 * Estimates reported by the INFORMIX server when
+	 * the statement was prepared.
+	 */
+	double estimated_rows;
+	double costs;
+
+	/*
+	 * DESCRIBEd SQLDA structure and column descriptors, saved
+	 * by the first scan using this statement. sqlda is NULL
+	 * until then.
+	 */
+	void       *sqlda;
+	int         ifxAttrCount;
+	IfxAttrDef *ifxAttrDefs;
+	size_t      row_size;
+	short       special_cols;
+
+	/*
+	 * Local transaction which has opened the cursor,
+	 * InvalidLocalTransactionId if not in use.
+	 */
+	LocalTransactionId in_use;
+} IfxCachedStatement;
+
+/*
+ * Key set table created on a cached connection, see
+ * ifxCreateKeySetTables(). subid is the subtransaction
+ * which created it.
+ */
+typedef struct IfxCachedKeySet
+{
+	char             *tablename;
+	SubTransactionId  subid;
+} IfxCachedKeySet;
+
 /*
  * Cached informix database connection.
  * Derived from IfxPGCachedConnection.
@@ -46,6 +176,21 @@ typedef struct IfxCachedConnection
 {
 	IfxPGCachedConnection con;
 	Oid establishedByOid;
+
+	/*
+	 * Statement cache of this connection, a list of
+	 * IfxCachedStatement with the most recently used
+	 * statement first.
+	 */
+	List *stmt_cache;
+	int   stmt_cache_size;
+
+	/*
+	 * Key set tables of foreign scans not ended yet, a list
+	 * of IfxCachedKeySet. Scans aborted by an error leave them
+	 * to the transaction callbacks.
+	 */
+	List *keysets;
 } IfxCachedConnection;
 
 /*
@@ -74,6 +219,39 @@ void InformixCacheInit(void);
  * Register a new INFORMIX foreign table to the cache.
  */
 IfxFTCacheItem *ifxFTCache_add(Oid foreignTableOid, char *conname);
+
+/*
+ * Cost estimates of a cached foreign table.
+ */
+IfxCachedEstimate *ifxFTCache_getEstimate(Oid foreignTableOid,
+										  char *shape);
+void ifxFTCache_putEstimate(IfxFTCacheItem *item,
+							char *shape,
+							double estimated_rows,
+							double costs,
+							int *widths,
+							int natts,
+							int ttl);
+void ifxFTCache_invalidate(Oid foreignTableOid);
+
+/*
+ * Index definitions of a cached foreign table.
+ */
+int ifxFTCache_getIndexes(Oid foreignTableOid,
+						  IfxIndexDef **indexes);
+void ifxFTCache_putIndexes(IfxFTCacheItem *item,
+						   IfxIndexDef *indexes,
+						   int nindexes);
+
+/*
+ * Row feedback of a cached foreign table.
+ */
+IfxRowFeedback *ifxFTCache_getFeedback(Oid foreignTableOid,
+									   char *shape);
+void ifxFTCache_putFeedback(IfxFTCacheItem *item,
+							char *shape,
+							double rows);
+
 IfxCachedConnection *ifxConnCache_add(Oid foreignTableOid,
 									  IfxConnectionInfo *coninfo,
                                       bool *found);
@@ -81,4 +259,29 @@ IfxCachedConnection *ifxConnCache_rm(char *conname,
                                      bool *found);
 IfxCachedConnection *ifxConnCache_exists(char *conname, bool *found);
 
+/*
+ * Statement cache of a connection.
+ */
+IfxCachedStatement *ifxStmtCache_lookup(IfxCachedConnection *cached,
+										char *query,
+										IfxCursorUsage cursorUsage);
+IfxCachedStatement *ifxStmtCache_find(IfxCachedConnection *cached,
+									  char *stmt_name);
+IfxCachedStatement *ifxStmtCache_add(IfxCachedConnection *cached,
+									 IfxStatementInfo *info,
+									 double estimated_rows,
+									 double costs);
+IfxCachedStatement *ifxStmtCache_victim(IfxCachedConnection *cached,
+										LocalTransactionId lxid);
+void ifxStmtCache_rm(IfxCachedConnection *cached,
+					 IfxCachedStatement *stmt);
+void ifxStmtCache_free(IfxCachedStatement *stmt);
+
+/*
+ * Key set tables of a connection.
+ */
+void ifxKeySetCache_add(IfxCachedConnection *cached, char *tablename,
+						SubTransactionId subid);
+void ifxKeySetCache_rm(IfxCachedConnection *cached, char *tablename);
+
 #endif
@@ -22,16 +22,27 @@
 #include "access/htup_details.h"
 #endif
 
+#if PG_VERSION_NUM >= 90600
+#include "catalog/pg_aggregate.h"
+#endif
+#include "catalog/dependency.h"
 #include "catalog/pg_cast.h"
+#include "catalog/pg_collation.h"
 #include "catalog/pg_namespace.h"
 #include "catalog/pg_operator.h"
+#include "catalog/pg_proc.h"
 #include "catalog/pg_type.h"
+#include "commands/extension.h"
 #include "foreign/fdwapi.h"
 #include "foreign/foreign.h"
 #include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "optimizer/var.h"
 #include "parser/parsetree.h"
 #include "rewrite/rewriteManip.h"
 #include "utils/builtins.h"
+#include "utils/date.h"
+#include "utils/datetime.h"
 #include "utils/formatting.h"
 #include "utils/lsyscache.h"
 #include "utils/numeric.h"
@@ -41,6 +52,11 @@
 #endif
 
 #include "utils/syscache.h"
+#include "utils/timestamp.h"
+
+#if PG_VERSION_NUM >= 100000
+#include "utils/varlena.h"
+#endif
 
 #include "ifx_fdw.h"
 #include "ifx_node_utils.h"
@@ -58,6 +74,11 @@ deparse_predicate_node(IfxPushdownOprContext *context,
 
 static char *getIfxOperatorIdent(IfxPushdownOprInfo *pushdownInfo);
 static char * getConstValue(Const *constNode);
+static char *ifxDateTimeLiteral(Const *constNode);
+static bool ifxIntervalClassMatches(Const *constNode, Node *other);
+static bool ifxIsRuntimeParam(Node *node, IfxOprType oprtype);
+static char *ifxDeparseRuntimeParam(IfxPushdownOprContext *context,
+									Node *node);
 static void rewriteInExprContext(Const *arrayConst,
 								 IfxPushdownInOprContext *cxt);
 void deparse_node_list_for_InExpr(IfxPushdownOprContext *context,
@@ -65,6 +86,28 @@ void deparse_node_list_for_InExpr(IfxPushdownOprContext *context,
 								  IfxPushdownOprInfo *info);
 static regproc getTypeOutputFunction(Oid inputOid);
 
+#if PG_VERSION_NUM >= 90600
+
+static bool ifxDeparseConst(Const *constNode, IfxDeparseContext *context);
+static bool ifxDeparseAggref(Aggref *aggref, IfxDeparseContext *context);
+static char *ifxGetAggregateIdent(Aggref *aggref);
+static char *ifxAggResultCast(Oid aggtype);
+static char *ifxNumericCast(Oid sourcetype);
+static const IfxShippableObject *ifxLookupShippableObject(char kind,
+														   Oid objid,
+														   List *args);
+static bool ifxShippableTypeMatches(Node *arg, IfxShippableTypes types);
+static bool ifxDeparseShippableObject(const IfxShippableObject *object,
+									  Oid resulttype,
+									  List *args,
+									  IfxDeparseContext *context);
+static bool ifxDeparseFuncExpr(FuncExpr *func, IfxDeparseContext *context);
+static bool ifxDeparseCoalesceArgs(List *args, int argno,
+								   IfxDeparseContext *context);
+static bool ifxDeparseCaseExpr(CaseExpr *caseexpr, IfxDeparseContext *context);
+
+#endif
+
 #if PG_VERSION_NUM >= 90300
 
 static inline char *interval_to_cstring(IfxFdwExecutionState *state,
@@ -2038,6 +2081,9 @@ static char *getIfxOperatorIdent(IfxPushdownOprInfo *pushdownInfo)
 		case IFX_OPR_LIKE:
 			result = "LIKE";
 			break;
+		case IFX_OPR_NOT_LIKE:
+			result = "NOT LIKE";
+			break;
 		default:
 			/* should not happen */
 			elog(ERROR, "could not deparse operator type %d",
@@ -2115,6 +2161,11 @@ IfxOprType mapPushdownOperator(Oid oprid, IfxPushdownOprInfo *pushdownInfo)
 		pushdownInfo->type = IFX_OPR_LIKE;
 		return IFX_OPR_LIKE;
 	}
+	else if (strcmp(oprname, "!~~") == 0)
+	{
+		pushdownInfo->type = IFX_OPR_NOT_LIKE;
+		return IFX_OPR_NOT_LIKE;
+	}
 	else
 	{
 		pushdownInfo->type = IFX_OPR_NOT_SUPPORTED;
@@ -2152,17 +2203,31 @@ static List *make_deparse_context(Oid foreignRelid)
 	(b)->predicates = lappend((b)->predicates, (a)); \
 	(b)->count++;
 
-static inline bool isCompatibleForPushdown(Oid typeOid)
+/*
+ * Checks wether the specified constant can be pushed down. other
+ * is the expression it is compared with, NULL if there's none.
+ */
+static inline bool isCompatibleForPushdown(Const *constNode, Node *other)
 {
-	switch(typeOid)
+	switch(constNode->consttype)
 	{
+		case TIMETZOID:
+			/* Informix doesn't know about time zones */
+			return false;
 		case INTERVALOID:
+			if (!ifxIntervalClassMatches(constNode, other))
+				return false;
+			/* fall through */
 		case TIMESTAMPOID:
 		case TIMEOID:
 		case TIMESTAMPTZOID:
-		case TIMETZOID:
 		case DATEOID:
-			return false;
+			/*
+			 * Only values with an Informix literal, e.g.
+			 * not infinity.
+			 */
+			return (constNode->constisnull
+					|| (ifxDateTimeLiteral(constNode) != NULL));
 	}
 
 	/* all other values are safe */
@@ -2639,7 +2704,7 @@ void deparse_node_list_for_InExpr(IfxPushdownOprContext *context,
 				 * Check wether this Const node has
 				 * a datatype which can be pushed down safely.
 				 */
-				if (!isCompatibleForPushdown(constval->consttype))
+				if (!isCompatibleForPushdown(constval, (Node *) in_cxt->colref))
 				{
 					IFX_MARK_PREDICATE_NOT_SUPPORTED(info);
 					break;
@@ -2733,7 +2798,6 @@ bool ifx_predicate_tree_walker(Node *node, struct IfxPushdownOprContext *context
 					case OR_EXPR:
 						info->type        = IFX_OPR_OR;
 						info->expr_string = cstring_to_text("OR");
-						context->has_or_expr = true;
 						break;
 					case NOT_EXPR:
 						info->type        = IFX_OPR_NOT;
@@ -3028,12 +3092,19 @@ bool ifx_predicate_tree_walker(Node *node, struct IfxPushdownOprContext *context
 						Const *const_val = (Const *) oprarg;
 						bool   converted = false;
 						Const *converted_const;
+						Node  *other = NULL;
 
 						/*
 						 * Check wether this constant value has a datatype
-						 * which cannot be safely pushed down.
+						 * which cannot be safely pushed down. INTERVAL
+						 * constants also depend on the other operand.
 						 */
-						if (!isCompatibleForPushdown(const_val->consttype))
+						if (list_length(opr->args) == 2)
+							other = (oprarg == linitial(opr->args))
+								? (Node *) lsecond(opr->args)
+								: (Node *) linitial(opr->args);
+
+						if (!isCompatibleForPushdown(const_val, other))
 						{
 							operand_supported = false;
 							break;
@@ -3096,13 +3167,22 @@ bool ifx_predicate_tree_walker(Node *node, struct IfxPushdownOprContext *context
 							 */
 							ifxCookExpr(info, node, (Node *)r->arg);
 						}
+						else if (ifxIsRuntimeParam(oprarg, info->type))
+							ifxCookExpr(info, node, oprarg);
 						else
 							operand_supported = false;
 
 						break;
 					}
 					default:
-						operand_supported = false;
+						/*
+						 * Params and stable expressions are sent as
+						 * query parameters, see deparse_predicate_node().
+						 */
+						if (ifxIsRuntimeParam(oprarg, info->type))
+							ifxCookExpr(info, node, oprarg);
+						else
+							operand_supported = false;
 						break;
 				}
 
@@ -3147,6 +3227,78 @@ bool ifx_predicate_tree_walker(Node *node, struct IfxPushdownOprContext *context
 	return false;
 }
 
+/*
+ * Returns true if the specified operator argument can be sent to
+ * the Informix server as a query parameter, its value is computed
+ * when the cursor of the foreign scan is opened on the first fetch
+ * or reopened on a rescan. This is the case for Params and
+ * expressions without any column reference and volatile functions,
+ * e.g. now() or current_date.
+ *
+ * Parameters of type DATE, TIMESTAMP and TIMESTAMPTZ might be rounded
+ * when converted to Informix, so they can't be compared with <>.
+ */
+static bool ifxIsRuntimeParam(Node *node, IfxOprType oprtype)
+{
+#if PG_VERSION_NUM >= 90200
+	switch (exprType(node))
+	{
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+#if (PG_VERSION_NUM < 100000) && !defined(HAVE_INT64_TIMESTAMP)
+			/* floating point timestamps are not supported */
+			return false;
+#endif
+		case DATEOID:
+			if (oprtype == IFX_OPR_NEQUAL)
+				return false;
+			break;
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case NUMERICOID:
+		case TEXTOID:
+		case VARCHAROID:
+		case BPCHAROID:
+			break;
+		default:
+			return false;
+	}
+
+	if (IsA(node, Const))
+		return false;
+
+	return !(contain_var_clause(node)
+			 || contain_volatile_functions(node)
+			 || contain_subplans(node));
+#else
+	/* ForeignScan can't evaluate any expressions before 9.2 */
+	return false;
+#endif
+}
+
+/*
+ * Records the specified operator argument as a query parameter
+ * of the pushed down predicates and returns its placeholder.
+ */
+static char *ifxDeparseRuntimeParam(IfxPushdownOprContext *context,
+									Node *node)
+{
+	switch (exprType(node))
+	{
+		case DATEOID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+			context->lossy = true;
+			break;
+		default:
+			break;
+	}
+
+	context->params = lappend(context->params, node);
+	return "?";
+}
+
 /*
  * Deparse the given operator expression into a string assigned
  * to the specified IfxPushdownOprInfo pointer.
@@ -3227,14 +3379,31 @@ deparse_predicate_node(IfxPushdownOprContext *context,
 
 		if (IsA(oprarg_left, Const))
 			left = getConstValue((Const *)oprarg_left);
+		else if (ifxIsRuntimeParam(oprarg_left, info->type))
+			left = ifxDeparseRuntimeParam(context, oprarg_left);
 		else
 			left = deparse_expression(oprarg_left, dpc, false, false);
 
 		if (IsA(oprarg_right, Const))
 			right = getConstValue((Const *) oprarg_right);
+		else if (ifxIsRuntimeParam(oprarg_right, info->type))
+			right = ifxDeparseRuntimeParam(context, oprarg_right);
 		else
 			right = deparse_expression(oprarg_right, dpc, false, false);
 
+		/*
+		 * DATE and DATETIME parameters might be rounded, see
+		 * ifxScanParamFromDatum(). Compare inclusively then, the
+		 * clause is rechecked locally anyways.
+		 */
+		if (context->lossy)
+		{
+			if (info->type == IFX_OPR_LT)
+				oprstr = "<=";
+			else if (info->type == IFX_OPR_GT)
+				oprstr = ">=";
+		}
+
 		appendStringInfo(&predstr, "%s %s %s",
 						 left,
 						 oprstr,
@@ -3272,16 +3441,25 @@ static char * getConstValue(Const *constNode)
 	 */
 	switch (constNode->consttype)
 	{
-		case TEXTOID:
-		case BPCHAROID:
-		case VARCHAROID:
-		case BYTEAOID:
 		case TIMEOID:
-		case TIMETZOID:
 		case TIMESTAMPOID:
 		case DATEOID:
 		case TIMESTAMPTZOID:
 		case INTERVALOID:
+			/*
+			 * Literals independent of GL_DATE, GL_DATETIME
+			 * and DBDATE settings.
+			 */
+			result = ifxDateTimeLiteral(constNode);
+
+			if (result == NULL)
+				elog(ERROR, "could not deparse date/time constant");
+			break;
+		case TEXTOID:
+		case BPCHAROID:
+		case VARCHAROID:
+		case BYTEAOID:
+		case TIMETZOID:
 			result = quote_literal_cstr(DatumGetCString(
 											OidFunctionCall1(typout,
 															 constNode->constvalue)));
@@ -3295,3 +3473,1586 @@ static char * getConstValue(Const *constNode)
 
 	return result;
 }
+
+/*
+ * Appends the fraction of a second of a DATETIME or INTERVAL
+ * literal. Informix keeps five digits, so returns false if the
+ * specified microseconds can't be represented exactly.
+ */
+static bool ifxAppendFraction(StringInfo buf, int64 usecs)
+{
+	if ((usecs % 10) != 0)
+		return false;
+
+	appendStringInfo(buf, ".%05d", (int) (usecs / 10));
+	return true;
+}
+
+/*
+ * Returns an Informix literal for the specified DATE, TIME,
+ * TIMESTAMP, TIMESTAMPTZ or INTERVAL constant, NULL if there is
+ * none. The literals don't depend on any GL_DATE, GL_DATETIME or
+ * DBDATE setting:
+ *
+ * DATE        - MDY(1, 31, 2024)
+ * TIME        - DATETIME(12:30:00) HOUR TO SECOND
+ * TIMESTAMP   - DATETIME(2024-01-31 12:30:00) YEAR TO SECOND
+ * INTERVAL    - INTERVAL(1-06) YEAR(9) TO MONTH or
+ *               INTERVAL(3 12:00:00) DAY(9) TO SECOND
+ *
+ * TIMESTAMPTZ values are converted into the session time zone
+ * first. A fraction of a second gives FRACTION(5) instead of SECOND.
+ * Infinite values, years beyond 9999, TIME 24:00:00 and intervals
+ * mixing months with days or time don't have an Informix literal.
+ */
+static char *ifxDateTimeLiteral(Const *constNode)
+{
+	StringInfoData buf;
+	struct pg_tm   tm;
+	fsec_t         fsec;
+	int            tz;
+
+	Assert(!constNode->constisnull);
+
+#if (PG_VERSION_NUM < 100000) && !defined(HAVE_INT64_TIMESTAMP)
+	/* floating point timestamps are not supported */
+	return NULL;
+#endif
+
+	initStringInfo(&buf);
+
+	switch (constNode->consttype)
+	{
+		case DATEOID:
+		{
+			DateADT date = DatumGetDateADT(constNode->constvalue);
+
+			if (DATE_NOT_FINITE(date))
+				return NULL;
+
+			j2date(date + POSTGRES_EPOCH_JDATE,
+				   &tm.tm_year, &tm.tm_mon, &tm.tm_mday);
+
+			if ((tm.tm_year < 1) || (tm.tm_year > 9999))
+				return NULL;
+
+			appendStringInfo(&buf, "MDY(%d, %d, %d)",
+							 tm.tm_mon, tm.tm_mday, tm.tm_year);
+			break;
+		}
+		case TIMEOID:
+		{
+			TimeADT time = DatumGetTimeADT(constNode->constvalue);
+
+			/* 24:00:00 is beyond HOUR TO SECOND */
+			if (time >= USECS_PER_DAY)
+				return NULL;
+
+			appendStringInfo(&buf, "DATETIME(%02d:%02d:%02d",
+							 (int) (time / USECS_PER_HOUR),
+							 (int) ((time / USECS_PER_MINUTE) % MINS_PER_HOUR),
+							 (int) ((time / USECS_PER_SEC) % SECS_PER_MINUTE));
+
+			if ((time % USECS_PER_SEC) == 0)
+				appendStringInfoString(&buf, ") HOUR TO SECOND");
+			else if (ifxAppendFraction(&buf, time % USECS_PER_SEC))
+				appendStringInfoString(&buf, ") HOUR TO FRACTION(5)");
+			else
+				return NULL;
+
+			break;
+		}
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+		{
+			Timestamp ts = DatumGetTimestamp(constNode->constvalue);
+
+			if (TIMESTAMP_NOT_FINITE(ts))
+				return NULL;
+
+			/*
+			 * Passing tz converts a TIMESTAMPTZ into the
+			 * session time zone.
+			 */
+			if (timestamp2tm(ts,
+							 (constNode->consttype == TIMESTAMPTZOID) ? &tz : NULL,
+							 &tm, &fsec, NULL, NULL) != 0)
+				return NULL;
+
+			if ((tm.tm_year < 1) || (tm.tm_year > 9999))
+				return NULL;
+
+			appendStringInfo(&buf, "DATETIME(%04d-%02d-%02d %02d:%02d:%02d",
+							 tm.tm_year, tm.tm_mon, tm.tm_mday,
+							 tm.tm_hour, tm.tm_min, tm.tm_sec);
+
+			if (fsec == 0)
+				appendStringInfoString(&buf, ") YEAR TO SECOND");
+			else if (ifxAppendFraction(&buf, fsec))
+				appendStringInfoString(&buf, ") YEAR TO FRACTION(5)");
+			else
+				return NULL;
+
+			break;
+		}
+		case INTERVALOID:
+		{
+			Interval *span = DatumGetIntervalP(constNode->constvalue);
+			int64     usecs;
+			int64     days;
+			char     *sign;
+
+			/*
+			 * Informix intervals either count years and months
+			 * or days and time, but not both.
+			 */
+			if (span->month != 0)
+			{
+				if ((span->day != 0) || (span->time != 0))
+					return NULL;
+
+				sign = (span->month < 0) ? "-" : "";
+				appendStringInfo(&buf, "INTERVAL(%s%d-%02d) YEAR(9) TO MONTH",
+								 sign,
+								 Abs(span->month) / MONTHS_PER_YEAR,
+								 Abs(span->month) % MONTHS_PER_YEAR);
+				break;
+			}
+
+			usecs = span->day * USECS_PER_DAY + span->time;
+			sign  = (usecs < 0) ? "-" : "";
+			usecs = Abs(usecs);
+			days  = usecs / USECS_PER_DAY;
+			usecs = usecs % USECS_PER_DAY;
+
+			if (days > 999999999)
+				return NULL;
+
+			appendStringInfo(&buf, "INTERVAL(%s%d %02d:%02d:%02d",
+							 sign, (int) days,
+							 (int) (usecs / USECS_PER_HOUR),
+							 (int) ((usecs / USECS_PER_MINUTE) % MINS_PER_HOUR),
+							 (int) ((usecs / USECS_PER_SEC) % SECS_PER_MINUTE));
+
+			if ((usecs % USECS_PER_SEC) == 0)
+				appendStringInfoString(&buf, ") DAY(9) TO SECOND");
+			else if (ifxAppendFraction(&buf, usecs % USECS_PER_SEC))
+				appendStringInfoString(&buf, ") DAY(9) TO FRACTION(5)");
+			else
+				return NULL;
+
+			break;
+		}
+		default:
+			return NULL;
+	}
+
+	return buf.data;
+}
+
+/*
+ * Classes of INTERVAL values. Informix can't compare a YEAR TO MONTH
+ * interval with a DAY TO FRACTION one.
+ */
+#define IFX_INTERVAL_CLASS_UNKNOWN    0
+#define IFX_INTERVAL_CLASS_YEAR_MONTH 1
+#define IFX_INTERVAL_CLASS_DAY_TIME   2
+
+/*
+ * Returns the class of the specified INTERVAL expression. The
+ * class of a constant follows its literal, see ifxDateTimeLiteral().
+ * Other expressions need a typmod restricting their fields, e.g.
+ * columns declared INTERVAL YEAR TO MONTH, as IMPORT FOREIGN SCHEMA
+ * does according to the Informix qualifier.
+ */
+static int ifxIntervalClass(Node *node)
+{
+	int32 typmod;
+	int   range;
+	int   ym_mask = INTERVAL_MASK(YEAR) | INTERVAL_MASK(MONTH);
+
+	while (IsA(node, RelabelType))
+		node = (Node *) ((RelabelType *) node)->arg;
+
+	if (exprType(node) != INTERVALOID)
+		return IFX_INTERVAL_CLASS_UNKNOWN;
+
+	if (IsA(node, Const))
+	{
+		Const *constNode = (Const *) node;
+
+		if (constNode->constisnull)
+			return IFX_INTERVAL_CLASS_UNKNOWN;
+
+		return (DatumGetIntervalP(constNode->constvalue)->month != 0)
+			? IFX_INTERVAL_CLASS_YEAR_MONTH
+			: IFX_INTERVAL_CLASS_DAY_TIME;
+	}
+
+	if ((typmod = exprTypmod(node)) < 0)
+		return IFX_INTERVAL_CLASS_UNKNOWN;
+
+	range = INTERVAL_RANGE(typmod);
+
+	if (range == INTERVAL_FULL_RANGE)
+		return IFX_INTERVAL_CLASS_UNKNOWN;
+
+	if ((range & ~ym_mask) == 0)
+		return IFX_INTERVAL_CLASS_YEAR_MONTH;
+
+	if ((range & ym_mask) == 0)
+		return IFX_INTERVAL_CLASS_DAY_TIME;
+
+	return IFX_INTERVAL_CLASS_UNKNOWN;
+}
+
+/*
+ * Returns true if the literal of the specified constant can be
+ * compared with the expression other by the Informix server. This
+ * is always the case except for INTERVAL constants, which must have
+ * the class of other.
+ */
+static bool ifxIntervalClassMatches(Const *constNode, Node *other)
+{
+	int constclass;
+
+	if ((constNode->consttype != INTERVALOID) || constNode->constisnull)
+		return true;
+
+	if (other == NULL)
+		return false;
+
+	constclass = ifxIntervalClass((Node *) constNode);
+
+	return (ifxIntervalClass(other) == constclass);
+}
+
+/*
+ * Converts the value of a query parameter pushed down by a foreign
+ * scan into its Informix representation, see ifxIsRuntimeParam() for
+ * the supported types. Returns false if the value can't be sent to
+ * the Informix server.
+ *
+ * DATE and TIMESTAMP values beyond the Informix range are clamped to
+ * the first or last day supported, fractions of a second are truncated
+ * to five digits. TIMESTAMPTZ values are converted into the session
+ * time zone.
+ */
+bool ifxScanParamFromDatum(IfxScanParam *param, Oid typid,
+						   Datum value, bool isnull)
+{
+	param->isnull = isnull ? 1 : 0;
+	param->intval = 0;
+	param->strval = NULL;
+
+	switch (typid)
+	{
+		case INT2OID:
+			param->type = IFX_PARAM_INTEGER;
+
+			if (!isnull)
+				param->intval = DatumGetInt16(value);
+			break;
+		case INT4OID:
+			param->type = IFX_PARAM_INTEGER;
+
+			if (!isnull)
+				param->intval = DatumGetInt32(value);
+			break;
+		case DATEOID:
+		{
+			int jdate;
+
+			param->type = IFX_PARAM_DATE;
+
+			if (isnull)
+				break;
+
+			if (DATE_IS_NOBEGIN(DatumGetDateADT(value)))
+				jdate = date2j(1, 1, 1);
+			else if (DATE_IS_NOEND(DatumGetDateADT(value)))
+				jdate = date2j(9999, 12, 31);
+			else
+			{
+				jdate = DatumGetDateADT(value) + POSTGRES_EPOCH_JDATE;
+				jdate = Max(Min(jdate, date2j(9999, 12, 31)), date2j(1, 1, 1));
+			}
+
+			/* Informix counts the days since 1899-12-31 */
+			param->intval = jdate - date2j(1899, 12, 31);
+			break;
+		}
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+		{
+			Timestamp    ts;
+			struct pg_tm tm;
+			fsec_t       fsec;
+			int          tz;
+
+			param->type = IFX_PARAM_DATETIME;
+
+			if (isnull)
+				break;
+
+#if (PG_VERSION_NUM < 100000) && !defined(HAVE_INT64_TIMESTAMP)
+			/* floating point timestamps are not supported */
+			return false;
+#endif
+
+			ts = DatumGetTimestamp(value);
+
+			if (TIMESTAMP_IS_NOBEGIN(ts))
+				param->strval = "0001-01-01 00:00:00.00000";
+			else if (TIMESTAMP_IS_NOEND(ts))
+				param->strval = "9999-12-31 23:59:59.99999";
+			else if (timestamp2tm(ts,
+								  (typid == TIMESTAMPTZOID) ? &tz : NULL,
+								  &tm, &fsec, NULL, NULL) != 0)
+				return false;
+			else if (tm.tm_year < 1)
+				param->strval = "0001-01-01 00:00:00.00000";
+			else if (tm.tm_year > 9999)
+				param->strval = "9999-12-31 23:59:59.99999";
+			else
+			{
+				StringInfoData buf;
+
+				initStringInfo(&buf);
+				appendStringInfo(&buf, "%04d-%02d-%02d %02d:%02d:%02d.%05d",
+								 tm.tm_year, tm.tm_mon, tm.tm_mday,
+								 tm.tm_hour, tm.tm_min, tm.tm_sec,
+								 (int) (fsec / 10));
+				param->strval = buf.data;
+			}
+
+			break;
+		}
+		case INT8OID:
+		case NUMERICOID:
+		case TEXTOID:
+		case VARCHAROID:
+		case BPCHAROID:
+			param->type = IFX_PARAM_STRING;
+
+			if (isnull)
+				break;
+
+			param->strval = OidOutputFunctionCall(getTypeOutputFunction(typid),
+												  value);
+
+			/* Informix doesn't know about NaN and infinity */
+			if ((typid == NUMERICOID)
+				&& ((strcmp(param->strval, "NaN") == 0)
+					|| (strstr(param->strval, "Infinity") != NULL)))
+				return false;
+
+			break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+/*
+ * Returns the Informix column type of a key set table holding values
+ * of the specified PostgreSQL type, or NULL if the type isn't supported
+ * for key sets. The values are loaded by ifxScanParamFromDatum(), so
+ * only types converted exactly by it are accepted.
+ */
+char *ifxKeySetColumnType(Oid typid)
+{
+	switch (typid)
+	{
+		case INT2OID:
+			return "SMALLINT";
+		case INT4OID:
+			return "INTEGER";
+		case INT8OID:
+			return "INT8";
+		case NUMERICOID:
+			return "DECIMAL(32)";
+		case TEXTOID:
+		case VARCHAROID:
+		case BPCHAROID:
+			return "LVARCHAR(32739)";
+		case DATEOID:
+			return "DATE";
+		default:
+			return NULL;
+	}
+}
+
+/*
+ * Checks wether the specified clause compares a column of the foreign
+ * table with the elements of an array, e.g.
+ *
+ * col IN (1, 2, 3, ...)
+ * col = ANY(ARRAY(SELECT id FROM local_table))
+ *
+ * and the array elements can be loaded into a key set table on the
+ * Informix server, see ifxPlanKeySets(). The array must be a constant
+ * or an expression computed when the cursor is opened, like the
+ * InitPlan of an uncorrelated ARRAY() subquery. The column reference
+ * is returned in colref, the array expression in keys.
+ */
+bool ifxIsKeySetExpr(Node *clause, Index foreign_rtid,
+					 Var **colref, Node **keys)
+{
+	ScalarArrayOpExpr  *scalarOpr;
+	IfxPushdownOprInfo  info;
+	Node               *leftarg;
+	Node               *rightarg;
+
+	if ((clause == NULL)
+		|| !IsA(clause, ScalarArrayOpExpr))
+		return false;
+
+	scalarOpr = (ScalarArrayOpExpr *) clause;
+
+	/* col <> ALL(...) isn't a key set */
+	if (!scalarOpr->useOr
+		|| (list_length(scalarOpr->args) != 2))
+		return false;
+
+	leftarg  = (Node *) linitial(scalarOpr->args);
+	rightarg = (Node *) lsecond(scalarOpr->args);
+
+	if (IsA(leftarg, RelabelType))
+		leftarg = (Node *) ((RelabelType *) leftarg)->arg;
+
+	if (!IsA(leftarg, Var)
+		|| (((Var *) leftarg)->varno != foreign_rtid)
+		|| (((Var *) leftarg)->varlevelsup != 0)
+		|| (((Var *) leftarg)->varattno <= 0))
+		return false;
+
+	memset(&info, 0, sizeof(IfxPushdownOprInfo));
+
+	if (mapPushdownOperator(scalarOpr->opno, &info) != IFX_OPR_EQUAL)
+		return false;
+
+	if (ifxKeySetColumnType(get_element_type(exprType(rightarg))) == NULL)
+		return false;
+
+	if (IsA(rightarg, Const))
+	{
+		if (((Const *) rightarg)->constisnull)
+			return false;
+	}
+	else
+	{
+#if PG_VERSION_NUM >= 90200
+		if (contain_var_clause(rightarg)
+			|| contain_volatile_functions(rightarg)
+			|| contain_subplans(rightarg))
+			return false;
+#else
+		/* ForeignScan can't evaluate any expressions before 9.2 */
+		return false;
+#endif
+	}
+
+	*colref = (Var *) leftarg;
+	*keys   = rightarg;
+
+	return true;
+}
+
+/*
+ * Checks wether the specified join clause compares a column of the
+ * foreign table for equality with an expression of other relations,
+ * e.g. ft.id = dim.id. The column is returned in colref, the other
+ * expression in param. If the foreign scan is parameterized by the
+ * other relations, the expression is sent as a query parameter, see
+ * ifxPlanParameterizedScan().
+ */
+bool ifxIsJoinParamExpr(Node *clause, Index foreign_rtid,
+						Var **colref, Node **param)
+{
+	OpExpr             *opr;
+	IfxPushdownOprInfo  info;
+	Node               *args[2];
+	int                 i;
+
+	if ((clause == NULL)
+		|| !IsA(clause, OpExpr))
+		return false;
+
+	opr = (OpExpr *) clause;
+
+	if (list_length(opr->args) != 2)
+		return false;
+
+	memset(&info, 0, sizeof(IfxPushdownOprInfo));
+
+	if (mapPushdownOperator(opr->opno, &info) != IFX_OPR_EQUAL)
+		return false;
+
+	args[0] = (Node *) linitial(opr->args);
+	args[1] = (Node *) lsecond(opr->args);
+
+	for (i = 0; i < 2; i++)
+	{
+		Node *var   = args[i];
+		Node *other = args[1 - i];
+
+		if (IsA(var, RelabelType))
+			var = (Node *) ((RelabelType *) var)->arg;
+
+		if (!IsA(var, Var)
+			|| (((Var *) var)->varno != foreign_rtid)
+			|| (((Var *) var)->varlevelsup != 0)
+			|| (((Var *) var)->varattno <= 0))
+			continue;
+
+		/*
+		 * The parameter value must be converted exactly, otherwise
+		 * rows would be missed. Those types are the ones supported
+		 * by key sets.
+		 */
+		if ((ifxKeySetColumnType(exprType(other)) == NULL)
+			|| bms_is_member(foreign_rtid, pull_varnos(other))
+			|| contain_volatile_functions(other)
+			|| contain_subplans(other))
+			continue;
+
+		*colref = (Var *) var;
+		*param  = other;
+
+		return true;
+	}
+
+	return false;
+}
+
+/*
+ * Deparses the specified column reference of the
+ * foreign table.
+ */
+char *ifxDeparseColumnRef(Oid foreign_relid, Index foreign_rtid,
+						  Var *colref)
+{
+	Var *var;
+
+	/*
+	 * Adjust varno, like deparse_node_list_for_InExpr() does.
+	 */
+	var = (Var *) copyObject(colref);
+	ChangeVarNodes((Node *) var, foreign_rtid, 1, 0);
+
+	return deparse_expression((Node *) var,
+							  make_deparse_context(foreign_relid),
+							  false, false);
+}
+
+/*
+ * Deparses the clauses accepted by ifxIsKeySetExpr() into semi joins
+ * against the key set tables with the specified names, each column
+ * compared with the keys of the table at the same position.
+ */
+void ifxDeparseKeySetExprs(StringInfo buf, List *columns, List *tablenames)
+{
+	ListCell *col_cell;
+	ListCell *name_cell;
+
+	forboth(col_cell, columns, name_cell, tablenames)
+	{
+		if (col_cell != list_head(columns))
+			appendStringInfoString(buf, " AND ");
+
+		appendStringInfo(buf, "%s IN (SELECT k FROM %s)",
+						 (char *) lfirst(col_cell),
+						 (char *) lfirst(name_cell));
+	}
+}
+
+/*
+ * Parses the comma separated list of extension names passed to the
+ * extensions option into a list of extension OIDs. Extensions not
+ * installed are skipped, the validator emits a WARNING about them
+ * (warnOnMissing).
+ */
+List *ifxExtractExtensionList(char *extensions, bool warnOnMissing)
+{
+	List     *result = NIL;
+	List     *names;
+	ListCell *cell;
+
+	if (extensions == NULL)
+		return NIL;
+
+	if (!SplitIdentifierString(pstrdup(extensions), ',', &names))
+		ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE),
+						errmsg("invalid value for option \"%s\": \"%s\"",
+							   "extensions", extensions),
+						errhint("The value must be a comma separated list of extension names.")));
+
+	foreach(cell, names)
+	{
+		char *extname = (char *) lfirst(cell);
+		Oid   extoid  = get_extension_oid(extname, true);
+
+		if (OidIsValid(extoid))
+			result = lappend_oid(result, extoid);
+		else if (warnOnMissing)
+			ereport(WARNING, (errcode(ERRCODE_UNDEFINED_OBJECT),
+							  errmsg("extension \"%s\" is not installed",
+									 extname)));
+	}
+
+	list_free(names);
+	return result;
+}
+
+#if PG_VERSION_NUM >= 90600
+
+/*******************************************************************************
+ * Remote expression deparsing.
+ *
+ * Unlike ifx_predicate_tree_walker(), which collects pushdown candidates
+ * out of single restriction clauses and silently drops unsupported parts,
+ * the routines below deparse a complete expression tree into Informix SQL
+ * or reject it as a whole. This is what we need for relations which aren't
+ * a plain scan of a foreign table anymore, e.g. grouped relations, where
+ * any expression we can't ship invalidates the whole remote query.
+ */
+
+/*
+ * Returns true in case the specified expression can be evaluated
+ * by the Informix server, false otherwise. Column references must
+ * belong to scanrel.
+ */
+bool ifxIsShippableExpr(PlannerInfo *root, RelOptInfo *scanrel, Node *expr)
+{
+	IfxDeparseContext context;
+	StringInfoData    buf;
+
+	initStringInfo(&buf);
+
+	context.root        = root;
+	context.scanrel     = scanrel;
+	context.buf         = &buf;
+	context.qualify_col = false;
+	context.extensions  = ifxRelShippableExtensions(root, scanrel);
+
+	return ifxDeparseRemoteExpr(expr, &context);
+}
+
+/*
+ * Returns the OIDs of the extensions whose functions can be
+ * shipped in expressions over the specified relation. The
+ * extensions option belongs to the foreign server, so the
+ * list of any foreign table scanned by rel will do.
+ */
+List *ifxRelShippableExtensions(PlannerInfo *root, RelOptInfo *rel)
+{
+	int relid = -1;
+
+	while ((relid = bms_next_member(rel->relids, relid)) >= 0)
+	{
+		RelOptInfo      *baserel   = find_base_rel(root, relid);
+		IfxFdwPlanState *planState = (IfxFdwPlanState *) baserel->fdw_private;
+
+		if (planState != NULL)
+			return planState->extensions;
+	}
+
+	return NIL;
+}
+
+/*
+ * Deparses the specified expression into the output buffer
+ * of the given context. Returns false as soon as an unsupported
+ * node is encountered, the contents of the buffer are undefined
+ * then.
+ */
+bool ifxDeparseRemoteExpr(Node *node, IfxDeparseContext *context)
+{
+	StringInfo buf = context->buf;
+
+	if (node == NULL)
+		return false;
+
+	check_stack_depth();
+
+	switch (nodeTag(node))
+	{
+		case T_Var:
+		{
+			Var *var = (Var *) node;
+
+			/*
+			 * Only plain user columns of the scanned relation,
+			 * no system columns or whole row references.
+			 */
+			if ((var->varlevelsup != 0)
+				|| (var->varattno <= 0)
+				|| !bms_is_member(var->varno, context->scanrel->relids))
+				return false;
+
+			appendStringInfoString(buf,
+								   dispatchColumnIdentifier(var->varno,
+															var->varattno,
+															context->root,
+															context->qualify_col));
+			return true;
+		}
+		case T_Const:
+			return ifxDeparseConst((Const *) node, context);
+		case T_RelabelType:
+			return ifxDeparseRemoteExpr((Node *) ((RelabelType *) node)->arg,
+										context);
+		case T_OpExpr:
+		{
+			OpExpr             *opr = (OpExpr *) node;
+			IfxPushdownOprInfo  info;
+
+			/*
+			 * Comparison operators are shared with the predicate
+			 * walker, everything else is looked up in the catalog
+			 * of shippable objects.
+			 */
+			if ((list_length(opr->args) != 2)
+				|| (mapPushdownOperator(opr->opno, &info) == IFX_OPR_NOT_SUPPORTED))
+			{
+				const IfxShippableObject *object;
+
+				object = ifxLookupShippableObject('o', opr->opno, opr->args);
+
+				if (object == NULL)
+					return false;
+
+				return ifxDeparseShippableObject(object, opr->opresulttype,
+												 opr->args, context);
+			}
+
+			/*
+			 * INTERVAL constants must have the class of the
+			 * compared value.
+			 */
+			if ((IsA(linitial(opr->args), Const)
+				 && !ifxIntervalClassMatches((Const *) linitial(opr->args),
+											 (Node *) lsecond(opr->args)))
+				|| (IsA(lsecond(opr->args), Const)
+					&& !ifxIntervalClassMatches((Const *) lsecond(opr->args),
+												(Node *) linitial(opr->args))))
+				return false;
+
+			appendStringInfoChar(buf, '(');
+
+			if (!ifxDeparseRemoteExpr((Node *) linitial(opr->args), context))
+				return false;
+
+			appendStringInfo(buf, " %s ", getIfxOperatorIdent(&info));
+
+			if (!ifxDeparseRemoteExpr((Node *) lsecond(opr->args), context))
+				return false;
+
+			appendStringInfoChar(buf, ')');
+			return true;
+		}
+		case T_BoolExpr:
+		{
+			BoolExpr *boolexpr = (BoolExpr *) node;
+			ListCell *cell;
+			char     *oprstr;
+			bool      first;
+
+			switch (boolexpr->boolop)
+			{
+				case AND_EXPR:
+					oprstr = " AND ";
+					break;
+				case OR_EXPR:
+					oprstr = " OR ";
+					break;
+				case NOT_EXPR:
+					appendStringInfoString(buf, "(NOT ");
+					if (!ifxDeparseRemoteExpr((Node *) linitial(boolexpr->args),
+											  context))
+						return false;
+					appendStringInfoChar(buf, ')');
+					return true;
+				default:
+					return false;
+			}
+
+			appendStringInfoChar(buf, '(');
+			first = true;
+
+			foreach(cell, boolexpr->args)
+			{
+				if (!first)
+					appendStringInfoString(buf, oprstr);
+				first = false;
+
+				if (!ifxDeparseRemoteExpr((Node *) lfirst(cell), context))
+					return false;
+			}
+
+			appendStringInfoChar(buf, ')');
+			return true;
+		}
+		case T_NullTest:
+		{
+			NullTest *ntest = (NullTest *) node;
+
+			if (ntest->argisrow)
+				return false;
+
+			appendStringInfoChar(buf, '(');
+
+			if (!ifxDeparseRemoteExpr((Node *) ntest->arg, context))
+				return false;
+
+			if (ntest->nulltesttype == IS_NULL)
+				appendStringInfoString(buf, " IS NULL)");
+			else
+				appendStringInfoString(buf, " IS NOT NULL)");
+
+			return true;
+		}
+		case T_Aggref:
+			return ifxDeparseAggref((Aggref *) node, context);
+		case T_FuncExpr:
+			return ifxDeparseFuncExpr((FuncExpr *) node, context);
+		case T_CoalesceExpr:
+		{
+			CoalesceExpr *coalesce = (CoalesceExpr *) node;
+
+			return ifxDeparseCoalesceArgs(coalesce->args, 0, context);
+		}
+		case T_CaseExpr:
+			return ifxDeparseCaseExpr((CaseExpr *) node, context);
+		default:
+			break;
+	}
+
+	/* everything else can't be pushed down */
+	return false;
+}
+
+/*
+ * Deparses a constant value. We accept numeric, character,
+ * boolean and date/time literals only.
+ *
+ * NOTE: We don't use getConstValue() here, since quote_literal_cstr()
+ *       generates an E'' escaped string in case the value contains
+ *       backslashes, which Informix doesn't understand.
+ */
+static bool ifxDeparseConst(Const *constNode, IfxDeparseContext *context)
+{
+	char *value;
+	char *ptr;
+
+	if (constNode->constisnull)
+	{
+		appendStringInfoString(context->buf, "NULL");
+		return true;
+	}
+
+	switch (constNode->consttype)
+	{
+		case INT2OID:
+		case INT4OID:
+		case INT8OID:
+		case FLOAT4OID:
+		case FLOAT8OID:
+		case NUMERICOID:
+			value = DatumGetCString(OidFunctionCall1(getTypeOutputFunction(constNode->consttype),
+													 constNode->constvalue));
+
+			/* NaN and Infinity don't have a literal representation */
+			if ((strcmp(value, "NaN") == 0)
+				|| (strstr(value, "Infinity") != NULL))
+				return false;
+
+			appendStringInfoString(context->buf, value);
+			return true;
+		case BOOLOID:
+			appendStringInfoString(context->buf,
+								   DatumGetBool(constNode->constvalue) ? "'t'" : "'f'");
+			return true;
+		case TEXTOID:
+		case VARCHAROID:
+		case BPCHAROID:
+			value = DatumGetCString(OidFunctionCall1(getTypeOutputFunction(constNode->consttype),
+													 constNode->constvalue));
+			appendStringInfoChar(context->buf, '\'');
+
+			for (ptr = value; *ptr; ptr++)
+			{
+				if (*ptr == '\'')
+					appendStringInfoChar(context->buf, '\'');
+				appendStringInfoChar(context->buf, *ptr);
+			}
+
+			appendStringInfoChar(context->buf, '\'');
+			return true;
+		case DATEOID:
+		case TIMEOID:
+		case TIMESTAMPOID:
+		case TIMESTAMPTZOID:
+		case INTERVALOID:
+			if ((value = ifxDateTimeLiteral(constNode)) == NULL)
+				return false;
+
+			appendStringInfoString(context->buf, value);
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Returns the Informix identifier of the aggregate referenced
+ * by the specified Aggref, NULL in case it's not supported.
+ */
+static char *ifxGetAggregateIdent(Aggref *aggref)
+{
+	char *aggname;
+
+	/* built-in aggregates only */
+	if (get_func_namespace(aggref->aggfnoid) != PG_CATALOG_NAMESPACE)
+		return NULL;
+
+	aggname = get_func_name(aggref->aggfnoid);
+
+	if (aggname == NULL)
+		return NULL;
+
+	if (strcmp(aggname, "count") == 0)
+		return "COUNT";
+	else if (strcmp(aggname, "sum") == 0)
+		return "SUM";
+	else if (strcmp(aggname, "min") == 0)
+		return "MIN";
+	else if (strcmp(aggname, "max") == 0)
+		return "MAX";
+	else if (strcmp(aggname, "avg") == 0)
+		return "AVG";
+
+	return NULL;
+}
+
+/*
+ * Returns the Informix type the result of a remote aggregate
+ * needs to be casted into to match the result type of the local
+ * aggregate, NULL in case no cast is required.
+ *
+ * Informix returns DECIMAL for SUM() over integer columns and
+ * INTEGER for COUNT(), whereas PostgreSQL expects bigint results.
+ * The conversion routines don't cover all of these combinations,
+ * so let the Informix server do the work. NUMERIC results are
+ * mapped to a floating DECIMAL with the maximum precision Informix
+ * supports, a bare DECIMAL would be rounded to 16 digits.
+ */
+static char *ifxAggResultCast(Oid aggtype)
+{
+	switch (aggtype)
+	{
+		case INT8OID:
+			return "INT8";
+		case INT4OID:
+			return "INTEGER";
+		case INT2OID:
+			return "SMALLINT";
+		case FLOAT8OID:
+			return "FLOAT";
+		case FLOAT4OID:
+			return "SMALLFLOAT";
+		case NUMERICOID:
+			/* AVG() and SUM() over INT8, use the maximum precision */
+			return "DECIMAL(32)";
+		default:
+			return NULL;
+	}
+}
+
+/*
+ * Deparses an aggregate function call.
+ *
+ * Partial aggregation is supported for aggregates where
+ * the transition value equals the result of the remote aggregate.
+ * This is the case for aggregates without a final function and a
+ * non-internal transition type, e.g. COUNT(), SUM() over integers,
+ * MIN() and MAX(). The local Finalize Aggregate then combines the
+ * results of the remote aggregates.
+ */
+static bool ifxDeparseAggref(Aggref *aggref, IfxDeparseContext *context)
+{
+	StringInfo  buf = context->buf;
+	char       *aggident;
+	char       *cast;
+	ListCell   *cell;
+	bool        first;
+
+	/* Only plain aggregates without ORDER BY and FILTER */
+	if ((aggref->aggkind != AGGKIND_NORMAL)
+		|| (aggref->aggorder != NIL)
+		|| (aggref->aggfilter != NULL)
+		|| aggref->aggvariadic)
+		return false;
+
+	if ((aggident = ifxGetAggregateIdent(aggref)) == NULL)
+		return false;
+
+	/*
+	 * MIN() and MAX() over collatable types depend on the sort order
+	 * of the input values. We can't tell how the Informix server
+	 * collates them, so push them down with the default or C
+	 * collation only.
+	 */
+	if (OidIsValid(aggref->inputcollid)
+		&& (aggref->inputcollid != DEFAULT_COLLATION_OID)
+		&& (aggref->inputcollid != C_COLLATION_OID)
+		&& ((strcmp(aggident, "MIN") == 0)
+			|| (strcmp(aggident, "MAX") == 0)))
+		return false;
+
+	if (aggref->aggsplit != AGGSPLIT_SIMPLE)
+	{
+		HeapTuple         aggtuple;
+		Form_pg_aggregate aggform;
+		bool              combinable;
+
+		if (aggref->aggsplit != AGGSPLIT_INITIAL_SERIAL)
+			return false;
+
+		aggtuple = SearchSysCache1(AGGFNOID,
+								   ObjectIdGetDatum(aggref->aggfnoid));
+
+		if (!HeapTupleIsValid(aggtuple))
+			elog(ERROR, "cache lookup failed for aggregate %u",
+				 aggref->aggfnoid);
+
+		aggform    = (Form_pg_aggregate) GETSTRUCT(aggtuple);
+		combinable = (!OidIsValid(aggform->aggfinalfn)
+					  && (aggform->aggtranstype != INTERNALOID));
+		ReleaseSysCache(aggtuple);
+
+		if (!combinable)
+			return false;
+	}
+
+	cast = ifxAggResultCast(aggref->aggtype);
+
+	if (cast != NULL)
+		appendStringInfoString(buf, "CAST(");
+
+	appendStringInfo(buf, "%s(", aggident);
+
+	if (aggref->aggstar)
+		appendStringInfoChar(buf, '*');
+	else
+	{
+		if (aggref->aggdistinct != NIL)
+			appendStringInfoString(buf, "DISTINCT ");
+
+		first = true;
+		foreach(cell, aggref->args)
+		{
+			TargetEntry *tle = (TargetEntry *) lfirst(cell);
+
+			if (tle->resjunk)
+				continue;
+
+			if (!first)
+				appendStringInfoString(buf, ", ");
+			first = false;
+
+			if (!ifxDeparseRemoteExpr((Node *) tle->expr, context))
+				return false;
+		}
+	}
+
+	appendStringInfoChar(buf, ')');
+
+	if (cast != NULL)
+		appendStringInfo(buf, " AS %s)", cast);
+
+	return true;
+}
+
+/*
+ * Catalog of built-in operators and functions shipped to the
+ * Informix server, in addition to the comparison operators known
+ * to mapPushdownOperator(). Entries are matched by their name in
+ * pg_catalog and the types of their arguments, so we don't depend
+ * on any OIDs.
+ *
+ * NOTE: Only add operators and functions here whose results match
+ *       those of PostgreSQL exactly. Division is restricted to
+ *       floating point numbers, for example, since DECIMAL division
+ *       rounds differently, and the trim functions to their single
+ *       argument variants, which remove blanks only.
+ *
+ * BETWEEN doesn't need an entry, the parser already expands it
+ * into two comparisons.
+ */
+static const IfxShippableObject ifxShippableObjects[] =
+{
+	{ 'o', "!~~*", { IFX_SHIP_TYPE_TEXT, IFX_SHIP_TYPE_TEXT },
+	  "NOT LIKE", IFX_SHIP_INFIX_UPPER },
+	{ 'o', "~~*", { IFX_SHIP_TYPE_TEXT, IFX_SHIP_TYPE_TEXT },
+	  "LIKE", IFX_SHIP_INFIX_UPPER },
+	{ 'o', "+", { IFX_SHIP_TYPE_NUMERIC, IFX_SHIP_TYPE_NUMERIC },
+	  "+", IFX_SHIP_INFIX },
+	{ 'o', "-", { IFX_SHIP_TYPE_NUMERIC, IFX_SHIP_TYPE_NUMERIC },
+	  "-", IFX_SHIP_INFIX },
+	{ 'o', "-", { IFX_SHIP_TYPE_NUMERIC },
+	  "-", IFX_SHIP_INFIX },
+	{ 'o', "*", { IFX_SHIP_TYPE_NUMERIC, IFX_SHIP_TYPE_NUMERIC },
+	  "*", IFX_SHIP_INFIX },
+	{ 'o', "/", { IFX_SHIP_TYPE_FLOAT, IFX_SHIP_TYPE_FLOAT },
+	  "/", IFX_SHIP_INFIX },
+	{ 'o', "%", { IFX_SHIP_TYPE_INTEGER, IFX_SHIP_TYPE_INTEGER },
+	  "MOD", IFX_SHIP_FUNCTION },
+	{ 'o', "||", { IFX_SHIP_TYPE_TEXT, IFX_SHIP_TYPE_TEXT },
+	  "||", IFX_SHIP_INFIX },
+	{ 'f', "upper", { IFX_SHIP_TYPE_TEXT },
+	  "UPPER", IFX_SHIP_FUNCTION },
+	{ 'f', "lower", { IFX_SHIP_TYPE_TEXT },
+	  "LOWER", IFX_SHIP_FUNCTION },
+	{ 'f', "substr", { IFX_SHIP_TYPE_TEXT, IFX_SHIP_TYPE_POSITIVE_INT },
+	  "SUBSTR", IFX_SHIP_FUNCTION },
+	{ 'f', "substr", { IFX_SHIP_TYPE_TEXT, IFX_SHIP_TYPE_POSITIVE_INT, IFX_SHIP_TYPE_INTEGER },
+	  "SUBSTR", IFX_SHIP_FUNCTION },
+	{ 'f', "substring", { IFX_SHIP_TYPE_TEXT, IFX_SHIP_TYPE_POSITIVE_INT },
+	  "SUBSTR", IFX_SHIP_FUNCTION },
+	{ 'f', "substring", { IFX_SHIP_TYPE_TEXT, IFX_SHIP_TYPE_POSITIVE_INT, IFX_SHIP_TYPE_INTEGER },
+	  "SUBSTR", IFX_SHIP_FUNCTION },
+	/* LENGTH() ignores trailing blanks, which only matches for CHAR */
+	{ 'f', "length", { IFX_SHIP_TYPE_TEXT },
+	  "CHAR_LENGTH", IFX_SHIP_FUNCTION },
+	{ 'f', "length", { IFX_SHIP_TYPE_BPCHAR },
+	  "LENGTH", IFX_SHIP_FUNCTION },
+	{ 'f', "btrim", { IFX_SHIP_TYPE_TEXT },
+	  "TRIM", IFX_SHIP_FUNCTION },
+	{ 'f', "ltrim", { IFX_SHIP_TYPE_TEXT },
+	  "LTRIM", IFX_SHIP_FUNCTION },
+	{ 'f', "rtrim", { IFX_SHIP_TYPE_TEXT },
+	  "RTRIM", IFX_SHIP_FUNCTION },
+	{ 'f', "date_part", { IFX_SHIP_TYPE_FIELD, IFX_SHIP_TYPE_DATETIME },
+	  NULL, IFX_SHIP_DATE_PART },
+	{ 'f', "extract", { IFX_SHIP_TYPE_FIELD, IFX_SHIP_TYPE_DATETIME },
+	  NULL, IFX_SHIP_DATE_PART }
+};
+
+/*
+ * Checks wether the type of the specified operator or function
+ * argument belongs to the given class of types.
+ */
+static bool ifxShippableTypeMatches(Node *arg, IfxShippableTypes types)
+{
+	Oid typid = exprType(arg);
+
+	switch (types)
+	{
+		case IFX_SHIP_TYPE_INTEGER:
+			return ((typid == INT2OID)
+					|| (typid == INT4OID)
+					|| (typid == INT8OID));
+		case IFX_SHIP_TYPE_POSITIVE_INT:
+			return (IsA(arg, Const)
+					&& !((Const *) arg)->constisnull
+					&& (typid == INT4OID)
+					&& (DatumGetInt32(((Const *) arg)->constvalue) > 0));
+		case IFX_SHIP_TYPE_FLOAT:
+			return ((typid == FLOAT4OID)
+					|| (typid == FLOAT8OID));
+		case IFX_SHIP_TYPE_NUMERIC:
+			return (ifxShippableTypeMatches(arg, IFX_SHIP_TYPE_INTEGER)
+					|| ifxShippableTypeMatches(arg, IFX_SHIP_TYPE_FLOAT)
+					|| (typid == NUMERICOID));
+		case IFX_SHIP_TYPE_TEXT:
+			return ((typid == TEXTOID)
+					|| (typid == VARCHAROID));
+		case IFX_SHIP_TYPE_BPCHAR:
+			return (typid == BPCHAROID);
+		case IFX_SHIP_TYPE_DATETIME:
+			/* timestamptz would depend on the time zone of the session */
+			return ((typid == DATEOID)
+					|| (typid == TIMESTAMPOID));
+		case IFX_SHIP_TYPE_FIELD:
+			return (IsA(arg, Const)
+					&& !((Const *) arg)->constisnull
+					&& (typid == TEXTOID));
+		default:
+			/* IFX_SHIP_TYPE_NONE, too many arguments */
+			return false;
+	}
+}
+
+/*
+ * Looks up the catalog entry of the specified operator ('o') or
+ * function ('f') applied to args. Returns NULL in case there's
+ * no Informix equivalent.
+ */
+static const IfxShippableObject *ifxLookupShippableObject(char kind,
+														   Oid objid,
+														   List *args)
+{
+	char *name;
+	Oid   nspoid;
+	int   nargs = list_length(args);
+	int   i;
+
+	if (kind == 'o')
+	{
+		HeapTuple        oprtuple;
+		Form_pg_operator oprForm;
+
+		oprtuple = SearchSysCache1(OPEROID, ObjectIdGetDatum(objid));
+
+		if (!HeapTupleIsValid(oprtuple))
+			elog(ERROR, "cache lookup failed for operator %u", objid);
+
+		oprForm = (Form_pg_operator) GETSTRUCT(oprtuple);
+		name    = pstrdup(NameStr(oprForm->oprname));
+		nspoid  = oprForm->oprnamespace;
+
+		ReleaseSysCache(oprtuple);
+	}
+	else
+	{
+		name   = get_func_name(objid);
+		nspoid = get_func_namespace(objid);
+	}
+
+	if ((name == NULL)
+		|| (nspoid != PG_CATALOG_NAMESPACE)
+		|| (nargs > IFX_SHIP_MAX_ARGS))
+		return NULL;
+
+	for (i = 0; i < (int) lengthof(ifxShippableObjects); i++)
+	{
+		const IfxShippableObject *object = &ifxShippableObjects[i];
+		ListCell                 *cell;
+		int                       argno;
+
+		if ((object->kind != kind)
+			|| (strcmp(object->pgname, name) != 0))
+			continue;
+
+		/* entries with more arguments don't match */
+		if ((nargs < IFX_SHIP_MAX_ARGS)
+			&& (object->argtypes[nargs] != IFX_SHIP_TYPE_NONE))
+			continue;
+
+		argno = 0;
+		foreach(cell, args)
+		{
+			if (!ifxShippableTypeMatches((Node *) lfirst(cell),
+										 object->argtypes[argno]))
+				break;
+			argno++;
+		}
+
+		if (argno == nargs)
+			return object;
+	}
+
+	return NULL;
+}
+
+/*
+ * Deparses an operator or function call according to
+ * the style of its catalog entry.
+ */
+static bool ifxDeparseShippableObject(const IfxShippableObject *object,
+									  Oid resulttype,
+									  List *args,
+									  IfxDeparseContext *context)
+{
+	StringInfo  buf = context->buf;
+	ListCell   *cell;
+
+	switch (object->style)
+	{
+		case IFX_SHIP_INFIX:
+			appendStringInfoChar(buf, '(');
+
+			if (list_length(args) == 1)
+				appendStringInfo(buf, "%s ", object->ifxname);
+			else
+			{
+				if (!ifxDeparseRemoteExpr((Node *) linitial(args), context))
+					return false;
+
+				appendStringInfo(buf, " %s ", object->ifxname);
+			}
+
+			if (!ifxDeparseRemoteExpr((Node *) llast(args), context))
+				return false;
+
+			appendStringInfoChar(buf, ')');
+			return true;
+		case IFX_SHIP_INFIX_UPPER:
+			appendStringInfoString(buf, "(UPPER(");
+
+			if (!ifxDeparseRemoteExpr((Node *) linitial(args), context))
+				return false;
+
+			appendStringInfo(buf, ") %s UPPER(", object->ifxname);
+
+			if (!ifxDeparseRemoteExpr((Node *) lsecond(args), context))
+				return false;
+
+			appendStringInfoString(buf, "))");
+			return true;
+		case IFX_SHIP_FUNCTION:
+			appendStringInfo(buf, "%s(", object->ifxname);
+
+			foreach(cell, args)
+			{
+				if (cell != list_head(args))
+					appendStringInfoString(buf, ", ");
+
+				if (!ifxDeparseRemoteExpr((Node *) lfirst(cell), context))
+					return false;
+			}
+
+			appendStringInfoChar(buf, ')');
+			return true;
+		case IFX_SHIP_DATE_PART:
+		{
+			char *field;
+			char *ident;
+			Node *arg;
+
+			field = TextDatumGetCString(((Const *) linitial(args))->constvalue);
+
+			if (pg_strcasecmp(field, "year") == 0)
+				ident = "YEAR";
+			else if (pg_strcasecmp(field, "month") == 0)
+				ident = "MONTH";
+			else if (pg_strcasecmp(field, "day") == 0)
+				ident = "DAY";
+			else if (pg_strcasecmp(field, "dow") == 0)
+				ident = "WEEKDAY";
+			else
+				return false;
+
+			/*
+			 * The Informix functions accept DATE values directly,
+			 * strip an implicit cast to timestamp.
+			 */
+			arg = (Node *) lsecond(args);
+
+			if (IsA(arg, FuncExpr)
+				&& (((FuncExpr *) arg)->funcformat == COERCE_IMPLICIT_CAST)
+				&& (list_length(((FuncExpr *) arg)->args) == 1)
+				&& (exprType((Node *) linitial(((FuncExpr *) arg)->args)) == DATEOID))
+				arg = (Node *) linitial(((FuncExpr *) arg)->args);
+
+			/*
+			 * Informix returns SMALLINT values, whereas date_part()
+			 * returns double precision and extract() numeric.
+			 */
+			appendStringInfo(buf, "CAST(%s(", ident);
+
+			if (!ifxDeparseRemoteExpr(arg, context))
+				return false;
+
+			appendStringInfo(buf, ") AS %s)",
+							 (resulttype == FLOAT8OID) ? "FLOAT" : "DECIMAL(32,0)");
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+/*
+ * Returns the Informix DECIMAL type an implicit cast into NUMERIC
+ * is shipped as, NULL if the cast can't be shipped.
+ *
+ * A bare DECIMAL is a floating point decimal with 16 significant
+ * digits in Informix. Implicit casts don't carry a typmod, so ship
+ * them for integer source types only, which map to a fixed precision
+ * without any fractional digits.
+ */
+static char *ifxNumericCast(Oid sourcetype)
+{
+	switch (sourcetype)
+	{
+		case INT2OID:
+			return "DECIMAL(5,0)";
+		case INT4OID:
+			return "DECIMAL(10,0)";
+		case INT8OID:
+			return "DECIMAL(19,0)";
+		default:
+			return NULL;
+	}
+}
+
+/*
+ * Deparses a function call. Besides the functions known to
+ * ifxShippableObjects, we ship implicit casts between numeric
+ * types and functions belonging to an extension listed in the
+ * extensions option of the foreign server. The latter are called
+ * by their name, so the Informix database needs an equally named
+ * routine.
+ */
+static bool ifxDeparseFuncExpr(FuncExpr *func, IfxDeparseContext *context)
+{
+	const IfxShippableObject *object;
+
+	if (func->funcretset || func->funcvariadic)
+		return false;
+
+	/*
+	 * Ship implicit numeric casts as explicit CAST()s, so that
+	 * e.g. a division of integers casted to double precision
+	 * isn't evaluated as an integer division by Informix.
+	 */
+	if (func->funcformat == COERCE_IMPLICIT_CAST)
+	{
+		char *cast;
+
+		if ((list_length(func->args) != 1)
+			|| !ifxShippableTypeMatches((Node *) linitial(func->args),
+										IFX_SHIP_TYPE_NUMERIC))
+			return false;
+
+		if (func->funcresulttype == NUMERICOID)
+			cast = ifxNumericCast(exprType((Node *) linitial(func->args)));
+		else
+			cast = ifxAggResultCast(func->funcresulttype);
+
+		if (cast == NULL)
+			return false;
+
+		appendStringInfoString(context->buf, "CAST(");
+
+		if (!ifxDeparseRemoteExpr((Node *) linitial(func->args), context))
+			return false;
+
+		appendStringInfo(context->buf, " AS %s)", cast);
+		return true;
+	}
+
+	object = ifxLookupShippableObject('f', func->funcid, func->args);
+
+	if (object != NULL)
+		return ifxDeparseShippableObject(object, func->funcresulttype,
+										 func->args, context);
+
+	if ((context->extensions != NIL)
+		&& list_member_oid(context->extensions,
+						   getExtensionOfObject(ProcedureRelationId,
+												func->funcid)))
+	{
+		IfxShippableObject extfunc;
+
+		memset(&extfunc, 0, sizeof(IfxShippableObject));
+		extfunc.kind    = 'f';
+		extfunc.ifxname = get_func_name(func->funcid);
+		extfunc.style   = IFX_SHIP_FUNCTION;
+
+		return ifxDeparseShippableObject(&extfunc, func->funcresulttype,
+										 func->args, context);
+	}
+
+	return false;
+}
+
+/*
+ * Deparses the arguments of a COALESCE expression starting
+ * at argno into nested NVL() calls.
+ */
+static bool ifxDeparseCoalesceArgs(List *args, int argno,
+								   IfxDeparseContext *context)
+{
+	if (argno == list_length(args) - 1)
+		return ifxDeparseRemoteExpr((Node *) list_nth(args, argno), context);
+
+	appendStringInfoString(context->buf, "NVL(");
+
+	if (!ifxDeparseRemoteExpr((Node *) list_nth(args, argno), context))
+		return false;
+
+	appendStringInfoString(context->buf, ", ");
+
+	if (!ifxDeparseCoalesceArgs(args, argno + 1, context))
+		return false;
+
+	appendStringInfoChar(context->buf, ')');
+	return true;
+}
+
+/*
+ * Deparses a CASE expression. The conditions of a simple
+ * CASE compare a placeholder for the tested value with the
+ * WHEN value, we deparse the latter only.
+ */
+static bool ifxDeparseCaseExpr(CaseExpr *caseexpr, IfxDeparseContext *context)
+{
+	StringInfo  buf = context->buf;
+	ListCell   *cell;
+
+	appendStringInfoString(buf, "(CASE");
+
+	if (caseexpr->arg != NULL)
+	{
+		appendStringInfoChar(buf, ' ');
+
+		if (!ifxDeparseRemoteExpr((Node *) caseexpr->arg, context))
+			return false;
+	}
+
+	foreach(cell, caseexpr->args)
+	{
+		CaseWhen *when = (CaseWhen *) lfirst(cell);
+		Node     *cond = (Node *) when->expr;
+
+		appendStringInfoString(buf, " WHEN ");
+
+		if (caseexpr->arg != NULL)
+		{
+			OpExpr             *opr = (OpExpr *) cond;
+			IfxPushdownOprInfo  info;
+			Node               *placeholder;
+
+			if (!IsA(cond, OpExpr)
+				|| (list_length(opr->args) != 2)
+				|| (mapPushdownOperator(opr->opno, &info) != IFX_OPR_EQUAL))
+				return false;
+
+			placeholder = (Node *) linitial(opr->args);
+
+			if (IsA(placeholder, RelabelType))
+				placeholder = (Node *) ((RelabelType *) placeholder)->arg;
+
+			if (!IsA(placeholder, CaseTestExpr))
+				return false;
+
+			cond = (Node *) lsecond(opr->args);
+		}
+
+		if (!ifxDeparseRemoteExpr(cond, context))
+			return false;
+
+		appendStringInfoString(buf, " THEN ");
+
+		if (!ifxDeparseRemoteExpr((Node *) when->result, context))
+			return false;
+	}
+
+	if (caseexpr->defresult != NULL)
+	{
+		appendStringInfoString(buf, " ELSE ");
+
+		if (!ifxDeparseRemoteExpr((Node *) caseexpr->defresult, context))
+			return false;
+	}
+
+	appendStringInfoString(buf, " END)");
+	return true;
+}
+
+#endif
@@ -22,8 +22,28 @@
 #include "parser/parsetree.h"
 #endif
 
+#if PG_VERSION_NUM >= 90600
+#include "access/stratnum.h"
+#include "optimizer/paths.h"
+#include "optimizer/tlist.h"
+#include "optimizer/var.h"
+#include "utils/selfuncs.h"
+#endif
+
 #include "access/xact.h"
+#include "catalog/pg_statistic.h"
+#include "nodes/nodeFuncs.h"
+#include "optimizer/clauses.h"
+#include "storage/proc.h"
+#include "utils/acl.h"
+#include "utils/datum.h"
+#include "utils/inval.h"
 #include "utils/lsyscache.h"
+#include "utils/syscache.h"
+#include "utils/typcache.h"
+
+#include <limits.h>
+#include <math.h>
 
 PG_MODULE_MAGIC;
 
@@ -49,6 +69,13 @@ static struct IfxFdwOption ifx_valid_options[] =
 	{ "informixserver",   ForeignServerRelationId },
 	{ "informixdir",      ForeignServerRelationId },
 	{ "delimident",       ForeignServerRelationId },
+	{ "statement_cache_size", ForeignServerRelationId },
+	{ "use_remote_estimate", ForeignServerRelationId },
+	{ "fdw_startup_cost", ForeignServerRelationId },
+	{ "fdw_tuple_cost",   ForeignServerRelationId },
+	{ "remote_cost_factor", ForeignServerRelationId },
+	{ "extensions",       ForeignServerRelationId },
+	{ "join_filter_rows", ForeignServerRelationId },
 	{ "username",         UserMappingRelationId },
 	{ "password",         UserMappingRelationId },
 	{ "database",         ForeignTableRelationId },
@@ -62,6 +89,17 @@ static struct IfxFdwOption ifx_valid_options[] =
 	{ "disable_predicate_pushdown", ForeignTableRelationId },
 	{ "disable_rowid",              ForeignTableRelationId },
 	{ "enable_blobs",               ForeignTableRelationId },
+	{ "estimate_cache_ttl",         ForeignTableRelationId },
+	{ "use_remote_estimate",        ForeignTableRelationId },
+	{ "fdw_startup_cost",           ForeignTableRelationId },
+	{ "fdw_tuple_cost",             ForeignTableRelationId },
+	{ "remote_cost_factor",         ForeignTableRelationId },
+	{ "batch_size",                 ForeignTableRelationId },
+	{ "insert_buffer_size",         ForeignTableRelationId },
+	{ "analyze_sampling",           ForeignTableRelationId },
+	{ "import_statistics",          ForeignTableRelationId },
+	{ "join_filter_rows",           ForeignTableRelationId },
+	{ "optimizer_directives",       ForeignTableRelationId },
 	{ NULL,                         ForeignTableRelationId }
 };
 
@@ -85,6 +123,7 @@ PG_FUNCTION_INFO_V1(ifx_fdw_handler);
 PG_FUNCTION_INFO_V1(ifx_fdw_validator);
 PG_FUNCTION_INFO_V1(ifxGetConnections);
 PG_FUNCTION_INFO_V1(ifxCloseConnection);
+PG_FUNCTION_INFO_V1(ifxTruncateTable);
 
 /*******************************************************************************
  * FDW internal macros
@@ -154,9 +193,60 @@ PG_FUNCTION_INFO_V1(ifxCloseConnection);
 #define TUPDESC_GET_ATTR(desc, index) \
 	TupleDescAttr((desc), (index))
 
+/*
+ * Local transaction id of the current transaction, used
+ * to track cursors of cached statements opened by it.
+ */
+#define IFX_CURRENT_LXID (MyProc->lxid)
+
+/*
+ * PostgreSQL 11 introduced RELOPT_OTHER_UPPER_REL and RELOPT_OTHER_JOINREL
+ * for partitionwise aggregation and joins. IS_UPPER_REL() and IS_JOIN_REL()
+ * cover both kinds of relations.
+ */
+#if PG_VERSION_NUM >= 110000
+#define IFX_IS_UPPER_REL(rel) IS_UPPER_REL(rel)
+#elif PG_VERSION_NUM >= 90600
+#define IFX_IS_UPPER_REL(rel) ((rel)->reloptkind == RELOPT_UPPER_REL)
+#endif
+
+#if PG_VERSION_NUM >= 110000
+#define IFX_IS_JOIN_REL(rel) IS_JOIN_REL(rel)
+#elif PG_VERSION_NUM >= 90600
+#define IFX_IS_JOIN_REL(rel) ((rel)->reloptkind == RELOPT_JOINREL)
+#endif
+
+/*
+ * RINFO_IS_PUSHED_DOWN() replaced the is_pushed_down flag
+ * of RestrictInfo with PostgreSQL 11.
+ */
+#if PG_VERSION_NUM >= 110000
+#define IFX_RINFO_IS_PUSHED_DOWN(rinfo, relids) RINFO_IS_PUSHED_DOWN((rinfo), (relids))
+#else
+#define IFX_RINFO_IS_PUSHED_DOWN(rinfo, relids) ((rinfo)->is_pushed_down)
+#endif
+
 /*******************************************************************************
  * FDW helper functions.
  */
+static void ifxSetupLocalFdwScan(IfxConnectionInfo     *coninfo,
+								 IfxFdwExecutionState **state,
+								 List                 **plan_values);
+static void ifxEstimateLocalRelSize(PlannerInfo       *root,
+									RelOptInfo        *baserel,
+									IfxConnectionInfo *coninfo);
+static void ifxCalculateScanCosts(IfxConnectionInfo *coninfo,
+								  bool informix_costs);
+static void ifxApplyRowFeedback(Oid                   foreignTableOid,
+								IfxConnectionInfo    *coninfo,
+								IfxFdwExecutionState *state);
+static void ifxRecordRowFeedback(Oid                   foreignTableOid,
+								 IfxFdwExecutionState *state);
+static int *ifxDescribeColumnWidths(Oid               foreignTableOid,
+									IfxStatementInfo *info,
+									int              *natts);
+static void ifxSetRemoteRelWidth(RelOptInfo *baserel,
+								 int        *widths);
 static void ifxSetupFdwScan(IfxConnectionInfo    **coninfo,
 							IfxFdwExecutionState **state,
 							List    **plan_values,
@@ -196,6 +286,9 @@ ifxGenDescrName(int descr_id);
 static void
 ifxGetOptionDups(IfxConnectionInfo *coninfo, DefElem *def);
 
+static int ifxGetIntOption(DefElem *def, int minvalue);
+static double ifxGetFloatOption(DefElem *def);
+
 static void ifxConnInfoSetDefaults(IfxConnectionInfo *coninfo);
 
 static IfxConnectionInfo *ifxMakeConnectionInfo(Oid foreignTableOid);
@@ -204,9 +297,67 @@ static void ifxStatementInfoInit(IfxStatementInfo *info,
 								 int refid);
 
 static char *ifxGenCursorName(int curid);
+static char *ifxGenKeySetName(Oid elemtype, Index rtindex, int n);
+static List *ifxGenScanKeySetNames(List *names, int refid);
 
 static void ifxPgColumnData(Oid foreignTableOid, IfxFdwExecutionState *festate);
 
+static Oid ifxGetForeignScanTableOid(ForeignScanState *node);
+
+#if PG_VERSION_NUM >= 90600
+
+static void ifxPgColumnDataFromTupleDesc(TupleDesc tupdesc,
+										 IfxFdwExecutionState *festate);
+
+static bool ifxForeignGroupingOk(PlannerInfo     *root,
+								 PathTarget      *grouping_target,
+								 Node            *havingQual,
+								 IfxFdwPlanState *planState);
+
+static bool ifxForeignJoinOk(PlannerInfo       *root,
+							 RelOptInfo        *joinrel,
+							 JoinType           jointype,
+							 RelOptInfo        *outerrel,
+							 RelOptInfo        *innerrel,
+							 JoinPathExtraData *extra,
+							 IfxFdwPlanState   *planState);
+
+static bool ifxGetJoinInputConds(PlannerInfo     *root,
+								 RelOptInfo      *rel,
+								 IfxFdwPlanState *planState,
+								 List           **remote_conds);
+
+static void ifxDisposeBaseRelCursors(PlannerInfo *root, Relids relids);
+
+static void ifxGetRemoteIndexes(Oid                foreignTableOid,
+								IfxConnectionInfo *coninfo,
+								IfxFdwPlanState   *planState,
+								bool               connected);
+
+static void ifxAddSortedPath(PlannerInfo     *root,
+							 RelOptInfo      *baserel,
+							 IfxFdwPlanState *planState);
+
+static void ifxPlanSortedScan(PlannerInfo     *root,
+							  RelOptInfo      *baserel,
+							  IfxFdwPlanState *planState,
+							  List            *pathkeys);
+
+static void ifxRenewScanStatement(IfxFdwPlanState *planState);
+
+static List *ifxGetJoinParamClauses(PlannerInfo *root,
+									RelOptInfo  *baserel);
+
+static void ifxAddParameterizedPaths(PlannerInfo     *root,
+									 RelOptInfo      *baserel,
+									 IfxFdwPlanState *planState);
+
+static List *ifxPlanParameterizedScan(RelOptInfo      *baserel,
+									  IfxFdwPlanState *planState,
+									  ParamPathInfo   *param_info);
+
+#endif
+
 static IfxSqlStateClass
 ifxCatchExceptions(IfxStatementInfo *state, unsigned short stackentry);
 
@@ -221,15 +372,61 @@ static void ifxColumnValueByAttNum(IfxFdwExecutionState *state, int attnum,
 
 static void ifxPrepareCursorForScan(IfxStatementInfo *info,
 									IfxConnectionInfo *coninfo);
+static void ifxPrepareCachedCursorForScan(IfxStatementInfo *info,
+										  IfxConnectionInfo *coninfo);
+static IfxCachedConnection *ifxGetStmtCache(char *conname);
+static void ifxCloseLeftoverCursor(IfxStatementInfo *info);
+static void ifxEvictCachedStatement(IfxCachedConnection *cached,
+									IfxCachedStatement *stmt);
+static bool ifxAcquireCachedStatement(IfxStatementInfo *info,
+									  IfxConnectionInfo *coninfo);
+static void ifxSaveCachedDescriptor(IfxStatementInfo *info);
+static void ifxReleaseCachedStatement(IfxStatementInfo *info);
+static void ifxUncacheStatement(IfxStatementInfo *info);
+
+static bool ifxDeparseQualClause(Node *clause,
+								 Oid foreignTableOid,
+								 Index foreign_rtid,
+								 StringInfo buf,
+								 List **params,
+								 bool *lossy);
 
 static char *ifxFilterQuals(PlannerInfo *planInfo,
 							RelOptInfo *baserel,
 							List **excl_restrictInfo,
+							List **param_exprs,
+							List *extensions,
+							List *keysets,
 							Oid foreignTableOid);
 
 static void ifxPrepareParamsForScan(IfxFdwExecutionState *state,
 									IfxConnectionInfo *coninfo);
 
+static bool ifxWantsFirstRows(PlannerInfo *root);
+static char *ifxOptimizerDirectives(IfxConnectionInfo *coninfo,
+									bool first_rows);
+
+#if PG_VERSION_NUM >= 90200
+static void ifxInitScanParams(ForeignScanState *node,
+							  IfxFdwExecutionState *state);
+static void ifxOpenCursorForScanParams(ForeignScanState *node,
+									   IfxFdwExecutionState *state);
+static void ifxPlanKeySets(PlannerInfo       *root,
+						   RelOptInfo        *baserel,
+						   IfxConnectionInfo *coninfo,
+						   IfxFdwPlanState   *planState);
+static void ifxCreateKeySetTables(IfxStatementInfo *info,
+								  List *names,
+								  List *keys);
+static void ifxLoadKeySets(ForeignScanState *node,
+						   IfxFdwExecutionState *state);
+static void ifxDisposeKeySetTables(IfxFdwExecutionState *state);
+static void ifxDropKeySetTable(char *tablename);
+static void ifxDropAbortedKeySets(IfxCachedConnection *cached,
+								  SubTransactionId subid);
+static void ifxCleanupKeySets(SubTransactionId subid);
+#endif
+
 static IfxSqlStateClass
 ifxFetchTuple(IfxFdwExecutionState *state);
 
@@ -244,15 +441,25 @@ static HeapTuple ifxFdwMakeTuple(IfxFdwExecutionState *state,
 
 static ItemPointer ifxGetRowIdForTuple(IfxFdwExecutionState *state);
 
-__attribute__((unused)) static bool ifxCheckForAfterRowTriggers(Oid foreignTableOid,
-															   IfxFdwExecutionState *state,
-															   CmdType cmd);
+static bool ifxCheckForAfterRowTriggers(Oid foreignTableOid,
+									   IfxFdwExecutionState *state,
+									   CmdType cmd);
 
 #if PG_VERSION_NUM >= 90300
 
 static void ifxRowIdValueToSqlda(IfxFdwExecutionState *state,
 								 int                   paramId,
 								 TupleTableSlot       *planSlot);
+static int ifxGetRowIdFromSlot(IfxFdwExecutionState *state,
+							   TupleTableSlot       *planSlot);
+static void ifxSetRowIdParam(IfxFdwExecutionState *state,
+							 int                   paramId,
+							 int                   rowid);
+static void ifxFlushRowIdBatch(IfxFdwExecutionState *state);
+static bool ifxBatchValuesEqual(IfxFdwExecutionState *state,
+								TupleTableSlot       *slot);
+static void ifxSaveBatchValues(IfxFdwExecutionState *state,
+							   TupleTableSlot       *slot);
 
 static void ifxPrepareModifyQuery(IfxStatementInfo  *info,
 								  IfxConnectionInfo *coninfo,
@@ -305,6 +512,15 @@ static void ifx_fdw_subxact_callback(SubXactEvent event,
 static void ifx_fdw_xact_callback_internal(IfxCachedConnection *cached,
 										   XactEvent event);
 
+static void ifx_fdw_relcache_callback(Datum arg, Oid relid);
+#if PG_VERSION_NUM >= 90200
+static void ifx_fdw_syscache_callback(Datum arg, int cacheid,
+									  uint32 hashvalue);
+#else
+static void ifx_fdw_syscache_callback(Datum arg, int cacheid,
+									  ItemPointer tuplePtr);
+#endif
+
 static int ifxXactFinalize(IfxCachedConnection *cached,
 						   IfxXactAction action,
 						   bool connection_error_ok);
@@ -384,6 +600,27 @@ ifxExecForeignUpdate(EState *estate,
 					 TupleTableSlot *slot,
 					 TupleTableSlot *planSlot);
 
+static void ifxTupleToInsertSqlda(IfxFdwExecutionState *state,
+								  TupleTableSlot *slot);
+static void ifxExecInsertReturning(IfxFdwExecutionState *state,
+								   TupleTableSlot *slot);
+static void ifxPutTupleInInsertCursor(IfxFdwExecutionState *state,
+									  TupleTableSlot *slot);
+static void ifxSetupModifyDescriptor(IfxFdwExecutionState *state,
+									 IfxConnectionInfo    *coninfo,
+									 CmdType               operation,
+									 Oid                   foreignTableOid);
+static void ifxPrepareParamsForInsert(IfxFdwExecutionState *state,
+									  TupleDesc             tupdesc);
+static void ifxFlushInsertCursor(IfxFdwExecutionState *state);
+
+#endif
+
+#if PG_VERSION_NUM >= 110000
+
+static void ifxBeginForeignInsert(ModifyTableState *mtstate,
+								  ResultRelInfo *rinfo);
+
 #endif
 
 #if PG_VERSION_NUM >= 90200
@@ -405,10 +642,67 @@ static ForeignScan *ifxGetForeignPlan(PlannerInfo *root,
 #endif
 	);
 
+#if PG_VERSION_NUM >= 90600
+
+static void ifxGetForeignUpperPaths(PlannerInfo *root,
+									UpperRelationKind stage,
+									RelOptInfo *input_rel,
+									RelOptInfo *output_rel
+#if PG_VERSION_NUM >= 110000
+									, void *extra
+#endif
+	);
+
+static void ifxGetForeignJoinPaths(PlannerInfo *root,
+								   RelOptInfo *joinrel,
+								   RelOptInfo *outerrel,
+								   RelOptInfo *innerrel,
+								   JoinType jointype,
+								   JoinPathExtraData *extra);
+
+#endif
+
+#if PG_VERSION_NUM >= 90600
+
+static bool ifxPlanDirectModify(PlannerInfo *root,
+								ModifyTable *plan,
+								Index resultRelation,
+								int subplan_index);
+
+static bool ifxPlanDirectInsert(PlannerInfo *root,
+								ModifyTable *plan,
+								Index resultRelation,
+								int subplan_index);
+
+static void ifxBeginDirectModify(ForeignScanState *node, int eflags);
+
+static TupleTableSlot *ifxIterateDirectModify(ForeignScanState *node);
+
+static void ifxEndDirectModify(ForeignScanState *node);
+
+#endif
+
 static int
 ifxAcquireSampleRows(Relation relation, int elevel, HeapTuple *rows,
 					 int targrows, double *totalrows, double *totaldeadrows);
 
+static int ifxAnalyzeSampleModulo(IfxConnectionInfo    *coninfo,
+								  IfxFdwExecutionState *state,
+								  int                   targrows,
+								  double               *remote_rows);
+
+static int
+ifxImportColumnStats(Relation relation, int elevel, HeapTuple *rows,
+					 int targrows, double *totalrows, double *totaldeadrows);
+
+static void ifxStoreColumnStats(Relation          relation,
+								Form_pg_attribute attr,
+								bool              notnull,
+								float4            stadistinct,
+								Datum            *bounds,
+								int               nbounds,
+								Oid               ltopr);
+
 static bool
 ifxAnalyzeForeignTable(Relation relation, AcquireSampleRowsFunc *func,
 					   BlockNumber *totalpages);
@@ -434,7 +728,9 @@ static void ifxReScanForeignScan(ForeignScanState *state);
 static void ifxEndForeignScan(ForeignScanState *node);
 
 static void ifxPrepareScan(IfxConnectionInfo *coninfo,
-						   IfxFdwExecutionState *state);
+						   IfxFdwExecutionState *state,
+						   Oid foreignTableOid,
+						   int **widths);
 
 /*******************************************************************************
  * SQL status and helper functions.
@@ -444,6 +740,10 @@ Datum
 ifxGetConnections(PG_FUNCTION_ARGS);
 Datum
 ifxCloseConnection(PG_FUNCTION_ARGS);
+Datum
+ifxTruncateTable(PG_FUNCTION_ARGS);
+
+static void ifxTruncateForeignTable(Relation rel);
 
 /*******************************************************************************
  * Implementation starts here
@@ -848,7 +1148,16 @@ static void ifxRowIdValueToSqlda(IfxFdwExecutionState *state,
 								 int                   paramId,
 								 TupleTableSlot       *planSlot)
 {
-	int   rowid;
+	ifxSetRowIdParam(state, paramId, ifxGetRowIdFromSlot(state, planSlot));
+}
+
+/*
+ * Extracts the ROWID of the current tuple from
+ * the resjunk column of the specified slot.
+ */
+static int ifxGetRowIdFromSlot(IfxFdwExecutionState *state,
+							   TupleTableSlot       *planSlot)
+{
 	ItemPointer iptr;
 	bool  isnull;
 
@@ -871,8 +1180,17 @@ static void ifxRowIdValueToSqlda(IfxFdwExecutionState *state,
 	 * since it will fail the Assertion for a given OffsetNumber
 	 * otherwise.
 	 */
-	rowid = (int) ((iptr->ip_blkid.bi_hi << 16) | ((uint16) iptr->ip_blkid.bi_lo));
+	return (int) ((iptr->ip_blkid.bi_hi << 16) | ((uint16) iptr->ip_blkid.bi_lo));
+}
 
+/*
+ * Assigns the specified ROWID to the parameter paramId
+ * of the SQLDA structure.
+ */
+static void ifxSetRowIdParam(IfxFdwExecutionState *state,
+							 int                   paramId,
+							 int                   rowid)
+{
 	/*
 	 * Mark the value valid, otherwise the conversion routine
 	 * will give up immediately...
@@ -885,6 +1203,110 @@ static void ifxRowIdValueToSqlda(IfxFdwExecutionState *state,
 	ifxSetInteger(&(state->stmt_info), paramId, rowid);
 }
 
+/*
+ * Executes a batched UPDATE or DELETE for all ROWIDs
+ * collected so far.
+ *
+ * The statement was prepared with batch_size ROWID parameters
+ * trailing all others. If the batch isn't full, the remaining
+ * parameters repeat the last ROWID, which doesn't change the
+ * result of the IN list. This way we get along with a single
+ * prepared statement.
+ */
+static void ifxFlushRowIdBatch(IfxFdwExecutionState *state)
+{
+	int first_param;
+	int i;
+
+	if (state->rows_buffered == 0)
+		return;
+
+	elog(DEBUG2, "informix_fdw: flush %d rowids with statement \"%s\"",
+		 state->rows_buffered, state->stmt_info.stmt_name);
+
+	first_param = state->stmt_info.ifxAttrCount - state->batch_size;
+
+	for (i = 0; i < state->batch_size; i++)
+	{
+		ifxSetRowIdParam(state, first_param + i,
+						 state->batch_rowids[Min(i, state->rows_buffered - 1)]);
+	}
+
+	ifxExecuteStmtSqlda(&state->stmt_info);
+	ifxCatchExceptions(&state->stmt_info, 0);
+
+	state->rows_buffered = 0;
+}
+
+/*
+ * Checks wether the new column values of the specified slot are
+ * the same as assigned by the current UPDATE batch.
+ */
+static bool ifxBatchValuesEqual(IfxFdwExecutionState *state,
+								TupleTableSlot       *slot)
+{
+	TupleDesc  tupdesc = slot->tts_tupleDescriptor;
+	ListCell  *cell;
+	int        i;
+
+	i = 0;
+	foreach(cell, state->affectedAttrNums)
+	{
+		int               attnum = lfirst_int(cell);
+		Form_pg_attribute attr   = TUPDESC_GET_ATTR(tupdesc, attnum - 1);
+		Datum             value;
+		bool              isnull;
+
+		value = slot_getattr(slot, attnum, &isnull);
+
+		if (isnull != state->batch_nulls[i])
+			return false;
+
+		if (!isnull
+			&& !datumIsEqual(value, state->batch_values[i],
+							 attr->attbyval, attr->attlen))
+			return false;
+
+		i++;
+	}
+
+	return true;
+}
+
+/*
+ * Remembers the new column values of the specified slot
+ * for comparison by ifxBatchValuesEqual().
+ */
+static void ifxSaveBatchValues(IfxFdwExecutionState *state,
+							   TupleTableSlot       *slot)
+{
+	TupleDesc  tupdesc = slot->tts_tupleDescriptor;
+	ListCell  *cell;
+	int        i;
+
+	i = 0;
+	foreach(cell, state->affectedAttrNums)
+	{
+		int               attnum = lfirst_int(cell);
+		Form_pg_attribute attr   = TUPDESC_GET_ATTR(tupdesc, attnum - 1);
+		Datum             value;
+		bool              isnull;
+
+		/* release values of the former batch */
+		if (!attr->attbyval && !state->batch_nulls[i]
+			&& (DatumGetPointer(state->batch_values[i]) != NULL))
+			pfree(DatumGetPointer(state->batch_values[i]));
+
+		value = slot_getattr(slot, attnum, &isnull);
+
+		state->batch_nulls[i]  = isnull;
+		state->batch_values[i] = (isnull) ? (Datum) 0
+			: datumCopy(value, attr->attbyval, attr->attlen);
+
+		i++;
+	}
+}
+
 /*
  * Extra information for EXPLAIN on a modify action.
  */
@@ -907,10 +1329,7 @@ ifxExplainForeignModify(ModifyTableState *mstate,
 		ifxDeserializeFdwData(&state, fdw_private);
 
 		/* Give some possibly useful info about the remote query used */
-		if (es->costs)
-		{
-			ExplainPropertyText("Informix query", state.stmt_info.query, es);
-		}
+		ExplainPropertyText("Informix query", state.stmt_info.query, es);
 	}
 }
 
@@ -1190,33 +1609,25 @@ static void ifxColumnValuesToSqlda(IfxFdwExecutionState *state,
 }
 
 /*
- * Lookup the specified attribute number, obtain a column
- * identifier.
+ * Lookup the specified attribute number of the given foreign table
+ * and obtain its column identifier on the Informix server.
  *
  * Code borrowed from contrib/postgres_fdw.c
  */
-char *dispatchColumnIdentifier(int varno, int varattno, PlannerInfo *root)
+char *ifxColumnIdentifierByRelid(Oid relid, int attnum)
 {
-	char          *ident = NULL;
-	RangeTblEntry *rte;
-	List          *col_options;
-	ListCell      *cell;
-
-	/*
-	 * Take take for special varnos!
-	 */
-	Assert(!IS_SPECIAL_VARNO(varno));
-
-	rte = planner_rt_fetch(varno, root);
+	char     *ident = NULL;
+	List     *col_options;
+	ListCell *cell;
 
 	/*
-	 * Check out if this varattno has a special
+	 * Check out if this attnum has a special
 	 * column_name value attached.
 	 *
 	 * TODO: SELECT statements currently don't honor ifx_column_name settings,
 	 *       this issue will be adressed in the very near future!
 	 */
-	col_options = GetForeignColumnOptions(rte->relid, varattno);
+	col_options = GetForeignColumnOptions(relid, attnum);
 	foreach(cell, col_options)
 	{
 		DefElem *def = (DefElem *) lfirst(cell);
@@ -1233,7 +1644,41 @@ char *dispatchColumnIdentifier(int varno, int varattno, PlannerInfo *root)
 	 * was found.
 	 */
 	if (ident == NULL)
-		ident = pg_attname_by_relid(rte->relid, varattno, false);
+		ident = pg_attname_by_relid(relid, attnum, false);
+
+	return ident;
+}
+
+/*
+ * Lookup the specified attribute number, obtain a column
+ * identifier.
+ *
+ * If qualify is set, the identifier is prefixed with the alias
+ * "r<varno>" of its relation. This is required for remote queries
+ * referencing more than one table, e.g. pushed down joins.
+ */
+char *dispatchColumnIdentifier(int varno, int varattno, PlannerInfo *root,
+							   bool qualify)
+{
+	char          *ident;
+	RangeTblEntry *rte;
+
+	/*
+	 * Take take for special varnos!
+	 */
+	Assert(!IS_SPECIAL_VARNO(varno));
+
+	rte   = planner_rt_fetch(varno, root);
+	ident = ifxColumnIdentifierByRelid(rte->relid, varattno);
+
+	if (qualify)
+	{
+		StringInfoData buf;
+
+		initStringInfo(&buf);
+		appendStringInfo(&buf, "r%d.%s", varno, ident);
+		return buf.data;
+	}
 
 	return ident;
 }
@@ -1428,13 +1873,33 @@ ifxPlanForeignModify(PlannerInfo *root,
 	 */
 	ifxPrepareParamsForModify(state, root, resultRelation, plan, rte->relid);
 
+	/*
+	 * ROWID based UPDATE and DELETE actions can collect the ROWIDs
+	 * of several rows and modify them with a single statement, if
+	 * requested by the batch_size option. We can't do this if
+	 * the modified rows must be visible immediately, which is the
+	 * case with RETURNING or AFTER ROW triggers.
+	 */
+	state->batch_size = 0;
+
+	if (((operation == CMD_UPDATE) || (operation == CMD_DELETE))
+		&& state->use_rowid
+		&& (coninfo->batch_size > 1)
+		&& (plan->returningLists == NIL)
+		&& !ifxCheckForAfterRowTriggers(rte->relid, state, operation))
+	{
+		state->batch_size = coninfo->batch_size;
+		elog(DEBUG2, "informix_fdw: using ROWID batches of %d rows",
+			 state->batch_size);
+	}
+
 	/*
 	 * Generate the query.
 	 */
 	switch (operation)
 	{
 		case CMD_INSERT:
-			ifxGenerateInsertSql(state, coninfo, root, resultRelation);
+			ifxGenerateInsertSql(state, coninfo, rte->relid);
 			break;
 		case CMD_DELETE:
 			ifxGenerateDeleteSql(state, coninfo);
@@ -1580,6 +2045,14 @@ ifxBeginForeignModify(ModifyTableState *mstate,
 		return;
 	}
 
+	/*
+	 * INSERT ... RETURNING executes the INSERT for each row, so
+	 * that the SERIAL values generated by the Informix server
+	 * can be returned.
+	 */
+	state->insert_returning = ((mstate->operation == CMD_INSERT)
+							   && (rinfo->ri_projectReturning != NULL));
+
 	/*
 	 * An INSERT action need to do much more preparing work
 	 * than UPDATE/DELETE: Since no foreign scan is involved, the
@@ -1598,110 +2071,156 @@ ifxBeginForeignModify(ModifyTableState *mstate,
 	if ((mstate->operation != CMD_DELETE) ||
 		((mstate->operation == CMD_DELETE) && state->use_rowid))
 	{
-		/*
-		 * Get column list for local table definition.
-		 *
-		 * XXX: Modify on a foreign Informix table relies on equally
-		 *      named column identifiers.
-		 */
-		ifxPgColumnData(foreignTableOid, state);
+		ifxSetupModifyDescriptor(state, coninfo, mstate->operation,
+								 foreignTableOid);
+	}
 
-		/*
-		 * Describe the prepared statement into a SQLDA structure.
-		 *
-		 * This will return a valid SQLDA handle within our current
-		 * IfxStatementInfo handle.
-		 */
-		elog(DEBUG1, "describe statement \"%s\"", state->stmt_info.stmt_name);
+	/*
+	 * Allocate the ROWID batch, if requested by the plan. An UPDATE
+	 * also needs to remember the column values assigned to the
+	 * batched rows.
+	 */
+	if ((mstate->operation != CMD_INSERT)
+		&& (state->batch_size > 1))
+	{
+		state->batch_rowids = (int *) palloc(sizeof(int) * state->batch_size);
+		state->rows_buffered = 0;
 
-		if (mstate->operation == CMD_INSERT)
-		{
-			ifxDescribeAllocatorByName(&state->stmt_info);
-		}
-		else
+		if (mstate->operation == CMD_UPDATE)
 		{
-			/* CMD_UPDATE */
-			ifxDescribeStmtInput(&state->stmt_info);
+			int natts = list_length(state->affectedAttrNums);
+
+			state->batch_values = (Datum *) palloc0(sizeof(Datum) * natts);
+			state->batch_nulls  = (bool *) palloc0(sizeof(bool) * natts);
 		}
+	}
+}
 
-		ifxCatchExceptions(&state->stmt_info, IFX_STACK_ALLOCATE | IFX_STACK_DESCRIBE);
+/*
+ * Describes the prepared modify statement of the specified
+ * execution state and sets up its SQLDA structure to bind
+ * column values later. An INSERT cursor is opened, too,
+ * unless the INSERT has a RETURNING clause.
+ */
+static void ifxSetupModifyDescriptor(IfxFdwExecutionState *state,
+									 IfxConnectionInfo    *coninfo,
+									 CmdType               operation,
+									 Oid                   foreignTableOid)
+{
+	/*
+	 * Get column list for local table definition.
+	 *
+	 * XXX: Modify on a foreign Informix table relies on equally
+	 *      named column identifiers.
+	 */
+	ifxPgColumnData(foreignTableOid, state);
 
-		/*
-		 * Save number of prepared column attributes.
-		 */
-		state->stmt_info.ifxAttrCount = ifxDescriptorColumnCount(&state->stmt_info);
-		elog(DEBUG1, "get descriptor column count %d",
-			 state->stmt_info.ifxAttrCount);
+	/*
+	 * Describe the prepared statement into a SQLDA structure.
+	 *
+	 * This will return a valid SQLDA handle within our current
+	 * IfxStatementInfo handle.
+	 */
+	elog(DEBUG1, "describe statement \"%s\"", state->stmt_info.stmt_name);
 
-		/*
-		 * Don't forget to open the INSERT cursor we have established
-		 * ealier in the planning phase. UPDATE, the only other command
-		 * type possible here, relies on the cursor from it's scanning
-		 * part, so no need to do the same for it.
-		 */
-		if (mstate->operation == CMD_INSERT)
-		{
-			/*
-			 * Open the associated cursor...
-			 */
-			elog(DEBUG1, "open cursor with query \"%s\"",
-				 state->stmt_info.query);
-			ifxOpenCursorForPrepared(&state->stmt_info);
-			ifxCatchExceptions(&state->stmt_info, IFX_STACK_OPEN);
-		}
+	if (operation == CMD_INSERT)
+	{
+		ifxDescribeAllocatorByName(&state->stmt_info);
+	}
+	else
+	{
+		/* CMD_UPDATE */
+		ifxDescribeStmtInput(&state->stmt_info);
+	}
 
-		state->stmt_info.ifxAttrDefs = palloc(state->stmt_info.ifxAttrCount
-											  * sizeof(IfxAttrDef));
+	ifxCatchExceptions(&state->stmt_info, IFX_STACK_ALLOCATE | IFX_STACK_DESCRIBE);
 
-		/*
-		 * Populate target column info array.
-		 */
-		if ((state->stmt_info.row_size = ifxGetColumnAttributes(&state->stmt_info)) == 0)
-		{
-			/* oops, no memory to allocate? Something surely went wrong,
-			 * so abort */
-			ifxRewindCallstack(&state->stmt_info);
-			ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
-							errmsg("could not initialize informix column properties")));
-		}
+	/*
+	 * Save number of prepared column attributes.
+	 */
+	state->stmt_info.ifxAttrCount = ifxDescriptorColumnCount(&state->stmt_info);
+	elog(DEBUG1, "get descriptor column count %d",
+		 state->stmt_info.ifxAttrCount);
+
+	/*
+	 * Don't forget to open the INSERT cursor we have established
+	 * ealier in the planning phase. UPDATE, the only other command
+	 * type possible here, relies on the cursor from it's scanning
+	 * part, so no need to do the same for it.
+	 *
+	 * INSERT ... RETURNING doesn't use the cursor, but executes
+	 * the prepared statement for each row.
+	 */
+	if ((operation == CMD_INSERT) && !state->insert_returning)
+	{
+		int oldBufSize = 0;
+
+		state->batch_size = coninfo->batch_size;
 
 		/*
-		 * NOTE:
-		 *
-		 * ifxGetColumnAttributes() obtained all information about the
-		 * returned column and stored them within the informix SQLDA and
-		 * sqlvar structs. However, we don't want to allocate memory underneath
-		 * our current memory context, thus we allocate the required memory structure
-		 * on top here. ifxSetupDataBufferAligned() will assign the allocated
-		 * memory area to the SQLDA structure and will maintain the data offsets
-		 * properly aligned.
+		 * The size of the insert buffer is determined
+		 * when opening the cursor.
 		 */
-		state->stmt_info.data = (char *) palloc0(state->stmt_info.row_size);
-		state->stmt_info.indicator = (short *) palloc0(sizeof(short)
-													   * state->stmt_info.ifxAttrCount);
+		if (coninfo->insert_buffer_size > 0)
+			oldBufSize = ifxSetFetchBufferSize(coninfo->insert_buffer_size);
 
 		/*
-		 * Assign sqlvar pointers to the allocated memory area.
+		 * Open the associated cursor...
 		 */
-		ifxSetupDataBufferAligned(&state->stmt_info);
-	}
-}
+		elog(DEBUG1, "open cursor with query \"%s\"",
+			 state->stmt_info.query);
+		ifxOpenCursorForPrepared(&state->stmt_info);
 
-static TupleTableSlot *
-ifxExecForeignInsert(EState *estate,
-					 ResultRelInfo *rinfo,
-					 TupleTableSlot *slot,
-					 TupleTableSlot *planSlot)
-{
-	IfxFdwExecutionState *state;
-	int                   attnum;
+		if (coninfo->insert_buffer_size > 0)
+			ifxSetFetchBufferSize(oldBufSize);
 
-	/*
-	 * Setup action...
+		ifxCatchExceptions(&state->stmt_info, IFX_STACK_OPEN);
+	}
+
+	state->stmt_info.ifxAttrDefs = palloc(state->stmt_info.ifxAttrCount
+										  * sizeof(IfxAttrDef));
+
+	/*
+	 * Populate target column info array.
 	 */
-	state = rinfo->ri_FdwState;
-	elog(DEBUG3, "informix_fdw: exec insert with cursor \"%s\"",
-		 state->stmt_info.cursor_name);
+	if ((state->stmt_info.row_size = ifxGetColumnAttributes(&state->stmt_info)) == 0)
+	{
+		/* oops, no memory to allocate? Something surely went wrong,
+		 * so abort */
+		ifxRewindCallstack(&state->stmt_info);
+		ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
+						errmsg("could not initialize informix column properties")));
+	}
+
+	/*
+	 * NOTE:
+	 *
+	 * ifxGetColumnAttributes() obtained all information about the
+	 * returned column and stored them within the informix SQLDA and
+	 * sqlvar structs. However, we don't want to allocate memory underneath
+	 * our current memory context, thus we allocate the required memory structure
+	 * on top here. ifxSetupDataBufferAligned() will assign the allocated
+	 * memory area to the SQLDA structure and will maintain the data offsets
+	 * properly aligned.
+	 */
+	state->stmt_info.data = (char *) palloc0(state->stmt_info.row_size);
+	state->stmt_info.indicator = (short *) palloc0(sizeof(short)
+												   * state->stmt_info.ifxAttrCount);
+
+	/*
+	 * Assign sqlvar pointers to the allocated memory area.
+	 */
+	ifxSetupDataBufferAligned(&state->stmt_info);
+}
+
+/*
+ * Copies the column values of the specified tuple into the
+ * SQLDA structure of the prepared INSERT statement.
+ */
+static void ifxTupleToInsertSqlda(IfxFdwExecutionState *state,
+								  TupleTableSlot *slot)
+{
+	int attnum;
 
 	/*
 	 * Copy column values into Informix SQLDA structure.
@@ -1729,6 +2248,17 @@ ifxExecForeignInsert(EState *estate,
 		if (state->pgAttrDefs[attnum].attnum > 0)
 			ifxColumnValuesToSqlda(state, slot, state->pgAttrDefs[attnum].attnum - 1);
 	}
+}
+
+/*
+ * Copies the column values of the specified tuple into the
+ * SQLDA structure of the INSERT cursor and PUTs them into
+ * its buffer.
+ */
+static void ifxPutTupleInInsertCursor(IfxFdwExecutionState *state,
+									  TupleTableSlot *slot)
+{
+	ifxTupleToInsertSqlda(state, slot);
 
 	/*
 	 * Execute the INSERT. Note that we have prepared
@@ -1738,6 +2268,146 @@ ifxExecForeignInsert(EState *estate,
 	ifxPutValuesInPrepared(&state->stmt_info);
 	ifxCatchExceptions(&state->stmt_info, 0);
 
+	state->rows_buffered++;
+}
+
+/*
+ * Executes the prepared INSERT statement for the specified tuple
+ * and stores the SERIAL, SERIAL8 or BIGSERIAL values generated by
+ * the Informix server into the slot. The values of all other columns
+ * are returned as inserted, the row isn't fetched again.
+ */
+static void ifxExecInsertReturning(IfxFdwExecutionState *state,
+								   TupleTableSlot *slot)
+{
+	TupleDesc tupdesc = slot->tts_tupleDescriptor;
+	Datum    *values;
+	bool     *nulls;
+	HeapTuple tuple;
+	int       attnum;
+
+	ifxTupleToInsertSqlda(state, slot);
+
+	ifxExecuteStmtSqlda(&state->stmt_info);
+	ifxCatchExceptions(&state->stmt_info, 0);
+
+	/*
+	 * Copy the inserted values, the generated serial
+	 * values replace them in the copy.
+	 */
+	slot_getallattrs(slot);
+
+	values = (Datum *) palloc(sizeof(Datum) * tupdesc->natts);
+	nulls  = (bool *) palloc(sizeof(bool) * tupdesc->natts);
+	memcpy(values, slot->tts_values, sizeof(Datum) * tupdesc->natts);
+	memcpy(nulls, slot->tts_isnull, sizeof(bool) * tupdesc->natts);
+
+	for (attnum = 0; attnum < state->pgAttrCount; attnum++)
+	{
+		PgAttrDef *attrDef = &state->pgAttrDefs[attnum];
+		char      *buf;
+		char      *serial;
+		Oid        typinput;
+		Oid        typioparam;
+
+		/* dropped column */
+		if (attrDef->attnum <= 0)
+			continue;
+
+		/*
+		 * The serial values are available from the SQLCA area
+		 * and the ESQL/C library without asking the server again.
+		 */
+		switch (IFX_ATTRTYPE_P(state, attnum))
+		{
+			case IFX_SERIAL:
+				buf = (char *) palloc0(IFX_INT8_CHAR_LEN + 1);
+				snprintf(buf, IFX_INT8_CHAR_LEN + 1, "%d",
+						 ifxGetSQLCAErrd(SQLCA_SERIAL_VALUE));
+				serial = buf;
+				break;
+			case IFX_SERIAL8:
+				buf    = (char *) palloc0(IFX_INT8_CHAR_LEN + 1);
+				serial = ifxGetSerial8(0, buf);
+				break;
+			case IFX_BIGSERIAL:
+				buf    = (char *) palloc0(IFX_INT8_CHAR_LEN + 1);
+				serial = ifxGetSerial8(1, buf);
+				break;
+			default:
+				continue;
+		}
+
+		if (serial == NULL)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DATA_TYPE),
+							errmsg("could not convert serial value for column \"%s\"",
+								   attrDef->attname)));
+
+		getTypeInputInfo(attrDef->atttypid, &typinput, &typioparam);
+
+		values[attrDef->attnum - 1] = OidInputFunctionCall(typinput, serial,
+														   typioparam,
+														   attrDef->atttypmod);
+		nulls[attrDef->attnum - 1]  = false;
+	}
+
+	tuple = heap_form_tuple(tupdesc, values, nulls);
+	ExecStoreTuple(tuple, slot, InvalidBuffer, true);
+}
+
+/*
+ * Sends all rows buffered by the INSERT cursor
+ * to the Informix server.
+ */
+static void ifxFlushInsertCursor(IfxFdwExecutionState *state)
+{
+	if (state->rows_buffered == 0)
+		return;
+
+	elog(DEBUG2, "informix_fdw: flush %d rows of insert cursor \"%s\"",
+		 state->rows_buffered, state->stmt_info.cursor_name);
+
+	ifxFlushCursor(&state->stmt_info);
+	ifxCatchExceptions(&state->stmt_info, 0);
+
+	state->rows_buffered = 0;
+}
+
+static TupleTableSlot *
+ifxExecForeignInsert(EState *estate,
+					 ResultRelInfo *rinfo,
+					 TupleTableSlot *slot,
+					 TupleTableSlot *planSlot)
+{
+	IfxFdwExecutionState *state;
+
+	/*
+	 * Setup action...
+	 */
+	state = rinfo->ri_FdwState;
+
+	if (state->insert_returning)
+	{
+		elog(DEBUG3, "informix_fdw: exec insert returning with statement \"%s\"",
+			 state->stmt_info.stmt_name);
+
+		ifxExecInsertReturning(state, slot);
+		return slot;
+	}
+
+	elog(DEBUG3, "informix_fdw: exec insert with cursor \"%s\"",
+		 state->stmt_info.cursor_name);
+
+	ifxPutTupleInInsertCursor(state, slot);
+
+	/*
+	 * With batch_size set, don't leave flushing to ESQL/C, which
+	 * only happens when the insert buffer is full.
+	 */
+	if ((state->batch_size > 0)
+		&& (state->rows_buffered >= state->batch_size))
+		ifxFlushInsertCursor(state);
+
 	return slot;
 }
 
@@ -1781,6 +2451,18 @@ ifxExecForeignDelete(EState *estate,
 		 */
 		ifxCatchExceptions(&state->stmt_info, 0);
 	}
+	else if (state->batch_rowids != NULL)
+	{
+		/*
+		 * Remember the ROWID and delete the batched rows
+		 * at once if the batch is full.
+		 */
+		state->batch_rowids[state->rows_buffered++]
+			= ifxGetRowIdFromSlot(state, planSlot);
+
+		if (state->rows_buffered >= state->batch_size)
+			ifxFlushRowIdBatch(state);
+	}
 	else
 	{
 		/*
@@ -1818,6 +2500,41 @@ ifxExecForeignUpdate(EState *estate,
 	elog(DEBUG3, "informix_fdw: exec update with cursor \"%s\"",
 		 state->stmt_info.cursor_name);
 
+	/*
+	 * A batched UPDATE assigns the same column values to all
+	 * of its rows. If the new values of this row differ, the current
+	 * batch must be executed first and we start a new one.
+	 */
+	if (state->batch_rowids != NULL)
+	{
+		if ((state->rows_buffered > 0)
+			&& !ifxBatchValuesEqual(state, slot))
+			ifxFlushRowIdBatch(state);
+
+		if (state->rows_buffered == 0)
+		{
+			param_id = 0;
+			foreach(cell, state->affectedAttrNums)
+			{
+				int attnum = lfirst_int(cell);
+
+				state->pgAttrDefs[attnum - 1].param_id = param_id;
+				ifxColumnValuesToSqlda(state, slot, attnum - 1);
+				param_id++;
+			}
+
+			ifxSaveBatchValues(state, slot);
+		}
+
+		state->batch_rowids[state->rows_buffered++]
+			= ifxGetRowIdFromSlot(state, planSlot);
+
+		if (state->rows_buffered >= state->batch_size)
+			ifxFlushRowIdBatch(state);
+
+		return slot;
+	}
+
 	/*
 	 * NOTE:
 	 *
@@ -1884,8 +2601,15 @@ static void ifxEndForeignModify(EState *estate,
 		&& (state->stmt_info.call_stack & IFX_STACK_OPEN))
 	{
 		ifxFlushCursor(&state->stmt_info);
+		state->rows_buffered = 0;
 	}
 
+	/*
+	 * Modify all rows left in a ROWID batch.
+	 */
+	if (state->batch_rowids != NULL)
+		ifxFlushRowIdBatch(state);
+
 	/*
 	 * Catch any exceptions.
 	 */
@@ -1898,6 +2622,109 @@ static void ifxEndForeignModify(EState *estate,
 	ifxRewindCallstack(&state->stmt_info);
 }
 
+#if PG_VERSION_NUM >= 110000
+
+/*
+ * ifxBeginForeignInsert
+ *
+ * Prepares the INSERT cursor for COPY FROM and tuple routing
+ * into a foreign table. There's no planning phase in this case,
+ * so everything ifxPlanForeignModify() does for an INSERT is done
+ * here. Rows are passed to ifxExecForeignInsert() afterwards and
+ * ifxEndForeignModify() flushes the cursor.
+ */
+static void ifxBeginForeignInsert(ModifyTableState *mtstate,
+								  ResultRelInfo *rinfo)
+{
+	IfxConnectionInfo    *coninfo;
+	IfxFdwExecutionState *state;
+	List                 *plan_values;
+	ModifyTable          *plan;
+	Oid                   foreignTableOid;
+
+	elog(DEBUG3, "informix_fdw: begin foreign insert");
+
+	foreignTableOid = RelationGetRelid(rinfo->ri_RelationDesc);
+	plan = (mtstate != NULL) ? (ModifyTable *) mtstate->ps.plan : NULL;
+
+	/*
+	 * Don't support INSERT ... ON CONFLICT, same as
+	 * ifxPlanForeignModify().
+	 */
+	if ((plan != NULL)
+		&& (plan->onConflictAction != ONCONFLICT_NONE))
+	{
+		ereport(ERROR, (errcode(ERRCODE_FDW_UNABLE_TO_CREATE_EXECUTION),
+						errmsg("INSERT with ON CONFLICT clause is not supported")));
+	}
+
+	/*
+	 * Initialize the connection and get a new statement
+	 * reference id for the INSERT cursor.
+	 */
+	ifxSetupFdwScan(&coninfo, &state, &plan_values,
+					foreignTableOid, IFX_PLAN_SCAN);
+
+	if (coninfo->query != NULL)
+	{
+		ereport(ERROR, (errcode(ERRCODE_FDW_UNABLE_TO_CREATE_EXECUTION),
+						errmsg("cannot modify foreign table \"%s\" which is based on a query",
+							   RelationGetRelationName(rinfo->ri_RelationDesc))));
+	}
+
+	StrNCpy(state->stmt_info.conname, coninfo->conname, IFX_CONNAME_LEN);
+
+	/*
+	 * Generate, prepare and declare the INSERT cursor.
+	 */
+	ifxPrepareParamsForInsert(state, RelationGetDescr(rinfo->ri_RelationDesc));
+	ifxGenerateInsertSql(state, coninfo, foreignTableOid);
+	ifxPrepareModifyQuery(&state->stmt_info, coninfo, CMD_INSERT);
+
+	state->insert_returning = (rinfo->ri_projectReturning != NULL);
+
+	/* ...and open it */
+	ifxSetupModifyDescriptor(state, coninfo, CMD_INSERT, foreignTableOid);
+
+	rinfo->ri_FdwState = state;
+}
+
+#endif
+
+/*
+ * Prepare parameters for an INSERT action. Retrieves attribute
+ * numbers for all columns, we apply all columns in an INSERT action.
+ */
+static void ifxPrepareParamsForInsert(IfxFdwExecutionState *state,
+									  TupleDesc             tupdesc)
+{
+	int attnum;
+
+	/*
+	 * We need to set the correct cursor type here, since
+	 * CMD_INSERT needs to establish its own cursor during
+	 * planning. We don't have a corresponding foreign scan
+	 * like in CMD_DELETE here, where we just reuse the existing
+	 * cursor established during the foreign scan phase here. This
+	 * make things complicater, but the only thing we need to bother
+	 * at this point is that the execution state gets its cursorUsage
+	 * adjusted accordingly. Any other modify action will already
+	 * have the correct cursorUsage set during ifxGetForeignRelSize()!
+	 */
+	state->stmt_info.cursorUsage = IFX_INSERT_CURSOR;
+
+	/*
+	 * We need all columns for CMD_INSERT.
+	 */
+	for (attnum = 1; attnum <= tupdesc->natts; attnum++)
+	{
+		Form_pg_attribute pgattr = TUPDESC_GET_ATTR(tupdesc, attnum - 1);
+
+		state->affectedAttrNums = lappend_int(state->affectedAttrNums,
+											  pgattr->attnum);
+	}
+}
+
 /*
  * Prepare parameters for modify action.
  */
@@ -1921,36 +2748,7 @@ static void ifxPrepareParamsForModify(IfxFdwExecutionState *state,
 	{
 		case CMD_INSERT:
 		{
-			/*
-			 * Retrieve attribute numbers for all columns. We apply all
-			 * columns in an INSERT action.
-			 */
-			TupleDesc tupdesc = RelationGetDescr(rel);
-			int       attnum;
-
-			/*
-			 * We need to set the correct cursor type here, since
-			 * CMD_INSERT needs to establish its own cursor during
-			 * planning. We don't have a corresponding foreign scan
-			 * like in CMD_DELETE here, where we just reuse the existing
-			 * cursor established during the foreign scan phase here. This
-			 * make things complicater, but the only thing we need to bother
-			 * at this point is that the execution state gets its cursorUsage
-			 * adjusted accordingly. Any other modify action will already
-			 * have the correct cursorUsage set during ifxGetForeignRelSize()!
-			 */
-			state->stmt_info.cursorUsage = IFX_INSERT_CURSOR;
-
-			/*
-			 * We need all columns for CMD_INSERT.
-			 */
-			for (attnum = 1; attnum <= tupdesc->natts; attnum++)
-			{
-				Form_pg_attribute pgattr = TUPDESC_GET_ATTR(tupdesc, attnum - 1);
-
-				state->affectedAttrNums = lappend_int(state->affectedAttrNums,
-													  pgattr->attnum);
-			}
+			ifxPrepareParamsForInsert(state, RelationGetDescr(rel));
 
 			/* ...and we're done */
 			break;
@@ -1998,51 +2796,483 @@ static void ifxPrepareParamsForModify(IfxFdwExecutionState *state,
 
 #endif
 
+#if PG_VERSION_NUM >= 90600
+
 /*
- * Initializes the given IfxStatementInfo structure with
- * reasonable default values. Assigns a valid connection
- * identifier and refid from the given IfxConnectionInfo
- * structure and refid.
+ * ifxPlanDirectModify
  *
- * The cursorUsage is set to IFX_SCROLL_CURSOR by default
- * and no special columns are assigned (IFX_NO_SPECIAL_COLS).
+ * Checks wether an UPDATE or DELETE can be executed by the Informix
+ * server directly, without fetching the rows and modifying them
+ * one by one. This is possible if all conditions of the foreign scan
+ * and all expressions assigned by an UPDATE are shippable. The plan
+ * data of the foreign scan is replaced by the remote modify statement
+ * then. INSERT is handled by ifxPlanDirectInsert().
  */
-static void ifxStatementInfoInit(IfxStatementInfo *info,
-								 int refid)
+static bool ifxPlanDirectModify(PlannerInfo *root,
+								ModifyTable *plan,
+								Index resultRelation,
+								int subplan_index)
 {
-	/* Assign the specified reference id. */
-	info->refid = refid;
+	CmdType               operation = plan->operation;
+	Plan                 *subplan;
+	ForeignScan          *fscan;
+	RelOptInfo           *baserel;
+	RangeTblEntry        *rte;
+	IfxFdwPlanState      *planState;
+	IfxConnectionInfo    *coninfo;
+	IfxFdwExecutionState *state;
+	List                 *plan_values;
+	List                 *targetlist;
+	List                 *where_conds;
+	ListCell             *cell;
 
-	bzero(info->conname, IFX_CONNAME_LEN + 1);
-	info->cursorUsage = IFX_SCROLL_CURSOR;
+	elog(DEBUG3, "informix_fdw: plan direct modify");
 
-	info->query        = NULL;
-	info->predicate    = NULL;
-	info->cursor_name  = NULL;
-	info->stmt_name    = NULL;
-	info->descr_name   = NULL;
-	info->sqlda        = NULL;
-	info->ifxAttrCount = 0;
-	info->ifxAttrDefs  = NULL;
-	info->call_stack   = IFX_STACK_EMPTY;
-	info->row_size     = 0;
-	info->special_cols = IFX_NO_SPECIAL_COLS;
+	if (operation == CMD_INSERT)
+		return ifxPlanDirectInsert(root, plan, resultRelation, subplan_index);
 
-	bzero(info->sqlstate, 6);
-	info->exception_count = 0;
-}
+	if ((operation != CMD_UPDATE)
+		&& (operation != CMD_DELETE))
+		return false;
 
-/*
- * Check and assign requested FDW options
- * to an IfxConnectionInfo structure.
- */
-static void ifxAssignOptions(IfxConnectionInfo *coninfo,
-							 List *options,
-							 bool mandatory[IFX_REQUIRED_CONN_KEYWORDS])
-{
-	ListCell *elem;
+	/*
+	 * RETURNING needs the modified rows, which we only get
+	 * by fetching them.
+	 */
+	if (plan->returningLists != NIL)
+		return false;
 
-	/* shortcut, nothing to do? */
+	/*
+	 * The modified rows must come from a plain foreign scan on the
+	 * result relation, without any conditions evaluated locally.
+	 */
+	subplan = (Plan *) list_nth(plan->plans, subplan_index);
+
+	if (!IsA(subplan, ForeignScan))
+		return false;
+
+	fscan = (ForeignScan *) subplan;
+
+	if ((fscan->scan.scanrelid != resultRelation)
+		|| (subplan->qual != NIL)
+		|| (outerPlan(subplan) != NULL))
+		return false;
+
+	baserel   = find_base_rel(root, resultRelation);
+	planState = (IfxFdwPlanState *) baserel->fdw_private;
+	rte       = planner_rt_fetch(resultRelation, root);
+
+	if (planState == NULL)
+		return false;
+
+	/*
+	 * Foreign tables based on a query aren't updatable at all,
+	 * leave the error to ifxPlanForeignModify().
+	 */
+	if ((planState->coninfo->query != NULL)
+		|| !planState->coninfo->predicate_pushdown)
+		return false;
+
+	where_conds = NIL;
+	foreach(cell, baserel->baserestrictinfo)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(cell);
+
+		if (rinfo->pseudoconstant
+			|| !ifxIsShippableExpr(root, baserel, (Node *) rinfo->clause))
+			return false;
+
+		where_conds = lappend(where_conds, rinfo->clause);
+	}
+
+	/*
+	 * Get the expressions assigned to the updated columns. The target
+	 * list of the scan holds the new row, ordered by attribute number.
+	 */
+	targetlist = NIL;
+
+	if (operation == CMD_UPDATE)
+	{
+		Bitmapset  *tmpset = bms_copy(RTE_UPDATED_COLS(rte));
+		AttrNumber  col;
+
+		while ((col = bms_first_member(tmpset)) >= 0)
+		{
+			TargetEntry *tle;
+
+			col += FirstLowInvalidHeapAttributeNumber;
+			if (col <= InvalidAttrNumber)		/* shouldn't happen */
+				elog(ERROR, "system-column update is not supported");
+
+			tle = get_tle_by_resno(subplan->targetlist, col);
+
+			if (tle == NULL)
+				elog(ERROR, "attribute number %d not found in UPDATE target list",
+					 col);
+
+			if (!ifxIsShippableExpr(root, baserel, (Node *) tle->expr))
+				return false;
+
+			targetlist = lappend(targetlist, tle);
+		}
+	}
+
+	/*
+	 * Get a new statement reference id for the modify
+	 * statement. Also makes the connection current.
+	 */
+	ifxSetupFdwScan(&coninfo, &state, &plan_values,
+					rte->relid, IFX_PLAN_SCAN);
+	coninfo->planData = planState->coninfo->planData;
+
+	/* No ROWID required, the rows are never fetched */
+	state->use_rowid = false;
+
+	ifxGenerateDirectModifySql(state, coninfo, root, baserel, operation,
+							   targetlist, where_conds);
+
+	StrNCpy(state->stmt_info.conname, coninfo->conname, IFX_CONNAME_LEN);
+
+	/*
+	 * The statement is prepared by ifxBeginDirectModify(), but we need
+	 * valid identifiers to serialize the execution state.
+	 */
+	state->stmt_info.stmt_name   = ifxGenStatementName(state->stmt_info.refid);
+	state->stmt_info.cursor_name = ifxGenCursorName(state->stmt_info.refid);
+
+	/*
+	 * The cursor declared for the foreign scan isn't used anymore.
+	 */
+	ifxDisposeBaseRelCursors(root, baserel->relids);
+
+	elog(DEBUG2, "informix_fdw: direct modify query \"%s\"",
+		 state->stmt_info.query);
+
+	/*
+	 * Turn the foreign scan into a direct modify action.
+	 */
+	fscan->operation   = operation;
+	fscan->fdw_private = ifxSerializePlanData(coninfo, state, root);
+
+	return true;
+}
+
+/*
+ * ifxPlanDirectInsert
+ *
+ * Checks wether an INSERT ... SELECT reading a foreign table on the
+ * same Informix connection can be executed by the Informix server as
+ * a single INSERT INTO ... SELECT statement, instead of fetching the
+ * rows and inserting them again. This is possible if the rows come
+ * from a plain foreign scan with all its conditions and all inserted
+ * expressions shippable. The foreign scan is turned into a direct
+ * modify action on the target table executing the remote statement then.
+ */
+static bool ifxPlanDirectInsert(PlannerInfo *root,
+								ModifyTable *plan,
+								Index resultRelation,
+								int subplan_index)
+{
+	Plan                 *subplan;
+	ForeignScan          *fscan;
+	RelOptInfo           *scanrel;
+	RangeTblEntry        *rte;
+	IfxFdwPlanState      *planState;
+	IfxConnectionInfo    *target_coninfo;
+	IfxConnectionInfo    *coninfo;
+	IfxFdwExecutionState *state;
+	List                 *plan_values;
+	List                 *targetlist;
+	List                 *where_conds;
+	Relation              rel;
+	ListCell             *cell;
+
+	/*
+	 * RETURNING needs the inserted rows and ON CONFLICT
+	 * doesn't exist in Informix.
+	 */
+	if ((plan->returningLists != NIL)
+		|| (plan->onConflictAction != ONCONFLICT_NONE))
+		return false;
+
+	/*
+	 * The rows must come from a plain foreign scan, without any
+	 * conditions evaluated locally or query parameters. Joins and
+	 * aggregates pushed down to the Informix server don't have a
+	 * scan relation.
+	 */
+	subplan = (Plan *) list_nth(plan->plans, subplan_index);
+
+	if (!IsA(subplan, ForeignScan))
+		return false;
+
+	fscan = (ForeignScan *) subplan;
+
+	if ((fscan->scan.scanrelid == 0)
+		|| (fscan->operation != CMD_SELECT)
+		|| (fscan->fdw_exprs != NIL)
+		|| (subplan->qual != NIL)
+		|| (outerPlan(subplan) != NULL))
+		return false;
+
+	scanrel = find_base_rel(root, fscan->scan.scanrelid);
+	rte     = planner_rt_fetch(resultRelation, root);
+
+	/*
+	 * The source table might belong to another foreign server,
+	 * even of another foreign data wrapper.
+	 */
+	if (scanrel->serverid != GetForeignTable(rte->relid)->serverid)
+		return false;
+
+	planState = (IfxFdwPlanState *) scanrel->fdw_private;
+
+	if ((planState == NULL)
+		|| (planState->coninfo->query != NULL)
+		|| !planState->coninfo->predicate_pushdown)
+		return false;
+
+	/*
+	 * Both tables must be accessed through the same Informix
+	 * connection. Informix refuses to insert into the table
+	 * the rows are selected from.
+	 */
+	target_coninfo = ifxMakeConnectionInfo(rte->relid);
+
+	if ((target_coninfo->query != NULL)
+		|| (strcmp(target_coninfo->conname, planState->coninfo->conname) != 0)
+		|| (pg_strcasecmp(target_coninfo->tablename,
+						  planState->coninfo->tablename) == 0))
+		return false;
+
+	where_conds = NIL;
+	foreach(cell, scanrel->baserestrictinfo)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(cell);
+
+		if (rinfo->pseudoconstant
+			|| !ifxIsShippableExpr(root, scanrel, (Node *) rinfo->clause))
+			return false;
+
+		where_conds = lappend(where_conds, rinfo->clause);
+	}
+
+	/*
+	 * The target list of the scan holds the new row, ordered by
+	 * attribute number of the target table. Columns not mentioned by
+	 * the INSERT carry their default expression or NULL, like the
+	 * rows sent by ifxExecForeignInsert().
+	 */
+	rel        = heap_open(rte->relid, NoLock);
+	targetlist = NIL;
+
+	foreach(cell, subplan->targetlist)
+	{
+		TargetEntry *tle = (TargetEntry *) lfirst(cell);
+
+		if (tle->resjunk
+			|| TUPDESC_GET_ATTR(RelationGetDescr(rel), tle->resno - 1)->attisdropped)
+			continue;
+
+		if (!ifxIsShippableExpr(root, scanrel, (Node *) tle->expr))
+		{
+			targetlist = NIL;
+			break;
+		}
+
+		targetlist = lappend(targetlist, tle);
+	}
+
+	heap_close(rel, NoLock);
+
+	if (targetlist == NIL)
+		return false;
+
+	/*
+	 * Get a new statement reference id for the remote
+	 * statement. Also makes the connection current.
+	 */
+	ifxSetupFdwScan(&coninfo, &state, &plan_values,
+					rte->relid, IFX_PLAN_SCAN);
+	coninfo->planData = planState->coninfo->planData;
+
+	/* No ROWID required, the rows are never fetched */
+	state->use_rowid = false;
+
+	ifxGenerateInsertSelectSql(state, coninfo, rte->relid, root, scanrel,
+							   targetlist, where_conds);
+
+	StrNCpy(state->stmt_info.conname, coninfo->conname, IFX_CONNAME_LEN);
+
+	/*
+	 * The statement is prepared by ifxBeginDirectModify(), but we need
+	 * valid identifiers to serialize the execution state.
+	 */
+	state->stmt_info.stmt_name   = ifxGenStatementName(state->stmt_info.refid);
+	state->stmt_info.cursor_name = ifxGenCursorName(state->stmt_info.refid);
+
+	/*
+	 * The cursor declared for the foreign scan isn't used anymore.
+	 */
+	ifxDisposeBaseRelCursors(root, scanrel->relids);
+
+	elog(DEBUG2, "informix_fdw: direct insert query \"%s\"",
+		 state->stmt_info.query);
+
+	/*
+	 * Turn the foreign scan into a direct modify action on the
+	 * target table. The source table is only referenced by the
+	 * remote statement, which uses the same connection. This
+	 * also makes EXPLAIN name the target table.
+	 */
+	fscan->scan.scanrelid = resultRelation;
+	fscan->operation      = CMD_INSERT;
+	fscan->fdw_private    = ifxSerializePlanData(coninfo, state, root);
+
+	return true;
+}
+
+/*
+ * ifxBeginDirectModify
+ *
+ * Prepares the modify statement generated by
+ * ifxPlanDirectModify() on the Informix server.
+ */
+static void ifxBeginDirectModify(ForeignScanState *node, int eflags)
+{
+	IfxConnectionInfo    *coninfo;
+	IfxFdwExecutionState *state;
+	Oid                   foreignTableOid;
+
+	elog(DEBUG3, "informix_fdw: begin direct modify");
+
+	foreignTableOid = RelationGetRelid(node->ss.ss_currentRelation);
+
+	/*
+	 * Activate cached connection, this also starts
+	 * a transaction if required.
+	 */
+	ifxSetupConnection(&coninfo,
+					   foreignTableOid,
+					   IFX_BEGIN_SCAN,
+					   true);
+
+	state = makeIfxFdwExecutionState(-1);
+	node->fdw_state = (void *) state;
+
+	ifxDeserializeFdwData(state, PG_SCANSTATE_PRIVATE_P(node));
+
+	/* EXPLAIN without ANALYZE... */
+	if (eflags & EXEC_FLAG_EXPLAIN_ONLY)
+	{
+		elog(DEBUG1, "informix_fdw: explain only");
+		return;
+	}
+
+	elog(DEBUG1, "prepare query \"%s\"", state->stmt_info.query);
+	ifxPrepareQuery(state->stmt_info.query,
+					state->stmt_info.stmt_name);
+	ifxCatchExceptions(&state->stmt_info, IFX_STACK_PREPARE);
+}
+
+/*
+ * ifxIterateDirectModify
+ *
+ * Executes the modify statement on the first call. Since we don't
+ * support RETURNING here, there are never any tuples to return.
+ */
+static TupleTableSlot *ifxIterateDirectModify(ForeignScanState *node)
+{
+	IfxFdwExecutionState *state  = (IfxFdwExecutionState *) node->fdw_state;
+	EState               *estate = node->ss.ps.state;
+
+	if (state->affected_rows < 0)
+	{
+		elog(DEBUG3, "informix_fdw: exec direct modify with statement \"%s\"",
+			 state->stmt_info.stmt_name);
+
+		ifxExecuteStmt(&state->stmt_info);
+		ifxCatchExceptions(&state->stmt_info, 0);
+
+		/*
+		 * Report the number of rows processed by the Informix
+		 * server back to the local command.
+		 */
+		state->affected_rows = ifxGetSQLCAErrd(SQLCA_NROWS_AFFECTED);
+		estate->es_processed += state->affected_rows;
+
+		elog(DEBUG2, "informix_fdw: direct modify affected %d rows",
+			 state->affected_rows);
+	}
+
+	return ExecClearTuple(node->ss.ss_ScanTupleSlot);
+}
+
+/*
+ * ifxEndDirectModify
+ *
+ * Frees the prepared modify statement.
+ */
+static void ifxEndDirectModify(ForeignScanState *node)
+{
+	IfxFdwExecutionState *state = (IfxFdwExecutionState *) node->fdw_state;
+
+	elog(DEBUG3, "informix_fdw: end direct modify");
+
+	if (state == NULL)
+		return;
+
+	ifxRewindCallstack(&state->stmt_info);
+}
+
+#endif
+
+/*
+ * Initializes the given IfxStatementInfo structure with
+ * reasonable default values. Assigns a valid connection
+ * identifier and refid from the given IfxConnectionInfo
+ * structure and refid.
+ *
+ * The cursorUsage is set to IFX_SCROLL_CURSOR by default
+ * and no special columns are assigned (IFX_NO_SPECIAL_COLS).
+ */
+static void ifxStatementInfoInit(IfxStatementInfo *info,
+								 int refid)
+{
+	/* Assign the specified reference id. */
+	info->refid = refid;
+
+	bzero(info->conname, IFX_CONNAME_LEN + 1);
+	info->cursorUsage = IFX_SCROLL_CURSOR;
+
+	info->query        = NULL;
+	info->predicate    = NULL;
+	info->directives   = NULL;
+	info->cursor_name  = NULL;
+	info->stmt_name    = NULL;
+	info->descr_name   = NULL;
+	info->sqlda        = NULL;
+	info->ifxAttrCount = 0;
+	info->ifxAttrDefs  = NULL;
+	info->call_stack   = IFX_STACK_EMPTY;
+	info->row_size     = 0;
+	info->special_cols = IFX_NO_SPECIAL_COLS;
+
+	bzero(info->sqlstate, 6);
+	info->exception_count = 0;
+}
+
+/*
+ * Check and assign requested FDW options
+ * to an IfxConnectionInfo structure.
+ */
+static void ifxAssignOptions(IfxConnectionInfo *coninfo,
+							 List *options,
+							 bool mandatory[IFX_REQUIRED_CONN_KEYWORDS])
+{
+	ListCell *elem;
+
+	/* shortcut, nothing to do? */
 	if (list_length(options) <= 0)
 		return;
 
@@ -2156,21 +3386,86 @@ static void ifxAssignOptions(IfxConnectionInfo *coninfo,
 			coninfo->delimident = 1;
 		}
 
-	}
-}
+		if (strcmp(def->defname, "batch_size") == 0)
+		{
+			coninfo->batch_size = ifxGetIntOption(def, 1);
+		}
 
-/*
- * Check the specified foreign table OID if it has
- * AFTER EACH ROW triggers attached. ifxCheckForAfterRowTriggers()
- * assumes, that the caller already locked foreignTableOid for
- * inspection.
- */
-static bool ifxCheckForAfterRowTriggers(Oid foreignTableOid,
-										IfxFdwExecutionState *state,
-										CmdType cmd)
-{
-	Relation rel    = heap_open(foreignTableOid, NoLock);
-	bool     result = false;
+		if (strcmp(def->defname, "insert_buffer_size") == 0)
+		{
+			coninfo->insert_buffer_size = ifxGetIntOption(def, 1);
+		}
+
+		if (strcmp(def->defname, "statement_cache_size") == 0)
+		{
+			coninfo->stmt_cache_size = ifxGetIntOption(def, 0);
+		}
+
+		if (strcmp(def->defname, "estimate_cache_ttl") == 0)
+		{
+			coninfo->estimate_cache_ttl = ifxGetIntOption(def, 0);
+		}
+
+		if (strcmp(def->defname, "use_remote_estimate") == 0)
+		{
+			coninfo->use_remote_estimate = defGetBoolean(def) ? 1 : 0;
+		}
+
+		if (strcmp(def->defname, "fdw_startup_cost") == 0)
+		{
+			coninfo->fdw_startup_cost = ifxGetFloatOption(def);
+		}
+
+		if (strcmp(def->defname, "fdw_tuple_cost") == 0)
+		{
+			coninfo->fdw_tuple_cost = ifxGetFloatOption(def);
+		}
+
+		if (strcmp(def->defname, "remote_cost_factor") == 0)
+		{
+			coninfo->remote_cost_factor = ifxGetFloatOption(def);
+		}
+
+		if (strcmp(def->defname, "analyze_sampling") == 0)
+		{
+			coninfo->analyze_sampling = defGetBoolean(def) ? 1 : 0;
+		}
+
+		if (strcmp(def->defname, "import_statistics") == 0)
+		{
+			coninfo->import_statistics = defGetBoolean(def) ? 1 : 0;
+		}
+
+		if (strcmp(def->defname, "extensions") == 0)
+		{
+			coninfo->extensions = pstrdup(defGetString(def));
+		}
+
+		if (strcmp(def->defname, "join_filter_rows") == 0)
+		{
+			coninfo->join_filter_rows = ifxGetIntOption(def, 0);
+		}
+
+		if (strcmp(def->defname, "optimizer_directives") == 0)
+		{
+			coninfo->optimizer_directives = pstrdup(defGetString(def));
+		}
+
+	}
+}
+
+/*
+ * Check the specified foreign table OID if it has
+ * AFTER EACH ROW triggers attached. ifxCheckForAfterRowTriggers()
+ * assumes, that the caller already locked foreignTableOid for
+ * inspection.
+ */
+static bool ifxCheckForAfterRowTriggers(Oid foreignTableOid,
+										IfxFdwExecutionState *state,
+										CmdType cmd)
+{
+	Relation rel    = heap_open(foreignTableOid, NoLock);
+	bool     result = false;
 
 	/*
 	 * We are interested in after triggers only.
@@ -2412,18 +3707,93 @@ ifxFetchTuple(IfxFdwExecutionState *state)
  * Entry point for scan preparation. Does all the leg work
  * for preparing the query and cursor definitions before
  * entering the executor.
+ *
+ * If the estimates of a query with the same shape on this
+ * foreign table are still cached, the query isn't prepared at all.
+ * ifxBeginForeignScan() will do this later.
+ *
+ * If widths is not NULL, the column widths reported by the Informix
+ * server are returned there, indexed by attribute number. They are
+ * cached along with the estimates, so the statement is only DESCRIBEd
+ * when the estimates are retrieved from the server. *widths is set to
+ * NULL if they aren't known, otherwise it is palloc'ed and owned by the
+ * caller.
  */
 static void ifxPrepareScan(IfxConnectionInfo *coninfo,
-						   IfxFdwExecutionState *state)
+						   IfxFdwExecutionState *state,
+						   Oid foreignTableOid,
+						   int **widths)
 {
+	char *shape = NULL;
+	int   natts = 0;
+
+	if (widths != NULL)
+		*widths = NULL;
+
 	/*
 	 * Prepare parameters of the state structure
 	 * for scan later.
 	 */
 	ifxPrepareParamsForScan(state, coninfo);
 
+	/*
+	 * FOR UPDATE cursors are reused by the modify action,
+	 * so they must be prepared now.
+	 */
+	if ((coninfo->estimate_cache_ttl > 0)
+		&& (state->stmt_info.cursorUsage != IFX_UPDATE_CURSOR))
+	{
+		IfxCachedEstimate *estimate;
+
+		shape    = ifxQueryShape(state->stmt_info.query);
+		estimate = ifxFTCache_getEstimate(foreignTableOid, shape);
+
+		if (estimate != NULL)
+		{
+			elog(DEBUG2, "informix_fdw: using cached estimates for \"%s\"",
+				 shape);
+
+			coninfo->planData.estimated_rows = estimate->estimated_rows;
+			coninfo->planData.costs          = estimate->costs;
+
+			/*
+			 * The cached array is owned by the cache, the
+			 * caller gets its own copy.
+			 */
+			if ((widths != NULL) && (estimate->widths != NULL))
+			{
+				*widths = (int *) palloc((estimate->natts + 1) * sizeof(int));
+				memcpy(*widths, estimate->widths,
+					   (estimate->natts + 1) * sizeof(int));
+			}
+
+			/*
+			 * We need valid identifiers to serialize the
+			 * execution state.
+			 */
+			state->stmt_info.stmt_name   = ifxGenStatementName(state->stmt_info.refid);
+			state->stmt_info.descr_name  = ifxGenDescrName(state->stmt_info.refid);
+			state->stmt_info.cursor_name = ifxGenCursorName(state->stmt_info.refid);
+			return;
+		}
+	}
+
 	/* Finally do the cursor preparation */
-	ifxPrepareCursorForScan(&state->stmt_info, coninfo);
+	ifxPrepareCachedCursorForScan(&state->stmt_info, coninfo);
+
+	if (widths != NULL)
+		*widths = ifxDescribeColumnWidths(foreignTableOid,
+										  &state->stmt_info,
+										  &natts);
+
+	if (shape != NULL)
+		ifxFTCache_putEstimate(ifxFTCache_add(foreignTableOid, coninfo->conname),
+							   shape,
+							   coninfo->planData.estimated_rows,
+							   coninfo->planData.costs,
+							   (widths != NULL) ? *widths : NULL,
+							   natts,
+							   coninfo->estimate_cache_ttl);
 }
 
 /*
@@ -2648,6 +4018,239 @@ static void ifxSetupFdwScan(IfxConnectionInfo **coninfo,
 	}
 }
 
+/*
+ * Setup a foreign scan planned from local statistics, see
+ * the use_remote_estimate option. Like ifxSetupFdwScan(), but
+ * doesn't contact the Informix server at all. The execution state
+ * gets no statement reference id, ifxBeginForeignScan() establishes
+ * the connection and assigns one later.
+ */
+static void ifxSetupLocalFdwScan(IfxConnectionInfo     *coninfo,
+								 IfxFdwExecutionState **state,
+								 List                 **plan_values)
+{
+	*plan_values = NIL;
+	*state       = makeIfxFdwExecutionState(-1);
+
+	/*
+	 * No ROWID for foreign tables based on a query or
+	 * if disabled by the disable_rowid option.
+	 */
+	(*state)->use_rowid = ((coninfo->query == NULL)
+						   && !coninfo->disable_rowid);
+}
+
+/*
+ * Estimates the size of a foreign scan from local statistics
+ * gathered by ANALYZE. The number of rows is derived from reltuples
+ * of the foreign table and the selectivity of all its restriction
+ * clauses, regardless wether they are pushed down or evaluated locally.
+ * The results are stored in coninfo->planData.
+ */
+static void ifxEstimateLocalRelSize(PlannerInfo       *root,
+									RelOptInfo        *baserel,
+									IfxConnectionInfo *coninfo)
+{
+	/*
+	 * If the foreign table was never analyzed, assume it has
+	 * 10 pages with tuples of 100 bytes, similar to postgres_fdw.
+	 */
+	if ((baserel->pages == 0) && (baserel->tuples <= 0))
+	{
+		baserel->pages  = 10;
+		baserel->tuples = (10 * BLCKSZ) / 100;
+	}
+
+	set_baserel_size_estimates(root, baserel);
+
+	/*
+	 * The Informix server has to read the whole table
+	 * in the worst case.
+	 */
+	coninfo->planData.estimated_rows = baserel->rows;
+	coninfo->planData.costs          = (seq_page_cost * baserel->pages)
+		+ (cpu_tuple_cost * baserel->tuples);
+
+	elog(DEBUG2, "informix_fdw: local estimates rows %.0f, costs %.2f",
+		 coninfo->planData.estimated_rows, coninfo->planData.costs);
+}
+
+/*
+ * Calculates the startup and total costs of a foreign scan from
+ * the estimates in coninfo->planData. If informix_costs is true, the
+ * costs were reported by the Informix server and are converted into
+ * PostgreSQL cost units by remote_cost_factor. On top of that, each
+ * remote query pays fdw_startup_cost for the round trip to the Informix
+ * server and each row fdw_tuple_cost for its transfer.
+ */
+static void ifxCalculateScanCosts(IfxConnectionInfo *coninfo,
+								  bool informix_costs)
+{
+	IfxPlanData *planData = &coninfo->planData;
+
+	planData->remote_costs = planData->costs;
+
+	if (informix_costs)
+		planData->remote_costs *= coninfo->remote_cost_factor;
+
+	planData->startup_costs = coninfo->fdw_startup_cost;
+	planData->total_costs   = planData->startup_costs
+		+ planData->remote_costs
+		+ (planData->estimated_rows * (coninfo->fdw_tuple_cost + cpu_tuple_cost));
+}
+
+/*
+ * Blends the row estimate in coninfo->planData with the number of
+ * rows actually returned by former scans of the foreign table with a
+ * query of the same shape. The more scans were observed, the more the
+ * feedback outweighs the estimate.
+ */
+static void ifxApplyRowFeedback(Oid                   foreignTableOid,
+								IfxConnectionInfo    *coninfo,
+								IfxFdwExecutionState *state)
+{
+	IfxRowFeedback *feedback;
+	double          weight;
+
+	feedback = ifxFTCache_getFeedback(foreignTableOid,
+									  ifxQueryShape(state->stmt_info.query));
+
+	if (feedback == NULL)
+		return;
+
+	weight = (double) feedback->nsamples / (feedback->nsamples + 1);
+
+	elog(DEBUG2, "informix_fdw: row estimate %.0f, feedback %.0f rows from %d scans",
+		 coninfo->planData.estimated_rows, feedback->rows, feedback->nsamples);
+
+	coninfo->planData.estimated_rows
+		= clamp_row_est((weight * feedback->rows)
+						+ ((1.0 - weight) * coninfo->planData.estimated_rows));
+}
+
+/*
+ * Records the number of rows returned by a completed foreign
+ * scan, see ifxApplyRowFeedback().
+ */
+static void ifxRecordRowFeedback(Oid                   foreignTableOid,
+								 IfxFdwExecutionState *state)
+{
+	IfxFTCacheItem *item;
+
+	item = ifxFTCache_add(foreignTableOid, state->stmt_info.conname);
+	ifxFTCache_putFeedback(item,
+						   ifxQueryShape(state->stmt_info.query),
+						   state->rows_fetched);
+
+	elog(DEBUG2, "informix_fdw: scan returned %.0f rows",
+		 state->rows_fetched);
+}
+
+/*
+ * Returns the widths of the columns of the specified foreign table
+ * as reported by the Informix server, indexed by attribute number.
+ * Dropped attributes have a width of 0. The number of attributes is
+ * stored in *natts. The statement must be prepared, otherwise NULL
+ * is returned. The descriptor is released immediately,
+ * ifxBeginForeignScan() will describe the statement again.
+ */
+static int *ifxDescribeColumnWidths(Oid               foreignTableOid,
+									IfxStatementInfo *info,
+									int              *natts)
+{
+	Relation  rel;
+	TupleDesc tupdesc;
+	int      *widths;
+	int       ifxAttrCount;
+	int       ifx_attnum;
+	int       i;
+
+	if ((info->call_stack & IFX_STACK_PREPARE) != IFX_STACK_PREPARE)
+		return NULL;
+
+	ifxDescribeAllocatorByName(info);
+	ifxCatchExceptions(info, IFX_STACK_ALLOCATE | IFX_STACK_DESCRIBE);
+	ifxAttrCount = ifxDescriptorColumnCount(info);
+
+	/*
+	 * Map the remote columns to the local attributes,
+	 * skipping dropped ones.
+	 */
+	rel     = heap_open(foreignTableOid, NoLock);
+	tupdesc = RelationGetDescr(rel);
+	*natts  = tupdesc->natts;
+	widths  = (int *) palloc0((*natts + 1) * sizeof(int));
+
+	ifx_attnum = 0;
+	for (i = 0; (i < *natts) && (ifx_attnum < ifxAttrCount); i++)
+	{
+		if (TUPDESC_GET_ATTR(tupdesc, i)->attisdropped)
+			continue;
+
+		widths[i + 1] = ifxDescriptorColumnWidth(info, ifx_attnum++);
+	}
+
+	heap_close(rel, NoLock);
+
+	ifxDeallocateSQLDA(info);
+	ifxPopCallstack(info, IFX_STACK_ALLOCATE | IFX_STACK_DESCRIBE);
+
+	return widths;
+}
+
+/*
+ * Sets the width of the rows returned by a foreign scan from the
+ * column widths returned by ifxPrepareScan(). If they aren't known,
+ * the width estimated by the planner is kept.
+ */
+static void ifxSetRemoteRelWidth(RelOptInfo *baserel,
+								 int        *widths)
+{
+	int       natts = baserel->max_attr;
+	int       width;
+	int       i;
+	ListCell *cell;
+
+	if (widths == NULL)
+		return;
+
+	/*
+	 * Sum up the widths of all columns required
+	 * from this relation.
+	 */
+	width = 0;
+#if PG_VERSION_NUM >= 90600
+	foreach(cell, baserel->reltarget->exprs)
+#else
+	foreach(cell, baserel->reltargetlist)
+#endif
+	{
+		Var *var = (Var *) lfirst(cell);
+
+		if (!IsA(var, Var) || (var->varno != baserel->relid))
+			continue;
+
+		if (var->varattno == InvalidAttrNumber)
+		{
+			/* whole row reference */
+			for (i = 1; i <= natts; i++)
+				width += widths[i];
+		}
+		else if ((var->varattno > 0) && (var->varattno <= natts))
+			width += widths[var->varattno];
+	}
+
+	elog(DEBUG2, "informix_fdw: remote row width %d", width);
+
+#if PG_VERSION_NUM >= 90600
+	baserel->reltarget->width = width;
+#else
+	baserel->width = width;
+#endif
+
+	pfree(widths);
+}
+
 /*
  * Returns a fully initialized pointer to
  * an IfxFdwExecutionState structure. All pointers
@@ -2666,6 +4269,7 @@ static IfxFdwExecutionState *makeIfxFdwExecutionState(int refid)
 	state->pgAttrDefs  = NULL;
 	state->values = NULL;
 	state->rescan = false;
+	state->open_pending = false;
 	state->affectedAttrNums = NIL;
 
 	/*
@@ -2686,6 +4290,35 @@ static IfxFdwExecutionState *makeIfxFdwExecutionState(int refid)
 	 */
 	state->has_after_row_triggers = false;
 
+	/* Only used by direct modify actions */
+	state->affected_rows = -1;
+
+	/* Only used by foreign scans */
+	state->rows_fetched  = 0;
+	state->scan_complete = false;
+
+	/* Only used by batched modify actions */
+	state->batch_size    = 0;
+	state->rows_buffered = 0;
+	state->batch_rowids  = NULL;
+	state->batch_values  = NULL;
+	state->batch_nulls   = NULL;
+
+	/* Only used by INSERT ... RETURNING */
+	state->insert_returning = false;
+
+	/* Only used by foreign scans with query parameters */
+	state->param_exprs = NIL;
+	state->nparams     = 0;
+	state->params      = NULL;
+
+	/* Only used by foreign scans with key sets */
+	state->keyset_names   = NIL;
+	state->keyset_columns = NIL;
+	state->keyset_exprs   = NIL;
+	state->keyset_start   = 0;
+	state->keyset_end     = 0;
+
 	return state;
 }
 
@@ -2716,6 +4349,12 @@ ifxAnalyzeForeignTable(Relation relation, AcquireSampleRowsFunc *func,
 	is_table     = false;
 	*totalpages  = 1;
 
+	/*
+	 * Cached plan-time estimates of this foreign table
+	 * are likely outdated now.
+	 */
+	ifxFTCache_invalidate(RelationGetRelid(relation));
+
 	foreach(elem, foreignTable->options)
 	{
 		DefElem *def = (DefElem *) lfirst(elem);
@@ -2859,10 +4498,89 @@ ifxAnalyzeForeignTable(Relation relation, AcquireSampleRowsFunc *func,
 		elog(DEBUG1, "totalpages = %d", *totalpages);
 	}
 
-	*func = ifxAcquireSampleRows;
+	/*
+	 * With import_statistics, column statistics are
+	 * taken from the Informix system catalog instead of
+	 * sampling the remote table.
+	 */
+	if (coninfo->import_statistics)
+		*func = ifxImportColumnStats;
+	else
+		*func = ifxAcquireSampleRows;
+
 	return true;
 }
 
+/*
+ * Determines the modulo of the ROWID predicate used to sample
+ * the remote table for ANALYZE, see the analyze_sampling option.
+ * Every modulo-th row is fetched from the Informix server, so that
+ * according to systables.nrows still at least targrows rows are
+ * returned. The modulo is odd, since a ROWID is made up of the page
+ * number and the slot within the page, thus the sample is spread
+ * over all slots. The predicate is stored in the execution state,
+ * starting at a random offset.
+ *
+ * remote_rows is set to the number of rows recorded in systables,
+ * -1 if they weren't looked up.
+ *
+ * Returns 1 if the remote table is to be scanned completely.
+ */
+static int ifxAnalyzeSampleModulo(IfxConnectionInfo    *coninfo,
+								  IfxFdwExecutionState *state,
+								  int                   targrows,
+								  double               *remote_rows)
+{
+	IfxPlanData    planData;
+	StringInfoData buf;
+	int            modulo;
+
+	*remote_rows = -1;
+
+	/*
+	 * A sampling predicate needs the ROWID and is
+	 * subject to predicate pushdown.
+	 */
+	if (!coninfo->analyze_sampling
+		|| !state->use_rowid
+		|| !coninfo->predicate_pushdown
+		|| (targrows <= 0))
+		return 1;
+
+	ifxGetSystableStats(coninfo->tablename, &planData);
+
+	if (ifxSetException(&(state->stmt_info)) != IFX_SUCCESS)
+	{
+		elog(DEBUG1, "informix_fdw: no remote stats for sampling table \"%s\"",
+			 coninfo->tablename);
+		return 1;
+	}
+
+	*remote_rows = planData.nrows;
+
+	if ((planData.nrows / targrows) >= INT_MAX)
+		modulo = INT_MAX;
+	else
+		modulo = (int) (planData.nrows / targrows);
+
+	if ((modulo % 2) == 0)
+		modulo--;
+
+	/* not worth the effort */
+	if (modulo < 3)
+		return 1;
+
+	initStringInfo(&buf);
+	appendStringInfo(&buf, "MOD(ROWID, %d) = %d", modulo,
+					 (int) (modulo * anl_random_fract()) % modulo);
+	state->stmt_info.predicate = buf.data;
+
+	elog(DEBUG2, "informix_fdw: sampling %.0f remote rows with \"%s\"",
+		 planData.nrows, state->stmt_info.predicate);
+
+	return modulo;
+}
+
 /*
  * Internal function for ANALYZE callback
  *
@@ -2883,6 +4601,10 @@ ifxAcquireSampleRows(Relation relation, int elevel, HeapTuple *rows,
 	bool                 *nulls;
 	int                   rows_visited;
 	int                   rows_to_skip;
+	int                   sample_modulo;
+	int                   oldBufSize;
+	double                rows_fetched;
+	double                remote_rows;
 
 	elog(DEBUG1, "informix_fdw: analyze");
 
@@ -2893,6 +4615,7 @@ ifxAcquireSampleRows(Relation relation, int elevel, HeapTuple *rows,
 	*totaldeadrows = 0;
 	rows_visited   = 0;
 	rows_to_skip   = -1; /* not set yet */
+	rows_fetched   = 0;
 	foreignTableId = RelationGetRelid(relation);
 
 	/*
@@ -2921,10 +4644,20 @@ ifxAcquireSampleRows(Relation relation, int elevel, HeapTuple *rows,
 	 * code with ifxBeginForeignScan()!!!
 	 */
 
+	/*
+	 * Let the Informix server do the sampling, if the
+	 * remote table is large enough.
+	 */
+	sample_modulo = ifxAnalyzeSampleModulo(coninfo, state, targrows,
+										   &remote_rows);
+
 	/*
 	 * Prepare the scan. This creates a cursor we can use to
+	 * sample the remote table. Don't use the statement cache
+	 * for this one-off scan.
 	 */
-	ifxPrepareScan(coninfo, state);
+	ifxPrepareParamsForScan(state, coninfo);
+	ifxPrepareCursorForScan(&state->stmt_info, coninfo);
 
 	/*
 	 * Get column definitions for local table...
@@ -2997,11 +4730,14 @@ ifxAcquireSampleRows(Relation relation, int elevel, HeapTuple *rows,
 	ifxSetupDataBufferAligned(&state->stmt_info);
 
 	/*
-	 * Open the cursor.
+	 * Open the cursor. Use a large fetch buffer, so that
+	 * the rows are transferred in batches.
 	 */
 	elog(DEBUG1, "open cursor \"%s\"",
 		 state->stmt_info.cursor_name);
+	oldBufSize = ifxSetFetchBufferSize(IFX_ANALYZE_FETCH_BUFFER_SIZE);
 	ifxOpenCursorForPrepared(&state->stmt_info);
+	ifxSetFetchBufferSize(oldBufSize);
 	ifxCatchExceptions(&state->stmt_info, IFX_STACK_OPEN);
 
 	/*
@@ -3041,7 +4777,7 @@ ifxAcquireSampleRows(Relation relation, int elevel, HeapTuple *rows,
 	{
 		int i;
 
-		*totalrows += 1;
+		rows_fetched += 1;
 
 		/*
 		 * Allow delay...
@@ -3111,7 +4847,7 @@ ifxAcquireSampleRows(Relation relation, int elevel, HeapTuple *rows,
 			 */
 
 			if (rows_to_skip < 0)
-				rows_to_skip = anl_get_next_S(*totalrows, targrows, &anl_state);
+				rows_to_skip = anl_get_next_S(rows_fetched, targrows, &anl_state);
 
 			if (rows_to_skip <= 0)
 			{
@@ -3142,6 +4878,19 @@ ifxAcquireSampleRows(Relation relation, int elevel, HeapTuple *rows,
 	/* Done, cleanup ... */
 	ifxRewindCallstack(&state->stmt_info);
 
+	/*
+	 * A full scan counted the rows of the remote table. Otherwise
+	 * take the number of rows from systables, extrapolating them from
+	 * the sample is skewed by sparse or fragmented ROWIDs. The sample
+	 * is used as a fallback only.
+	 */
+	if (sample_modulo == 1)
+		*totalrows = rows_fetched;
+	else if (remote_rows > 0)
+		*totalrows = remote_rows;
+	else
+		*totalrows = rows_fetched * sample_modulo;
+
 	ereport(elevel,
 			(errmsg("\"%s\": remote Informix table contains %.0f rows; "
 					"%d rows in sample",
@@ -3152,43 +4901,371 @@ ifxAcquireSampleRows(Relation relation, int elevel, HeapTuple *rows,
 }
 
 /*
- * Get the foreign informix relation estimates. This function
- * is also responsible to setup the informix database connection
- * and create a corresponding cached connection, if not already
- * done.
+ * ANALYZE callback used with the import_statistics option.
+ *
+ * Translates the statistics kept by Informix in syscolumns and
+ * sysindexes into pg_statistic entries of the foreign table, without
+ * fetching any rows. The number of rows is taken from systables.
+ * Returns no sample rows, so ANALYZE just updates reltuples and
+ * relpages and leaves pg_statistic to us.
  */
-static void ifxGetForeignRelSize(PlannerInfo *planInfo,
-								 RelOptInfo *baserel,
-								 Oid foreignTableId)
+static int
+ifxImportColumnStats(Relation relation, int elevel, HeapTuple *rows,
+					 int targrows, double *totalrows, double *totaldeadrows)
 {
+	Oid                   foreignTableId;
 	IfxConnectionInfo    *coninfo;
-	List                 *plan_values;
 	IfxFdwExecutionState *state;
-	IfxFdwPlanState      *planState;
+	List                 *plan_values;
+	IfxPlanData           planData;
+	TupleDesc             tupDesc;
+	int                   colno;
+	int                   ncols;
+	int                   i;
 
-	elog(DEBUG3, "informix_fdw: get foreign relation size, cmd %d",
-		planInfo->parse->commandType);
+	elog(DEBUG1, "informix_fdw: import statistics");
 
-	planState = palloc(sizeof(IfxFdwPlanState));
+	*totalrows     = 0;
+	*totaldeadrows = 0;
+	foreignTableId = RelationGetRelid(relation);
+	tupDesc        = RelationGetDescr(relation);
+	ncols          = 0;
 
-	/*
-	 * Establish remote informix connection or get
-	 * a already cached connection from the informix connection
-	 * cache.
-	 */
 	ifxSetupFdwScan(&coninfo, &state, &plan_values,
-					foreignTableId, IFX_PLAN_SCAN);
+					foreignTableId, IFX_BEGIN_SCAN);
+
+	ifxGetSystableStats(coninfo->tablename, &planData);
+
+	if (ifxSetException(&(state->stmt_info)) != IFX_SUCCESS)
+	{
+		ereport(elevel,
+				(errmsg("\"%s\": no statistics found for remote Informix table",
+						RelationGetRelationName(relation))));
+		return 0;
+	}
+
+	*totalrows = planData.nrows;
 
 	/*
-	 * Check wether this foreign table has AFTER EACH ROW
-	 * triggers attached. Currently this information is just
-	 * for completeness, since we always include all columns
-	 * in a foreign scan.
+	 * Local columns are mapped to the remote columns by
+	 * their position, see ifxPgColumnData().
 	 */
-	ifxCheckForAfterRowTriggers(foreignTableId,
-								state,
+	colno = 0;
+
+	for (i = 0; i < tupDesc->natts; i++)
+	{
+		Form_pg_attribute attr = TUPDESC_GET_ATTR(tupDesc, i);
+		IfxColumnStats    stats;
+		float4            stadistinct;
+		Datum             bounds[2];
+		int               nbounds;
+		Oid               ltopr;
+
+		if (attr->attisdropped)
+			continue;
+
+		colno++;
+
+		/* statistics disabled for this column */
+		if (attr->attstattarget == 0)
+			continue;
+
+		ifxGetColumnStats(coninfo->tablename, colno, &stats);
+
+		if (ifxSetException(&(state->stmt_info)) != IFX_SUCCESS)
+		{
+			elog(DEBUG1, "informix_fdw: no statistics for remote column %d of \"%s\"",
+				 colno, coninfo->tablename);
+			continue;
+		}
+
+		/*
+		 * n_distinct is stored as a negative fraction of the
+		 * number of rows, if it is likely to scale with the table.
+		 */
+		if (stats.unique)
+			stadistinct = -1.0;
+		else if ((stats.nunique > 0) && (planData.nrows > 0))
+		{
+			if (stats.nunique > 0.1 * planData.nrows)
+				stadistinct = (float4) -Min(stats.nunique / planData.nrows, 1.0);
+			else
+				stadistinct = (float4) stats.nunique;
+		}
+		else
+			stadistinct = 0.0;
+
+		/*
+		 * Informix keeps the second smallest and second largest value
+		 * of indexed numeric columns as INTEGER values, so we use them
+		 * for integer columns only. The actual minimum and maximum lie
+		 * beyond, so the range is widened by the average distance
+		 * between the distinct values to make up a histogram with a
+		 * single bucket. Without the number of distinct values there's
+		 * no histogram, since the planner would assume no rows outside
+		 * of its bounds.
+		 */
+		nbounds = 0;
+		ltopr   = InvalidOid;
+
+		if (stats.has_minmax && (stats.nunique > 3))
+		{
+			switch (stats.coltype)
+			{
+				case IFX_SMALLINT:
+				case IFX_INTEGER:
+				case IFX_SERIAL:
+				{
+					TypeCacheEntry *typentry;
+
+					typentry = lookup_type_cache(attr->atttypid,
+												 TYPECACHE_LT_OPR);
+					ltopr    = typentry->lt_opr;
+					break;
+				}
+				default:
+					/* colmin/colmax don't hold the column values */
+					break;
+			}
+		}
+
+		if (OidIsValid(ltopr))
+		{
+			int64 step;
+			int64 lower;
+			int64 upper;
+
+			/* nunique - 2 distinct values lie between colmin and colmax */
+			step  = Max(((int64) stats.colmax - stats.colmin)
+						/ (int64) (stats.nunique - 3), 1);
+			lower = (int64) stats.colmin - step;
+			upper = (int64) stats.colmax + step;
+
+			switch (attr->atttypid)
+			{
+				case INT2OID:
+					bounds[nbounds++] = Int16GetDatum((int16) Max(lower, SHRT_MIN));
+					bounds[nbounds++] = Int16GetDatum((int16) Min(upper, SHRT_MAX));
+					break;
+				case INT4OID:
+					bounds[nbounds++] = Int32GetDatum((int32) Max(lower, INT_MIN));
+					bounds[nbounds++] = Int32GetDatum((int32) Min(upper, INT_MAX));
+					break;
+				case INT8OID:
+					bounds[nbounds++] = Int64GetDatum(lower);
+					bounds[nbounds++] = Int64GetDatum(upper);
+					break;
+				default:
+					/* no integer column */
+					ltopr = InvalidOid;
+					break;
+			}
+		}
+
+		/* Nothing known about this column, keep its statistics */
+		if ((stadistinct == 0.0) && (nbounds == 0))
+			continue;
+
+		ifxStoreColumnStats(relation, attr, stats.notnull, stadistinct,
+							bounds, nbounds, ltopr);
+		ncols++;
+	}
+
+	ifxRewindCallstack(&state->stmt_info);
+
+	ereport(elevel,
+			(errmsg("\"%s\": remote Informix table contains %.0f rows; "
+					"imported statistics of %d columns",
+					RelationGetRelationName(relation),
+					*totalrows, ncols)));
+
+	return 0;
+}
+
+/*
+ * NULL fraction assumed for a column which might contain NULL
+ * values, the same the planner assumes without any statistics.
+ */
+#define IFX_UNKNOWN_NULLFRAC 0.005
+
+/*
+ * Stores the statistics of the specified column of a foreign
+ * table in pg_statistic, replacing any existing entry. This works
+ * like update_attstats() in src/backend/commands/analyze.c. If nbounds
+ * is greater than 0, bounds holds a histogram sorted by the operator
+ * ltopr.
+ *
+ * Informix doesn't record the number of NULL values. A column declared
+ * NOT NULL on the Informix server gets a NULL fraction of 0, otherwise
+ * the NULL fraction of an existing entry is kept, e.g. from a former
+ * ANALYZE fetching the rows. New entries get IFX_UNKNOWN_NULLFRAC then.
+ */
+static void ifxStoreColumnStats(Relation          relation,
+								Form_pg_attribute attr,
+								bool              notnull,
+								float4            stadistinct,
+								Datum            *bounds,
+								int               nbounds,
+								Oid               ltopr)
+{
+	Relation  sd;
+	HeapTuple stup;
+	HeapTuple oldtup;
+	Datum     values[Natts_pg_statistic];
+	bool      nulls[Natts_pg_statistic];
+	bool      replaces[Natts_pg_statistic];
+	int       i;
+
+	for (i = 0; i < Natts_pg_statistic; ++i)
+	{
+		values[i]   = (Datum) 0;
+		nulls[i]    = false;
+		replaces[i] = true;
+	}
+
+	values[Anum_pg_statistic_starelid - 1]    = ObjectIdGetDatum(RelationGetRelid(relation));
+	values[Anum_pg_statistic_staattnum - 1]   = Int16GetDatum(attr->attnum);
+	values[Anum_pg_statistic_stainherit - 1]  = BoolGetDatum(false);
+	values[Anum_pg_statistic_stanullfrac - 1] = Float4GetDatum(notnull ? 0.0 : IFX_UNKNOWN_NULLFRAC);
+	values[Anum_pg_statistic_stawidth - 1]    = Int32GetDatum(get_typavgwidth(attr->atttypid,
+																			   attr->atttypmod));
+	values[Anum_pg_statistic_stadistinct - 1] = Float4GetDatum(stadistinct);
+
+	for (i = 0; i < STATISTIC_NUM_SLOTS; i++)
+	{
+		values[Anum_pg_statistic_stakind1 - 1 + i] = Int16GetDatum(0);
+		values[Anum_pg_statistic_staop1 - 1 + i]   = ObjectIdGetDatum(InvalidOid);
+		nulls[Anum_pg_statistic_stanumbers1 - 1 + i] = true;
+		nulls[Anum_pg_statistic_stavalues1 - 1 + i]  = true;
+	}
+
+	if (nbounds > 0)
+	{
+		ArrayType *arry;
+		int16      typlen;
+		bool       typbyval;
+		char       typalign;
+
+		get_typlenbyvalalign(attr->atttypid, &typlen, &typbyval, &typalign);
+		arry = construct_array(bounds, nbounds, attr->atttypid,
+							   typlen, typbyval, typalign);
+
+		values[Anum_pg_statistic_stakind1 - 1]   = Int16GetDatum(STATISTIC_KIND_HISTOGRAM);
+		values[Anum_pg_statistic_staop1 - 1]     = ObjectIdGetDatum(ltopr);
+		values[Anum_pg_statistic_stavalues1 - 1] = PointerGetDatum(arry);
+		nulls[Anum_pg_statistic_stavalues1 - 1]  = false;
+	}
+
+	sd = heap_open(StatisticRelationId, RowExclusiveLock);
+
+	oldtup = SearchSysCache3(STATRELATTINH,
+							 ObjectIdGetDatum(RelationGetRelid(relation)),
+							 Int16GetDatum(attr->attnum),
+							 BoolGetDatum(false));
+
+	if (HeapTupleIsValid(oldtup))
+	{
+		if (!notnull)
+			replaces[Anum_pg_statistic_stanullfrac - 1] = false;
+
+		stup = heap_modify_tuple(oldtup, RelationGetDescr(sd),
+								 values, nulls, replaces);
+		ReleaseSysCache(oldtup);
+#if PG_VERSION_NUM >= 100000
+		CatalogTupleUpdate(sd, &stup->t_self, stup);
+#else
+		simple_heap_update(sd, &stup->t_self, stup);
+		CatalogUpdateIndexes(sd, stup);
+#endif
+	}
+	else
+	{
+		stup = heap_form_tuple(RelationGetDescr(sd), values, nulls);
+#if PG_VERSION_NUM >= 100000
+		CatalogTupleInsert(sd, stup);
+#else
+		simple_heap_insert(sd, stup);
+		CatalogUpdateIndexes(sd, stup);
+#endif
+	}
+
+	heap_freetuple(stup);
+	heap_close(sd, RowExclusiveLock);
+}
+
+/*
+ * Get the foreign informix relation estimates. This function
+ * is also responsible to setup the informix database connection
+ * and create a corresponding cached connection, if not already
+ * done.
+ */
+static void ifxGetForeignRelSize(PlannerInfo *planInfo,
+								 RelOptInfo *baserel,
+								 Oid foreignTableId)
+{
+	IfxConnectionInfo    *coninfo;
+	List                 *plan_values;
+	IfxFdwExecutionState *state;
+	IfxFdwPlanState      *planState;
+	bool                  use_remote;
+
+	elog(DEBUG3, "informix_fdw: get foreign relation size, cmd %d",
+		planInfo->parse->commandType);
+
+	planState = palloc0(sizeof(IfxFdwPlanState));
+	planState->foreignTableOid = foreignTableId;
+
+	/*
+	 * With use_remote_estimate disabled, a plain scan is planned
+	 * from local statistics only and the Informix server isn't
+	 * contacted before ifxBeginForeignScan(). UPDATE and DELETE still
+	 * need the FOR UPDATE cursor of the scan at plan time, see
+	 * ifxPlanForeignModify().
+	 */
+	coninfo      = ifxMakeConnectionInfo(foreignTableId);
+	use_remote   = (coninfo->use_remote_estimate
+					|| (planInfo->parse->commandType == CMD_UPDATE)
+					|| (planInfo->parse->commandType == CMD_DELETE));
+
+	if (use_remote)
+	{
+		/*
+		 * Establish remote informix connection or get
+		 * a already cached connection from the informix connection
+		 * cache.
+		 */
+		ifxSetupFdwScan(&coninfo, &state, &plan_values,
+						foreignTableId, IFX_PLAN_SCAN);
+	}
+	else
+		ifxSetupLocalFdwScan(coninfo, &state, &plan_values);
+
+	/*
+	 * Check wether this foreign table has AFTER EACH ROW
+	 * triggers attached. Currently this information is just
+	 * for completeness, since we always include all columns
+	 * in a foreign scan.
+	 */
+	ifxCheckForAfterRowTriggers(foreignTableId,
+								state,
 								planInfo->parse->commandType);
 
+#if PG_VERSION_NUM >= 90600
+	/*
+	 * Functions of these extensions are shippable, see
+	 * ifxRelShippableExtensions().
+	 */
+	planState->extensions = ifxExtractExtensionList(coninfo->extensions,
+													false);
+
+	/*
+	 * Remote indexes tell which sort orders the Informix server
+	 * can deliver cheaply, see ifxAddSortedPath(), and which
+	 * IN lists it can look up cheaply, see ifxPlanKeySets().
+	 */
+	ifxGetRemoteIndexes(foreignTableId, coninfo, planState, use_remote);
+#endif
+
 	/*
 	 * Check for predicates that can be pushed down
 	 * to the informix server, but skip it in case the user
@@ -3196,6 +5273,15 @@ static void ifxGetForeignRelSize(PlannerInfo *planInfo,
 	 */
 	if (coninfo->predicate_pushdown)
 	{
+		ListCell *cell;
+
+		/*
+		 * UPDATE and DELETE need the cursor of the scan prepared at
+		 * plan time, which isn't possible with key sets, see below.
+		 */
+		if (planInfo->parse->commandType == CMD_SELECT)
+			ifxPlanKeySets(planInfo, baserel, coninfo, planState);
+
 		/*
 		 * Also save a list of excluded RestrictInfo structures not carrying any
 		 * predicate found to be pushed down by ifxFilterQuals(). Those will
@@ -3203,8 +5289,21 @@ static void ifxGetForeignRelSize(PlannerInfo *planInfo,
 		 */
 		state->stmt_info.predicate = ifxFilterQuals(planInfo, baserel,
 													&(planState->excl_restrictInfo),
+													&(planState->param_exprs),
+													planState->extensions,
+													planState->keysets,
 													foreignTableId);
 		elog(DEBUG2, "predicate for pushdown: %s", state->stmt_info.predicate);
+
+		foreach(cell, planState->keysets)
+		{
+			IfxKeySet *keyset = (IfxKeySet *) lfirst(cell);
+
+			state->keyset_names   = lappend(state->keyset_names,
+											keyset->tablename);
+			state->keyset_columns = lappend(state->keyset_columns,
+											keyset->column);
+		}
 	}
 	else
 	{
@@ -3212,6 +5311,9 @@ static void ifxGetForeignRelSize(PlannerInfo *planInfo,
 		state->stmt_info.predicate = "";
 	}
 
+	state->stmt_info.directives = ifxOptimizerDirectives(coninfo,
+														 ifxWantsFirstRows(planInfo));
+
 	/*
 	 * Establish the remote query on the informix server. To do this,
 	 * we create the cursor, which will allow us to get the cost estimates
@@ -3238,21 +5340,48 @@ static void ifxGetForeignRelSize(PlannerInfo *planInfo,
 		state->stmt_info.cursorUsage = IFX_UPDATE_CURSOR;
 	}
 
-	ifxPrepareScan(coninfo, state);
-
 	/*
-	 * Now it should be possible to get the cost estimates
-	 * from the actual cursor.
+	 * The query can't be prepared before its key set tables exist.
+	 * They are created by ifxBeginForeignScan() only, so that planning
+	 * alone (e.g. EXPLAIN or a path not chosen) doesn't create them
+	 * on the Informix server. Such scans are planned like with
+	 * use_remote_estimate disabled.
 	 */
-	coninfo->planData.estimated_rows = (double) ifxGetSQLCAErrd(SQLCA_NROWS_PROCESSED);
-	coninfo->planData.costs          = (double) ifxGetSQLCAErrd(SQLCA_NROWS_WEIGHT);
+	if (planState->keysets != NIL)
+	{
+		use_remote = false;
+		state->stmt_info.refid = -1;
+	}
+
+	if (use_remote)
+	{
+		int *widths;
+
+		ifxPrepareScan(coninfo, state, foreignTableId, &widths);
+		ifxSetRemoteRelWidth(baserel, widths);
+	}
+	else
+	{
+		ifxPrepareParamsForScan(state, coninfo);
+		ifxEstimateLocalRelSize(planInfo, baserel, coninfo);
+
+		/*
+		 * The statement is prepared by ifxBeginForeignScan(), but we need
+		 * valid identifiers to serialize the execution state.
+		 */
+		state->stmt_info.stmt_name   = ifxGenStatementName(state->stmt_info.refid);
+		state->stmt_info.descr_name  = ifxGenDescrName(state->stmt_info.refid);
+		state->stmt_info.cursor_name = ifxGenCursorName(state->stmt_info.refid);
+	}
 
 	/*
-	 * Estimate total_cost in conjunction with the per-tuple cpu cost
-	 * for FETCHing each particular tuple later on.
+	 * The cost estimates reported for the prepared cursor (or
+	 * estimated locally) are now stored in coninfo->planData.
+	 * Correct the row estimate by the rows returned by former
+	 * scans with the same query.
 	 */
-	coninfo->planData.total_costs    = coninfo->planData.costs
-		+ (coninfo->planData.estimated_rows * cpu_tuple_cost);
+	ifxApplyRowFeedback(foreignTableId, coninfo, state);
+	ifxCalculateScanCosts(coninfo, use_remote);
 
 	/* should be calculated nrows from foreign table */
 	baserel->rows        = coninfo->planData.estimated_rows;
@@ -3290,7 +5419,7 @@ static void ifxGetForeignPaths(PlannerInfo *root,
 									 NULL,
 #endif
 									 baserel->rows,
-									 planState->coninfo->planData.costs,
+									 planState->coninfo->planData.startup_costs,
 									 planState->coninfo->planData.total_costs,
 									 NIL,
 									 NULL,
@@ -3298,6 +5427,20 @@ static void ifxGetForeignPaths(PlannerInfo *root,
 									 NULL,
 #endif
 									 NIL));
+
+#if PG_VERSION_NUM >= 90600
+	/*
+	 * Let the Informix server sort the result, if this
+	 * saves a local sort.
+	 */
+	ifxAddSortedPath(root, baserel, planState);
+
+	/*
+	 * Let small joined relations restrict the rows
+	 * fetched from the Informix server.
+	 */
+	ifxAddParameterizedPaths(root, baserel, planState);
+#endif
 }
 
 static ForeignScan *ifxGetForeignPlan(PlannerInfo *root,
@@ -3314,12 +5457,90 @@ static ForeignScan *ifxGetForeignPlan(PlannerInfo *root,
 	Index scan_relid;
 	IfxFdwPlanState  *planState;
 	List             *plan_values;
+	List             *fdw_exprs;
+	List             *join_params = NIL;
+	ListCell         *cell;
 
 	elog(DEBUG3, "informix_fdw: get foreign plan");
 
-	scan_relid = baserel->relid;
 	planState = (IfxFdwPlanState *) baserel->fdw_private;
 
+#if PG_VERSION_NUM >= 90600
+
+	/*
+	 * Grouping, aggregation or a join pushed down to the Informix server,
+	 * see ifxGetForeignUpperPaths() and ifxGetForeignJoinPaths(). There's
+	 * no scan relation in this case, the remote query returns the tuples
+	 * described by the scan target list.
+	 */
+	if (!IFX_IS_SIMPLE_REL(baserel))
+	{
+		IfxConnectionInfo    *coninfo;
+		IfxFdwExecutionState *state;
+		Relids                input_relids;
+
+		/*
+		 * Get a new statement reference id for the remote
+		 * query. Also makes the connection current.
+		 */
+		ifxSetupFdwScan(&coninfo, &state, &plan_values,
+						planState->foreignTableOid, IFX_PLAN_SCAN);
+		coninfo->planData = planState->coninfo->planData;
+
+		/* There's no ROWID for grouped or joined rows */
+		state->use_rowid = false;
+
+		if (IFX_IS_UPPER_REL(baserel))
+		{
+			ifxGenerateGroupedSql(state, coninfo, root,
+								  planState->outerrel,
+								  planState->scan_tlist,
+								  extract_actual_clauses(planState->outerrel->baserestrictinfo,
+														 false),
+								  planState->remote_conds);
+			input_relids = planState->outerrel->relids;
+		}
+		else
+		{
+			ifxGenerateJoinSql(state, root, baserel, planState->scan_tlist);
+			input_relids = baserel->relids;
+		}
+
+		StrNCpy(state->stmt_info.conname, coninfo->conname, IFX_CONNAME_LEN);
+
+		/*
+		 * The statement is prepared by ifxBeginForeignScan(), but we need
+		 * valid identifiers to serialize the execution state.
+		 */
+		state->stmt_info.stmt_name   = ifxGenStatementName(state->stmt_info.refid);
+		state->stmt_info.cursor_name = ifxGenCursorName(state->stmt_info.refid);
+
+		/*
+		 * The cursors declared by ifxGetForeignRelSize() for the foreign
+		 * tables involved are superseded by the remote query, so don't
+		 * leave them behind on the Informix server.
+		 */
+		ifxDisposeBaseRelCursors(root, input_relids);
+
+		elog(DEBUG2, "informix_fdw: pushed down query \"%s\"",
+			 state->stmt_info.query);
+
+		plan_values = ifxSerializePlanData(coninfo, state, root);
+
+		return make_foreignscan(tlist,
+								planState->local_conds,
+								0,
+								NIL,
+								plan_values,
+								planState->scan_tlist,
+								NIL,
+								outer_plan);
+	}
+
+#endif
+
+	scan_relid = baserel->relid;
+
 	/*
 	 * In case we are allowed to push down query predicates, ifxFilterQuals()
 	 * would have filtered out all remote scan clauses and we need to
@@ -3334,6 +5555,26 @@ static ForeignScan *ifxGetForeignPlan(PlannerInfo *root,
 	else
 		scan_clauses = extract_actual_clauses(scan_clauses, false);
 
+#if PG_VERSION_NUM >= 90600
+	if (best_path->path.pathkeys != NIL)
+		ifxPlanSortedScan(root, baserel, planState,
+						  best_path->path.pathkeys);
+
+	/*
+	 * The join clauses of a parameterized scan aren't part of the
+	 * restriction clauses. Those sent to the Informix server are
+	 * checked locally again, like other query parameters.
+	 */
+	if (best_path->path.param_info != NULL)
+	{
+		join_params  = ifxPlanParameterizedScan(baserel, planState,
+												best_path->path.param_info);
+		scan_clauses = list_concat(scan_clauses,
+								   extract_actual_clauses(best_path->path.param_info->ppi_clauses,
+														  false));
+	}
+#endif
+
 	/*
 	 * Serialize current plan data into a format suitable
 	 * for copyObject() later. This is required to be able to
@@ -3344,10 +5585,21 @@ static ForeignScan *ifxGetForeignPlan(PlannerInfo *root,
 									   planState->state,
 									   root);
 
+	/*
+	 * The values of the join clauses of a parameterized scan
+	 * follow the query parameters, the arrays of the key sets
+	 * come last, see ifxInitScanParams().
+	 */
+	fdw_exprs = list_copy(planState->param_exprs);
+	fdw_exprs = list_concat(fdw_exprs, join_params);
+
+	foreach(cell, planState->keysets)
+		fdw_exprs = lappend(fdw_exprs, ((IfxKeySet *) lfirst(cell))->keys);
+
 	return make_foreignscan(tlist,
 							scan_clauses,
 							scan_relid,
-							NIL,
+							fdw_exprs,
 							plan_values
 #if PG_VERSION_NUM >= 90500
 							,NIL
@@ -3357,1044 +5609,3494 @@ static ForeignScan *ifxGetForeignPlan(PlannerInfo *root,
 		);
 }
 
-#else
+#if PG_VERSION_NUM >= 90600
 
 /*
- * ifxPlanForeignScan
- *
- * Plans a foreign scan on an remote informix relation.
+ * Releases the cursors declared by ifxGetForeignRelSize() for the
+ * specified base relations.
  */
-static FdwPlan *
-ifxPlanForeignScan(Oid foreignTableOid, PlannerInfo *planInfo, RelOptInfo *baserel)
+static void ifxDisposeBaseRelCursors(PlannerInfo *root, Relids relids)
 {
-	IfxConnectionInfo    *coninfo;
-	FdwPlan              *plan;
-	List                 *plan_values;
-	IfxFdwExecutionState *state;
-	List                 *excl_restrictInfo;
+	int relid = -1;
 
-	elog(DEBUG3, "informix_fdw: plan scan");
+	while ((relid = bms_next_member(relids, relid)) >= 0)
+	{
+		RelOptInfo      *rel = find_base_rel(root, relid);
+		IfxFdwPlanState *planState = (IfxFdwPlanState *) rel->fdw_private;
 
-	/*
-	 * Prepare a generic plan structure
-	 */
-	plan = makeNode(FdwPlan);
+		if ((planState != NULL) && (planState->state != NULL))
+			ifxRewindCallstack(&planState->state->stmt_info);
+	}
+}
 
-	/*
-	 * Establish remote informix connection or get
-	 * a already cached connection from the informix connection
-	 * cache.
-	 */
-	ifxSetupFdwScan(&coninfo, &state, &plan_values,
-					foreignTableOid, IFX_PLAN_SCAN);
+/*
+ * Retrieves the indexes of the remote table of a simple foreign
+ * table scan, either from the foreign table cache or, if connected,
+ * from the Informix server. The column numbers of the index parts are
+ * mapped to attribute numbers of the foreign table by their position,
+ * like ifxPgColumnData() does. Index parts without a local column
+ * are cut off.
+ */
+static void ifxGetRemoteIndexes(Oid                foreignTableOid,
+								IfxConnectionInfo *coninfo,
+								IfxFdwPlanState   *planState,
+								bool               connected)
+{
+	IfxIndexDef *indexes;
+	int          nindexes;
 
-	/*
-	 * Check for predicates that can be pushed down
-	 * to the informix server, but skip it in case the user
-	 * has set the disable_predicate_pushdown option...
-	 */
-	if (coninfo->predicate_pushdown)
-	{
-		state->stmt_info.predicate = ifxFilterQuals(planInfo, baserel,
-													&excl_restrictInfo,
-													foreignTableOid);
-		elog(DEBUG2, "predicate for pushdown: %s", state->stmt_info.predicate);
-	}
-	else
+	nindexes = ifxFTCache_getIndexes(foreignTableOid, &indexes);
+
+	if ((nindexes < 0) && connected && (coninfo->tablename != NULL))
 	{
-		elog(DEBUG2, "predicate pushdown disabled");
-		state->stmt_info.predicate = "";
-	}
+		IfxIndexDef  defs[IFX_MAX_INDEX_DEFS];
+		AttrNumber  *attnums;
+		Relation     rel;
+		TupleDesc    tupdesc;
+		int          ncols;
+		int          i;
+
+		nindexes = ifxGetIndexDefs(coninfo->tablename, defs,
+								   IFX_MAX_INDEX_DEFS);
+
+		/* don't ask again until the cache is invalidated */
+		if (nindexes < 0)
+		{
+			elog(DEBUG1, "informix_fdw: could not retrieve indexes of table \"%s\"",
+				 coninfo->tablename);
+			nindexes = 0;
+		}
 
-	/*
-	 * Prepare parameters of the state structure
-	 * and cursor definition.
-	 */
-	ifxPrepareScan(coninfo, state);
+		rel     = heap_open(foreignTableOid, NoLock);
+		tupdesc = RelationGetDescr(rel);
+		attnums = (AttrNumber *) palloc(tupdesc->natts * sizeof(AttrNumber));
+		ncols   = 0;
 
-	/*
-	 * After declaring the cursor we are able to retrieve
-	 * row and cost estimates via SQLCA fields. Do that and save
-	 * them into the IfxPlanData structure member of
-	 * IfxConnectionInfo and, more important, assign the
-	 * values to our plan node.
-	 */
-	coninfo->planData.estimated_rows = (double) ifxGetSQLCAErrd(SQLCA_NROWS_PROCESSED);
-	coninfo->planData.costs          = (double) ifxGetSQLCAErrd(SQLCA_NROWS_WEIGHT);
-	baserel->rows = coninfo->planData.estimated_rows;
-	plan->startup_cost = 0.0;
-	plan->total_cost = coninfo->planData.costs + plan->startup_cost;
+		for (i = 0; i < tupdesc->natts; i++)
+		{
+			if (!TUPDESC_GET_ATTR(tupdesc, i)->attisdropped)
+				attnums[ncols++] = i + 1;
+		}
+
+		heap_close(rel, NoLock);
+
+		for (i = 0; i < nindexes; i++)
+		{
+			int j;
+
+			for (j = 0; j < defs[i].nparts; j++)
+			{
+				if (defs[i].parts[j] > ncols)
+					break;
+
+				defs[i].parts[j] = attnums[defs[i].parts[j] - 1];
+			}
+
+			/* what's left isn't unique anymore */
+			if (j < defs[i].nparts)
+				defs[i].unique = 0;
+
+			defs[i].nparts = j;
+		}
+
+		ifxFTCache_putIndexes(ifxFTCache_add(foreignTableOid, coninfo->conname),
+							  defs, nindexes);
+		nindexes = ifxFTCache_getIndexes(foreignTableOid, &indexes);
+	}
 
 	/*
-	 * Save parameters to our plan. We need to make sure they
-	 * are copyable by copyObject(), so use a list with
-	 * bytea const nodes.
-	 *
-	 * NOTE: we *must* not allocate serialized nodes within
-	 *       the current memory context, because this will crash
-	 *       on prepared statements and subsequent EXECUTE calls
-	 *       since they will be freed after. Instead, use the
-	 *       planner context, which will remain as long as
-	 *       the plan exists.
-	 *
+	 * Copy the cached definitions, the cache might be
+	 * invalidated during planning.
 	 */
-	plan_values = ifxSerializePlanData(coninfo, state, planInfo);
-	plan->fdw_private = plan_values;
+	planState->nindexes = 0;
+	planState->indexes  = NULL;
 
-	return plan;
+	if (nindexes > 0)
+	{
+		planState->indexes = (IfxIndexDef *) palloc(nindexes * sizeof(IfxIndexDef));
+		memcpy(planState->indexes, indexes, nindexes * sizeof(IfxIndexDef));
+		planState->nindexes = nindexes;
+	}
 }
 
-#endif
-
 /*
- * ifxPushCallstack()
- *
- * Updates the call stack with the new
- * stackentry.
+ * Adds a path for a foreign table scan sorted by the Informix server
+ * according to the pathkeys of the query, if it can sort by all of
+ * them. Sorting is considered cheap if the sort keys are the leading
+ * columns of an index of the remote table.
  */
-static inline void ifxPushCallstack(IfxStatementInfo *info,
-									unsigned short stackentry)
+static void ifxAddSortedPath(PlannerInfo     *root,
+							 RelOptInfo      *baserel,
+							 IfxFdwPlanState *planState)
 {
-	if (stackentry == 0)
+	List       *pathkeys = root->query_pathkeys;
+	AttrNumber  attnums[IFX_MAX_INDEX_PARTS];
+	int         nkeys;
+	Relation    rel;
+	ListCell   *cell;
+	bool        presorted;
+	Cost        startup_cost;
+	Cost        total_cost;
+	int         i;
+
+	/*
+	 * ORDER BY can't be appended to the query of a foreign table
+	 * defined by the query option, nor to a FOR UPDATE cursor.
+	 */
+	if ((pathkeys == NIL)
+		|| (baserel->reloptkind != RELOPT_BASEREL)
+		|| (planState->coninfo->query != NULL)
+		|| (planState->state->stmt_info.cursorUsage == IFX_UPDATE_CURSOR)
+		|| (list_length(pathkeys) > IFX_MAX_INDEX_PARTS))
 		return;
-	info->call_stack |= stackentry;
+
+	rel   = heap_open(planState->foreignTableOid, NoLock);
+	nkeys = 0;
+
+	foreach(cell, pathkeys)
+	{
+		PathKey *pathkey   = (PathKey *) lfirst(cell);
+		Var     *var       = ifxPathKeyVar(pathkey, baserel);
+		bool     ascending = (pathkey->pk_strategy == BTLessStrategyNumber);
+
+		if (var == NULL)
+			break;
+
+		/*
+		 * Informix sorts NULL values before all other values, other
+		 * NULL orderings are fine for NOT NULL columns only.
+		 */
+		if ((pathkey->pk_nulls_first != ascending)
+			&& !TUPDESC_GET_ATTR(RelationGetDescr(rel), var->varattno - 1)->attnotnull)
+			break;
+
+		attnums[nkeys++] = var->varattno;
+	}
+
+	heap_close(rel, NoLock);
+
+	if (nkeys < list_length(pathkeys))
+		return;
+
+	presorted = false;
+
+	for (i = 0; (i < planState->nindexes) && !presorted; i++)
+	{
+		IfxIndexDef *index = &planState->indexes[i];
+		int          j;
+
+		if (index->nparts < nkeys)
+			continue;
+
+		for (j = 0; j < nkeys; j++)
+		{
+			if (index->parts[j] != attnums[j])
+				break;
+		}
+
+		presorted = (j == nkeys);
+	}
+
+	startup_cost = planState->coninfo->planData.startup_costs;
+	total_cost   = planState->coninfo->planData.total_costs;
+
+	if (presorted)
+	{
+		/* reading the rows in index order */
+		total_cost += baserel->rows * cpu_operator_cost;
+	}
+	else
+	{
+		startup_cost *= IFX_DEFAULT_FDW_SORT_MULTIPLIER;
+		total_cost   *= IFX_DEFAULT_FDW_SORT_MULTIPLIER;
+	}
+
+	elog(DEBUG2, "informix_fdw: sorted path with %d keys, presorted %d",
+		 nkeys, presorted);
+
+	add_path(baserel, (Path *)
+			 create_foreignscan_path(root, baserel,
+									 NULL,
+									 baserel->rows,
+									 startup_cost,
+									 total_cost,
+									 pathkeys,
+									 NULL,
+									 NULL,
+									 NIL));
 }
 
 /*
- * ifxPopCallstack()
- *
- * Sets the status of the call stack to the
- * given state.
+ * Appends the ORDER BY clause of a sorted foreign scan path to the
+ * remote query. The cursor declared for the unsorted query by
+ * ifxGetForeignRelSize() is released, the sorted query gets a new
+ * statement reference id and is prepared by ifxBeginForeignScan().
  */
-static inline void ifxPopCallstack(IfxStatementInfo *info,
-								   unsigned short stackentry)
+static void ifxPlanSortedScan(PlannerInfo     *root,
+							  RelOptInfo      *baserel,
+							  IfxFdwPlanState *planState,
+							  List            *pathkeys)
 {
-	info->call_stack &= ~stackentry;
+	IfxFdwExecutionState *state = planState->state;
+	StringInfoData        buf;
+
+	initStringInfo(&buf);
+	appendStringInfoString(&buf, state->stmt_info.query);
+	ifxGenerateOrderBySql(&buf, root, baserel, pathkeys);
+	state->stmt_info.query = buf.data;
+
+	elog(DEBUG2, "informix_fdw: sorted query \"%s\"",
+		 state->stmt_info.query);
+
+	ifxRenewScanStatement(planState);
 }
 
 /*
- * ifxRewindCallstack()
- *
- * Gets the call back and tries to free
- * all resources associated with the call stack
- * in the given state.
+ * Releases the cursor declared by ifxGetForeignRelSize() for a
+ * foreign scan whose query was changed afterwards. The changed query
+ * gets a new statement reference id and is prepared by
+ * ifxBeginForeignScan().
  */
-void ifxRewindCallstack(IfxStatementInfo *info)
+static void ifxRenewScanStatement(IfxFdwPlanState *planState)
 {
+	IfxFdwExecutionState *state = planState->state;
+	IfxConnectionInfo    *coninfo;
+	IfxCachedConnection  *cached;
+
 	/*
-	 * NOTE: IFX_STACK_DESCRIBE doesn't need any special handling here,
-	 * so just ignore it until the end of rewinding the call stack
-	 * and set it to IFX_STACK_EMPTY if everything else is undone.
+	 * A scan planned from local statistics doesn't have a
+	 * statement reference id yet, see use_remote_estimate.
 	 */
+	if (state->stmt_info.refid < 0)
+		return;
 
-	if ((info->call_stack & IFX_STACK_OPEN) == IFX_STACK_OPEN)
-	{
-		ifxCloseCursor(info);
-		elog(DEBUG2, "informix_fdw: undo open");
-		ifxPopCallstack(info, IFX_STACK_OPEN);
-	}
+	ifxRewindCallstack(&state->stmt_info);
 
-	if ((info->call_stack & IFX_STACK_ALLOCATE) == IFX_STACK_ALLOCATE)
+	cached = ifxSetupConnection(&coninfo, planState->foreignTableOid,
+								IFX_PLAN_SCAN, true);
+
+	state->stmt_info.refid       = cached->con.usage;
+	state->stmt_info.stmt_name   = ifxGenStatementName(state->stmt_info.refid);
+	state->stmt_info.descr_name  = ifxGenDescrName(state->stmt_info.refid);
+	state->stmt_info.cursor_name = ifxGenCursorName(state->stmt_info.refid);
+}
+
+/*
+ * Checks wether the expression of the equivalence member is the column
+ * of the foreign table passed in arg. Callback for
+ * generate_implied_equalities_for_column().
+ */
+static bool ifxEcMemberMatchesColumn(PlannerInfo       *root,
+									 RelOptInfo        *rel,
+									 EquivalenceClass  *ec,
+									 EquivalenceMember *em,
+									 void              *arg)
+{
+	Var *var = (Var *) em->em_expr;
+
+	return (IsA(var, Var)
+			&& (var->varno == rel->relid)
+			&& (var->varlevelsup == 0)
+			&& (var->varattno == *((AttrNumber *) arg)));
+}
+
+/*
+ * Returns the join clauses of a foreign table a parameterized scan
+ * could send to the Informix server, see ifxIsJoinParamExpr(). These
+ * are the join clauses movable to the foreign table and the equalities
+ * implied by equivalence classes with its columns.
+ */
+static List *ifxGetJoinParamClauses(PlannerInfo *root,
+									RelOptInfo  *baserel)
+{
+	List      *clauses = NIL;
+	Bitmapset *attnums = NULL;
+	ListCell  *cell;
+	int        attnum;
+
+	foreach(cell, baserel->joininfo)
 	{
-		/*
-		 * Deallocating allocated memory by sqlda data structure
-		 * is going to be little tricky here: sqlda is allocated
-		 * by the Informix ESQL/C API, so we don't have any influence
-		 * via memory contexts...we aren't allowed to use pfree()!
-		 *
-		 * The memory area for SQL data values retrieved by any
-		 * FETCH from the underlying cursor is allocated by palloc(),
-		 * however. We don't free them immediately and leave this up
-		 * to memory context cleanup.
-		 */
-		ifxDeallocateSQLDA(info);
-		elog(DEBUG2, "informix_fdw: undo allocate");
-		ifxPopCallstack(info, IFX_STACK_ALLOCATE);
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(cell);
+		Var          *colref;
+		Node         *param;
+
+		if (join_clause_is_movable_to(rinfo, baserel)
+			&& ifxIsJoinParamExpr((Node *) rinfo->clause, baserel->relid,
+								  &colref, &param))
+			clauses = lappend(clauses, rinfo);
 	}
 
-	if ((info->call_stack & IFX_STACK_DECLARE) == IFX_STACK_DECLARE)
+	if (!baserel->has_eclass_joins)
+		return clauses;
+
+	/*
+	 * Collect the columns of the foreign table which are members
+	 * of equivalence classes spanning other relations, too.
+	 */
+	foreach(cell, root->eq_classes)
 	{
-		ifxFreeResource(info, IFX_STACK_DECLARE);
-		elog(DEBUG2, "informix_fdw: undo declare");
-		ifxPopCallstack(info, IFX_STACK_DECLARE);
+		EquivalenceClass *ec = (EquivalenceClass *) lfirst(cell);
+		ListCell         *em_cell;
+
+		if (ec->ec_has_volatile
+			|| !bms_is_member(baserel->relid, ec->ec_relids))
+			continue;
+
+		foreach(em_cell, ec->ec_members)
+		{
+			EquivalenceMember *em  = (EquivalenceMember *) lfirst(em_cell);
+			Var               *var = (Var *) em->em_expr;
+
+			if (IsA(var, Var)
+				&& (var->varno == baserel->relid)
+				&& (var->varlevelsup == 0)
+				&& (var->varattno > 0))
+				attnums = bms_add_member(attnums, var->varattno);
+		}
 	}
 
-	if ((info->call_stack & IFX_STACK_PREPARE) == IFX_STACK_PREPARE)
+	attnum = -1;
+	while ((attnum = bms_next_member(attnums, attnum)) >= 0)
 	{
-		ifxFreeResource(info, IFX_STACK_PREPARE);
-		elog(DEBUG2, "informix_fdw: undo prepare");
-		ifxPopCallstack(info, IFX_STACK_PREPARE);
+		AttrNumber  column = (AttrNumber) attnum;
+		List       *ec_clauses;
+
+		ec_clauses = generate_implied_equalities_for_column(root, baserel,
+															ifxEcMemberMatchesColumn,
+															(void *) &column,
+															baserel->lateral_referenced_relids);
+
+		foreach(cell, ec_clauses)
+		{
+			RestrictInfo *rinfo = (RestrictInfo *) lfirst(cell);
+			Var          *colref;
+			Node         *param;
+
+			if (ifxIsJoinParamExpr((Node *) rinfo->clause, baserel->relid,
+								   &colref, &param))
+				clauses = lappend(clauses, rinfo);
+		}
 	}
 
-	info->call_stack = IFX_STACK_EMPTY;
+	return clauses;
 }
 
 /*
- * Trap errors from the informix FDW API.
- *
- * This function checks exceptions from ESQL
- * and creates corresponding NOTICE, WARN or ERROR
- * messages.
- *
+ * Adds parameterized paths for a foreign table joined with a small
+ * relation, as configured by the join_filter_rows option. A nested
+ * loop passes the join keys of each outer row to the Informix server
+ * then, instead of fetching the whole remote table and joining it
+ * locally. This pays off if the join columns are the leading columns
+ * of an index of the remote table.
  */
-static IfxSqlStateClass ifxCatchExceptions(IfxStatementInfo *state,
-										   unsigned short stackentry)
+static void ifxAddParameterizedPaths(PlannerInfo     *root,
+									 RelOptInfo      *baserel,
+									 IfxFdwPlanState *planState)
 {
-	IfxSqlStateClass errclass;
+	IfxConnectionInfo *coninfo = planState->coninfo;
+	List              *outer_relids = NIL;
+	ListCell          *cell;
 
 	/*
-	 * Set last error, if any
+	 * Modify commands rely on the cursor declared by
+	 * ifxGetForeignRelSize().
 	 */
-	errclass = ifxSetException(state);
+	if ((coninfo->join_filter_rows <= 0)
+		|| !coninfo->predicate_pushdown
+		|| (root->parse->commandType != CMD_SELECT)
+		|| (baserel->reloptkind != RELOPT_BASEREL))
+		return;
 
-	if (errclass != IFX_SUCCESS)
+	foreach(cell, ifxGetJoinParamClauses(root, baserel))
 	{
+		RestrictInfo  *rinfo = (RestrictInfo *) lfirst(cell);
+		Relids         required_outer;
+		ParamPathInfo *param_info;
+		ListCell      *relids_cell;
+		ListCell      *clause_cell;
+		bool           indexed;
+		Cost           remote_cost;
+		Cost           total_cost;
+		int            relid;
+
+		required_outer = bms_union(rinfo->clause_relids,
+								   baserel->lateral_relids);
+		required_outer = bms_del_member(required_outer, baserel->relid);
+
 		/*
-		 * Obtain the error message. Since ifxRewindCallstack()
-		 * will release any associated resources before we can
-		 * print an ERROR message, we save the current from
-		 * the caller within an IfxSqlStateMessage structure.
+		 * Consider a single relation driving the
+		 * scan only, and only if it's small.
 		 */
-		IfxSqlStateMessage message;
-
-		elog(DEBUG1, "informix FDW exception count: %d",
-			 state->exception_count);
-
-		ifxGetSqlStateMessage(1, &message);
+		if (!bms_get_singleton_member(required_outer, &relid)
+			|| (find_base_rel(root, relid)->rows > coninfo->join_filter_rows))
+			continue;
 
-		switch (errclass)
+		foreach(relids_cell, outer_relids)
 		{
-			case IFX_RT_ERROR:
-				/*
-				 * log Informix runtime error.
-				 *
-				 * There's no ERRCODE_FDW_FATAL, so we go with a HV000 error
-				 * code for now, but print out the error message as ERROR.
-				 *
-				 * A runtime error normally means a SQL error. Formerly, we did
-				 * a FATAL here, but this stroke me as far to hard (it will exit
-				 * the backend). Go with an ERROR instead...
-				 */
-				ifxRewindCallstack(state);
-			case IFX_ERROR:
-			case IFX_ERROR_INVALID_NAME:
-				/* log ERROR */
-				ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
-								errmsg("informix FDW error: \"%s\"",
-									   message.text),
-								errdetail("SQLSTATE %s (SQLCODE=%d)",
-										  message.sqlstate, message.sqlcode)));
-				break;
-			case IFX_WARNING:
-				/* log WARN */
-				ereport(WARNING, (errcode(ERRCODE_FDW_ERROR),
-								  errmsg("informix FDW warning: \"%s\"",
-										 message.text),
-								  errdetail("SQLSTATE %s", message.sqlstate)));
-				break;
-			case IFX_ERROR_TABLE_NOT_FOUND:
-				/* log missing FDW table */
-				ereport(ERROR, (errcode(ERRCODE_FDW_TABLE_NOT_FOUND),
-								errmsg("informix FDW missing table: \"%s\"",
-									   message.text),
-								errdetail("SQLSTATE %s", message.sqlstate)));
-				break;
-			case IFX_NOT_FOUND:
-			default:
-				/* needs no log */
+			if (bms_equal((Relids) lfirst(relids_cell), required_outer))
 				break;
 		}
-	}
 
-	/*
-	 * IFX_SUCCESS
-	 */
-	ifxPushCallstack(state, stackentry);
+		/* already got a path for this relation */
+		if (relids_cell != NULL)
+			continue;
 
-	return errclass;
+		outer_relids = lappend(outer_relids, required_outer);
+		param_info   = get_baserel_parampathinfo(root, baserel, required_outer);
+
+		indexed = false;
+
+		foreach(clause_cell, param_info->ppi_clauses)
+		{
+			RestrictInfo *join_rinfo = (RestrictInfo *) lfirst(clause_cell);
+			Var          *colref;
+			Node         *param;
+			int           i;
+
+			if (!ifxIsJoinParamExpr((Node *) join_rinfo->clause, baserel->relid,
+									&colref, &param))
+				continue;
+
+			for (i = 0; i < planState->nindexes; i++)
+			{
+				if ((planState->indexes[i].nparts > 0)
+					&& (planState->indexes[i].parts[0] == colref->varattno))
+					indexed = true;
+			}
+		}
+
+		/*
+		 * Without an index, the Informix server reads the
+		 * whole table for each outer row.
+		 */
+		remote_cost = coninfo->planData.remote_costs;
+
+		if (indexed && (baserel->rows > 0))
+			remote_cost *= Min(1.0, param_info->ppi_rows / baserel->rows);
+
+		total_cost = coninfo->fdw_startup_cost
+			+ remote_cost
+			+ (param_info->ppi_rows * (coninfo->fdw_tuple_cost + cpu_tuple_cost));
+
+		elog(DEBUG2, "informix_fdw: parameterized path with %.0f rows, indexed %d",
+			 param_info->ppi_rows, indexed);
+
+		add_path(baserel, (Path *)
+				 create_foreignscan_path(root, baserel,
+										 NULL,
+										 param_info->ppi_rows,
+										 coninfo->fdw_startup_cost,
+										 total_cost,
+										 NIL,
+										 required_outer,
+										 NULL,
+										 NIL));
+	}
 }
 
 /*
- * Retrieve the local column definition of the
- * foreign table (attribute number, type and additional
- * options).
+ * Appends the join clauses of a parameterized foreign scan path to the
+ * predicate of the remote query, with their values of the outer rows
+ * passed as query parameters. Returns the expressions of these
+ * values, in the order of the parameters.
  */
-static void ifxPgColumnData(Oid foreignTableOid, IfxFdwExecutionState *festate)
+static List *ifxPlanParameterizedScan(RelOptInfo      *baserel,
+									  IfxFdwPlanState *planState,
+									  ParamPathInfo   *param_info)
 {
-	HeapTuple         tuple;
-	Relation          attrRel;
-	SysScanDesc       scan;
-	ScanKeyData       key[2];
-	Form_pg_attribute attrTuple;
-	Relation          foreignRel;
-	int               pgAttrIndex;
-	int               ifxAttrIndex;
+	IfxFdwExecutionState *state  = planState->state;
+	List                 *params = NIL;
+	ListCell             *cell;
+	StringInfoData        buf;
 
-	pgAttrIndex  = 0;
-	ifxAttrIndex = 0;
-	festate->pgDroppedAttrCount = 0;
+	initStringInfo(&buf);
 
-	/* open foreign table, should be locked already */
-	foreignRel = heap_open(foreignTableOid, NoLock);
-	festate->pgAttrCount = RelationGetNumberOfAttributes(foreignRel);
-	heap_close(foreignRel, NoLock);
+	if (state->stmt_info.predicate != NULL)
+		appendStringInfoString(&buf, state->stmt_info.predicate);
 
-	/*
-	 * Use IFX_PGATTRCOUNT to reflect extra space for retrieval of ROWID,
-	 * if necessary.
-	 */
-	festate->pgAttrDefs = palloc0fast(sizeof(PgAttrDef) * IFX_PGATTRCOUNT(festate));
+	foreach(cell, param_info->ppi_clauses)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(cell);
+		Var          *colref;
+		Node         *param;
+
+		/* evaluated locally only */
+		if (!ifxIsJoinParamExpr((Node *) rinfo->clause, baserel->relid,
+								&colref, &param))
+			continue;
+
+		if (buf.len > 0)
+			appendStringInfoString(&buf, " AND ");
+
+		appendStringInfo(&buf, "%s = ?",
+						 ifxDeparseColumnRef(planState->foreignTableOid,
+											 baserel->relid, colref));
+
+		params = lappend(params, param);
+	}
+
+	if (params == NIL)
+		return NIL;
 
 	/*
-	 * Get all attributes for the given foreign table.
+	 * Each scan returns the few rows matching
+	 * the current outer row.
 	 */
-	attrRel = heap_open(AttributeRelationId, AccessShareLock);
-	ScanKeyInit(&key[0], Anum_pg_attribute_attrelid,
-				BTEqualStrategyNumber, F_OIDEQ,
-				ObjectIdGetDatum(foreignTableOid));
-	ScanKeyInit(&key[1], Anum_pg_attribute_attnum,
-				BTGreaterStrategyNumber, F_INT2GT,
-				Int16GetDatum((int16)0));
-	scan = systable_beginscan(attrRel, AttributeRelidNumIndexId, true,
-							  IFX_SYSTABLE_SCAN_SNAPSHOT, 2, key);
+	state->stmt_info.predicate  = buf.data;
+	state->stmt_info.directives = ifxOptimizerDirectives(planState->coninfo,
+														 true);
+	ifxPrepareParamsForScan(state, planState->coninfo);
 
-	while (HeapTupleIsValid(tuple = systable_getnext(scan)))
+	elog(DEBUG2, "informix_fdw: parameterized query \"%s\"",
+		 state->stmt_info.query);
+
+	ifxRenewScanStatement(planState);
+
+	return params;
+}
+
+/*
+ * Adds all aggregates referenced by the specified expression
+ * to the target list of a remote grouped query. Returns false
+ * in case one of them can't be evaluated by the Informix server.
+ */
+static bool ifxAddAggregatesToTlist(PlannerInfo *root,
+									RelOptInfo  *outerrel,
+									Node        *expr,
+									List       **tlist)
+{
+	ListCell *cell;
+
+	foreach(cell, pull_var_clause(expr, PVC_INCLUDE_AGGREGATES))
 	{
-		attrTuple = (Form_pg_attribute) GETSTRUCT(tuple);
+		Expr *aggexpr = (Expr *) lfirst(cell);
 
 		/*
-		 * Current PostgreSQL attnum.
+		 * Plain column references outside of aggregates are either
+		 * grouping expressions or part of them, so they are
+		 * already part of the target list.
 		 */
-		++pgAttrIndex;
+		if (!IsA(aggexpr, Aggref))
+			continue;
 
-		/*
-		 * Ignore dropped columns.
-		 */
-		if (attrTuple->attisdropped)
+		if (!ifxIsShippableExpr(root, outerrel, (Node *) aggexpr))
+			return false;
+
+		*tlist = add_to_flat_tlist(*tlist, list_make1(aggexpr));
+	}
+
+	return true;
+}
+
+/*
+ * Checks wether the grouping and aggregation described by the
+ * specified grouping target can be evaluated by the Informix server.
+ *
+ * Builds the target list of the remote grouped query and sorts the
+ * HAVING expressions into those we push down and those we need
+ * to evaluate locally. Returns false in case anything prevents
+ * the pushdown.
+ */
+static bool ifxForeignGroupingOk(PlannerInfo     *root,
+								 PathTarget      *grouping_target,
+								 Node            *havingQual,
+								 IfxFdwPlanState *planState)
+{
+	Query      *query    = root->parse;
+	RelOptInfo *outerrel = planState->outerrel;
+	List       *tlist    = NIL;
+	ListCell   *cell;
+	int         i;
+
+	/* Grouping sets can't be pushed down */
+	if (query->groupingSets != NIL)
+		return false;
+
+	i = 0;
+	foreach(cell, grouping_target->exprs)
+	{
+		Expr  *expr  = (Expr *) lfirst(cell);
+		Index  sgref = get_pathtarget_sortgroupref(grouping_target, i);
+
+		i++;
+
+		if ((sgref != 0)
+			&& (get_sortgroupref_clause_noerr(sgref, query->groupClause) != NULL))
 		{
-			festate->pgAttrDefs[pgAttrIndex - 1].attnum = -1;
+			TargetEntry *tle;
 
 			/*
-			 * In case of dropped columns, we differ from the attribute
-			 * numbers used for Informix. Record them accordingly.
+			 * Grouping expressions must be evaluated remotely. Don't
+			 * bother with constants, Informix refuses to group by them.
 			 */
-			festate->pgAttrDefs[pgAttrIndex - 1].ifx_attnum = -1;
-			festate->pgAttrDefs[pgAttrIndex - 1].atttypid = -1;
-			festate->pgAttrDefs[pgAttrIndex - 1].atttypmod = -1;
-			festate->pgAttrDefs[pgAttrIndex - 1].attname = NULL;
-			festate->pgDroppedAttrCount++;
-			continue;
-		}
-
-		/*
-		 * Don't rely on pgAttrIndex directly.
-		 *
-		 * RelationGetNumberOfAttributes() always counts the number
-		 * of attributes *including* dropped columns.
-		 *
-		 * Increment ifxAttrIndex only in case we don't have
-		 * a dropped column. Otherwise we won't match the
-		 * Informix attribute list.
-		 */
-		++ifxAttrIndex;
+			if (IsA(expr, Const)
+				|| !ifxIsShippableExpr(root, outerrel, (Node *) expr))
+				return false;
 
-		/*
-		 * Protect against corrupted numbers in pg_class.relnatts
-		 * and number of attributes retrieved from pg_attribute.
-		 */
-		if (pgAttrIndex > festate->pgAttrCount)
+			tle = makeTargetEntry(expr, list_length(tlist) + 1, NULL, false);
+			tle->ressortgroupref = sgref;
+			tlist = lappend(tlist, tle);
+		}
+		else
 		{
-			systable_endscan(scan);
-			heap_close(attrRel, AccessShareLock);
-			elog(ERROR, "unexpected number of attributes in foreign table");
+			/*
+			 * Everything else is computed locally on top of the
+			 * aggregates returned by the remote query.
+			 */
+			if (!ifxAddAggregatesToTlist(root, outerrel, (Node *) expr, &tlist))
+				return false;
 		}
-
-		/*
-		 * Save the attribute and all required properties for
-		 * later usage.
-		 */
-		festate->pgAttrDefs[pgAttrIndex - 1].attnum = attrTuple->attnum;
-		festate->pgAttrDefs[pgAttrIndex - 1].ifx_attnum = ifxAttrIndex;
-		festate->pgAttrDefs[pgAttrIndex - 1].atttypid = attrTuple->atttypid;
-		festate->pgAttrDefs[pgAttrIndex - 1].atttypmod = attrTuple->atttypmod;
-		festate->pgAttrDefs[pgAttrIndex - 1].attname = pstrdup(NameStr(attrTuple->attname));
-		festate->pgAttrDefs[pgAttrIndex - 1].attnotnull = attrTuple->attnotnull;
-
-		elog(DEBUG5, "mapped attnum PG/IFX %d => %d",
-			 festate->pgAttrDefs[pgAttrIndex - 1].attnum,
-			 PG_MAPPED_IFX_ATTNUM(festate, pgAttrIndex - 1));
 	}
 
 	/*
-	 * Request information for the resjunk ROWID column.
+	 * Push down the HAVING expressions we are able to, the
+	 * aggregates referenced by the remaining ones must be fetched
+	 * from the remote query as well.
 	 */
-	if (festate->use_rowid)
+	foreach(cell, (List *) havingQual)
 	{
-		Assert(IFX_PGATTRCOUNT(festate) > festate->pgAttrCount);
+		Expr *expr = (Expr *) lfirst(cell);
 
-		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].attnum = IFX_PGATTRCOUNT(festate);
-		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].ifx_attnum = IFX_PGATTRCOUNT(festate);
-		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].atttypid   = INT4OID;
-		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].atttypmod  = -1;
-		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].attname    = "rowid";
-		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].attnotnull = true;
+		if (ifxIsShippableExpr(root, outerrel, (Node *) expr))
+			planState->remote_conds = lappend(planState->remote_conds, expr);
+		else
+		{
+			if (!ifxAddAggregatesToTlist(root, outerrel, (Node *) expr, &tlist))
+				return false;
+
+			planState->local_conds = lappend(planState->local_conds, expr);
+		}
 	}
 
-	/* finish */
-	systable_endscan(scan);
-	heap_close(attrRel, AccessShareLock);
+	planState->scan_tlist = tlist;
+	return true;
 }
 
 /*
- * Checks for duplicate and redundant options.
+ * Adds a path for grouping and aggregation pushed down to the
+ * Informix server.
  *
- * Check for redundant options. Error out in case we've found
- * any duplicates or, in case it is an empty option, assign
- * it to the connection info.
+ * The input relation must be a plain scan of a foreign table with
+ * all its restriction clauses shippable, since the remote query has to
+ * aggregate exactly the rows a local aggregation would see.
  */
-static void
-ifxGetOptionDups(IfxConnectionInfo *coninfo, DefElem *def)
+static void ifxGetForeignUpperPaths(PlannerInfo *root,
+									UpperRelationKind stage,
+									RelOptInfo *input_rel,
+									RelOptInfo *output_rel
+#if PG_VERSION_NUM >= 110000
+									, void *extra
+#endif
+	)
 {
-	Assert(coninfo != NULL);
+	IfxFdwPlanState *inputPlanState;
+	IfxFdwPlanState *planState;
+	PathTarget      *grouping_target;
+	Node            *havingQual;
+	ListCell        *cell;
+	double           numGroups;
+	Cost             remote_cost;
+	Cost             startup_cost;
+	Cost             total_cost;
+
+	/* We support grouped relations only */
+	if ((stage != UPPERREL_GROUP_AGG)
+#if PG_VERSION_NUM >= 110000
+		&& (stage != UPPERREL_PARTIAL_GROUP_AGG)
+#endif
+		)
+		return;
 
-	if (strcmp(def->defname, "informixdir") == 0)
-	{
-		if (coninfo->informixdir)
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting or redundant options: informixdir(%s)",
-								   defGetString(def))));
+	/* Already processed? */
+	if (output_rel->fdw_private != NULL)
+		return;
 
-		coninfo->informixdir = defGetString(def);
-	}
+	elog(DEBUG3, "informix_fdw: get foreign upper paths");
 
-	if (strcmp(def->defname, "gl_date") == 0)
-	{
-		if (coninfo->gl_date)
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting or redundant options: gl_date(%s)",
-								   defGetString(def))));
+	inputPlanState = (IfxFdwPlanState *) input_rel->fdw_private;
 
-		coninfo->gl_date = defGetString(def);
-	}
+	if ((inputPlanState == NULL) || !IFX_IS_SIMPLE_REL(input_rel))
+		return;
 
-	if (strcmp(def->defname, "db_monetary") == 0)
+	/*
+	 * A foreign table based on a query can't be wrapped
+	 * into a grouped query. Without predicate pushdown, the
+	 * restrictions of the input rel must not be sent as a
+	 * remote WHERE either.
+	 */
+	if ((inputPlanState->coninfo->query != NULL)
+		|| !inputPlanState->coninfo->predicate_pushdown)
+		return;
+
+	foreach(cell, input_rel->baserestrictinfo)
 	{
-		if (coninfo->db_monetary)
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting or redundant options: db_monetary(%s)",
-								   defGetString(def))));
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(cell);
 
-		coninfo->db_monetary = defGetString(def);
+		if (rinfo->pseudoconstant
+			|| !ifxIsShippableExpr(root, input_rel, (Node *) rinfo->clause))
+			return;
 	}
 
-	if (strcmp(def->defname, "db_locale") == 0)
-	{
-		if (coninfo->db_locale)
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting or redundant options: db_locale(%s)",
-								   defGetString(def))));
+#if PG_VERSION_NUM >= 110000
+	grouping_target = output_rel->reltarget;
 
-		coninfo->db_locale = defGetString(def);
-	}
+	/*
+	 * With partial aggregation, HAVING is evaluated by the
+	 * Finalize Aggregate on top of the foreign scan.
+	 */
+	if (stage == UPPERREL_GROUP_AGG)
+		havingQual = ((GroupPathExtraData *) extra)->havingQual;
+	else
+		havingQual = NULL;
+#else
+	grouping_target = root->upper_targets[UPPERREL_GROUP_AGG];
+	havingQual      = root->parse->havingQual;
+#endif
 
+	planState = (IfxFdwPlanState *) palloc0(sizeof(IfxFdwPlanState));
+	planState->foreignTableOid = inputPlanState->foreignTableOid;
+	planState->outerrel        = input_rel;
 
-	if (strcmp(def->defname, "gl_datetime") == 0)
+	if (!ifxForeignGroupingOk(root, grouping_target, havingQual, planState))
 	{
-		if (coninfo->gl_datetime)
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting or redundant options: gl_datetime(%s)",
-								   defGetString(def))));
-
-		coninfo->gl_datetime = defGetString(def);
+		elog(DEBUG2, "informix_fdw: grouping not shippable");
+		return;
 	}
 
-	if (strcmp(def->defname, "client_locale") == 0)
-	{
-		if (coninfo->client_locale)
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting or redundant options: client_locale(%s)",
-								   defGetString(def))));
+	numGroups = estimate_num_groups(root,
+									get_sortgrouplist_exprs(root->parse->groupClause,
+															planState->scan_tlist),
+									input_rel->rows,
+									NULL);
 
-		coninfo->client_locale = defGetString(def);
-	}
+	/*
+	 * The Informix server has to read and aggregate all input rows
+	 * before returning the first group, but we need to fetch the
+	 * groups only. That's what makes the remote aggregation cheaper
+	 * than doing it locally.
+	 */
+	remote_cost  = inputPlanState->coninfo->planData.remote_costs
+		+ (input_rel->rows * cpu_operator_cost);
+	startup_cost = inputPlanState->coninfo->fdw_startup_cost + remote_cost;
+	total_cost   = startup_cost
+		+ (numGroups * (inputPlanState->coninfo->fdw_tuple_cost + cpu_tuple_cost));
 
+	/*
+	 * Remember the estimates, ifxGetForeignPlan() passes them
+	 * over to the executor.
+	 */
+	planState->coninfo = (IfxConnectionInfo *) palloc(sizeof(IfxConnectionInfo));
+	memcpy(planState->coninfo, inputPlanState->coninfo, sizeof(IfxConnectionInfo));
+	planState->coninfo->planData.estimated_rows = numGroups;
+	planState->coninfo->planData.remote_costs   = remote_cost;
+	planState->coninfo->planData.startup_costs  = startup_cost;
+	planState->coninfo->planData.total_costs    = total_cost;
 
-	if (strcmp(def->defname, "servername") == 0)
-	{
-		if (coninfo->servername)
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting or redundant options: servername(%s)",
-								   defGetString(def))));
+	output_rel->fdw_private = (void *) planState;
 
-		coninfo->servername = defGetString(def);
-	}
+	add_path(output_rel, (Path *)
+			 create_foreignscan_path(root, output_rel,
+									 grouping_target,
+									 numGroups,
+									 startup_cost,
+									 total_cost,
+									 NIL,
+									 NULL,
+									 NULL,
+									 NIL));
+}
 
-	if (strcmp(def->defname, "database") == 0)
+/*
+ * Gets the conditions of a relation participating in a join
+ * pushed down to the Informix server. For a foreign table these are
+ * its restriction clauses, which must be evaluated remotely all together.
+ * Join relations already carry their conditions in their plan state.
+ *
+ * Returns false in case the relation can't take part in the join.
+ */
+static bool ifxGetJoinInputConds(PlannerInfo     *root,
+								 RelOptInfo      *rel,
+								 IfxFdwPlanState *planState,
+								 List           **remote_conds)
+{
+	ListCell *cell;
+
+	if (!IFX_IS_SIMPLE_REL(rel))
 	{
-		if (coninfo->database)
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting or redundant options: database(%s)",
-								   defGetString(def))));
+		/*
+		 * Semi joins are deparsed into an EXISTS() subquery, which
+		 * we don't join any further.
+		 */
+		if ((planState->jointype == JOIN_SEMI)
+			|| (planState->local_conds != NIL))
+			return false;
 
-		coninfo->database = defGetString(def);
+		*remote_conds = list_copy(planState->remote_conds);
+		return true;
 	}
 
-	if (strcmp(def->defname, "username") == 0)
+	/*
+	 * A foreign table based on a query or with predicate pushdown
+	 * disabled can't be part of a remote join.
+	 */
+	if ((planState->coninfo->query != NULL)
+		|| !planState->coninfo->predicate_pushdown)
+		return false;
+
+	*remote_conds = NIL;
+
+	foreach(cell, rel->baserestrictinfo)
 	{
-		if (coninfo->database)
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting or redundant options: username(%s)",
-								   defGetString(def))));
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(cell);
 
-		coninfo->username = defGetString(def);
+		if (rinfo->pseudoconstant
+			|| !ifxIsShippableExpr(root, rel, (Node *) rinfo->clause))
+			return false;
+
+		*remote_conds = lappend(*remote_conds, rinfo->clause);
 	}
 
-	if (strcmp(def->defname, "password") == 0)
-	{
-		if (coninfo->password)
-			/* Don't leak the password into log messages */
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting or redundant options: password")));
-
-		coninfo->password = defGetString(def);
-	}
-
-	if (strcmp(def->defname, "query") == 0)
-	{
-		if (coninfo->tablename)
-			ereport(ERROR,
-					(errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-					 errmsg("conflicting options: query cannot be used with table")
-						));
-
-		if (coninfo->query)
-			ereport(ERROR,
-					(errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-					 errmsg("conflicting or redundant options: query (%s)", defGetString(def))
-						));
-
-		coninfo->tablename = defGetString(def);
-	}
-
-	if (strcmp(def->defname, "table") == 0)
-	{
-		if (coninfo->query)
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting options: query cannot be used with query")));
-
-		if (coninfo->tablename)
-			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-							errmsg("conflicting or redundant options: table(%s)",
-								   defGetString(def))));
-
-		coninfo->tablename = defGetString(def);
-	}
-
-}
-
-/*
- * Returns the database connection string
- * as 'dbname@servername'
- */
-static StringInfoData *
-ifxGetDatabaseString(IfxConnectionInfo *coninfo)
-{
-	StringInfoData *buf;
-
-	buf = makeStringInfo();
-	initStringInfo(buf);
-	appendStringInfo(buf, "%s@%s", coninfo->database, coninfo->servername);
-
-	return buf;
+	return true;
 }
 
 /*
- * Create a unique name for the database connection.
+ * Checks wether the specified join can be evaluated by the
+ * Informix server and records its conditions and scan target list
+ * in the given plan state.
  *
- * Currently the name is generated by concatenating the
- * database name, server name and user into a single string.
+ * We support inner, left and semi joins of foreign tables using the same
+ * Informix connection, where all conditions of the joined relations
+ * are shippable. Semi joins are deparsed into an EXISTS() subquery.
  */
-static StringInfoData *
-ifxGenerateConnName(IfxConnectionInfo *coninfo)
+static bool ifxForeignJoinOk(PlannerInfo       *root,
+							 RelOptInfo        *joinrel,
+							 JoinType           jointype,
+							 RelOptInfo        *outerrel,
+							 RelOptInfo        *innerrel,
+							 JoinPathExtraData *extra,
+							 IfxFdwPlanState   *planState)
 {
-	StringInfoData *buf;
-	uint32 key;
-
-	buf = makeStringInfo();
-	initStringInfo(buf);
-
-	appendStringInfo(buf, "%s%s%s", coninfo->username, coninfo->database,
-					 coninfo->servername);
+	IfxFdwPlanState *outerState;
+	IfxFdwPlanState *innerState;
+	List            *outer_conds;
+	List            *inner_conds;
+	List            *tlist;
+	ListCell        *cell;
+
+	if ((jointype != JOIN_INNER)
+		&& (jointype != JOIN_LEFT)
+		&& (jointype != JOIN_SEMI))
+		return false;
 
 	/*
-	 * We create a hash key out of the connection string, which
-	 * the forms the connection identifier with a "con" prefix
-	 * attached.
+	 * Plain SELECTs only. Row marks and modify commands require the
+	 * ROWID of the foreign tables, which we can't get from a join.
 	 */
-	key = string_hash(buf->data, buf->len);
+	if ((root->parse->commandType != CMD_SELECT)
+		|| (root->rowMarks != NIL))
+		return false;
+
+	/* Don't bother with placeholders and lateral references */
+	if ((root->placeholder_list != NIL)
+		|| !bms_is_empty(joinrel->lateral_relids))
+		return false;
+
+	outerState = (IfxFdwPlanState *) outerrel->fdw_private;
+	innerState = (IfxFdwPlanState *) innerrel->fdw_private;
+
+	if ((outerState == NULL) || (innerState == NULL))
+		return false;
 
 	/*
-	 * Reuse the existing string buffer, original content
-	 * not needed anymore.
+	 * Both sides must use the same Informix connection, that is
+	 * the same server, database and user.
 	 */
-	resetStringInfo(buf);
-	appendStringInfo(buf, "con_%u", key);
-
-	return buf;
-}
+	if (strcmp(outerState->coninfo->conname, innerState->coninfo->conname) != 0)
+		return false;
 
-Datum
-ifx_fdw_handler(PG_FUNCTION_ARGS)
-{
-	FdwRoutine *fdwRoutine = makeNode(FdwRoutine);
+	if (!ifxGetJoinInputConds(root, outerrel, outerState, &outer_conds)
+		|| !ifxGetJoinInputConds(root, innerrel, innerState, &inner_conds))
+		return false;
 
-	fdwRoutine->ExplainForeignScan = ifxExplainForeignScan;
-	fdwRoutine->BeginForeignScan   = ifxBeginForeignScan;
-	fdwRoutine->IterateForeignScan = ifxIterateForeignScan;
-	fdwRoutine->EndForeignScan     = ifxEndForeignScan;
-	fdwRoutine->ReScanForeignScan  = ifxReScanForeignScan;
+	planState->outerrel        = outerrel;
+	planState->innerrel        = innerrel;
+	planState->jointype        = jointype;
+	planState->foreignTableOid = outerState->foreignTableOid;
 
-	#if PG_VERSION_NUM < 90200
+	foreach(cell, extra->restrictlist)
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) lfirst(cell);
+		bool          is_remote;
 
-	fdwRoutine->PlanForeignScan    = ifxPlanForeignScan;
+		if (rinfo->pseudoconstant)
+			return false;
 
-	#else
+		is_remote = ifxIsShippableExpr(root, joinrel, (Node *) rinfo->clause);
 
-	fdwRoutine->GetForeignRelSize = ifxGetForeignRelSize;
-	fdwRoutine->GetForeignPaths   = ifxGetForeignPaths;
-	fdwRoutine->GetForeignPlan    = ifxGetForeignPlan;
-	fdwRoutine->AnalyzeForeignTable = ifxAnalyzeForeignTable;
+		if (jointype == JOIN_INNER)
+		{
+			if (is_remote)
+				planState->joinclauses = lappend(planState->joinclauses,
+												 rinfo->clause);
+			else
+				planState->local_conds = lappend(planState->local_conds,
+												 rinfo->clause);
+		}
+		else if ((jointype == JOIN_LEFT)
+				 && IFX_RINFO_IS_PUSHED_DOWN(rinfo, joinrel->relids))
+		{
+			/* Filter applied after the outer join */
+			if (is_remote)
+				planState->remote_conds = lappend(planState->remote_conds,
+												  rinfo->clause);
+			else
+				planState->local_conds = lappend(planState->local_conds,
+												 rinfo->clause);
+		}
+		else
+		{
+			/* Join conditions of outer and semi joins must be shipped */
+			if (!is_remote)
+				return false;
 
-	#endif
+			planState->joinclauses = lappend(planState->joinclauses,
+											 rinfo->clause);
+		}
+	}
 
 	/*
-	 * Since PostgreSQL 9.3 we support updatable foreign tables.
+	 * Conditions of the inner relation of an outer or semi join must
+	 * be evaluated before joining, so they become join conditions.
+	 * Everything else goes into the WHERE clause of the remote query.
 	 */
-	#if PG_VERSION_NUM >= 90300
-
-	fdwRoutine->AddForeignUpdateTargets = ifxAddForeignUpdateTargets;
-	fdwRoutine->PlanForeignModify       = ifxPlanForeignModify;
-	fdwRoutine->BeginForeignModify      = ifxBeginForeignModify;
-	fdwRoutine->ExecForeignInsert       = ifxExecForeignInsert;
-	fdwRoutine->ExecForeignDelete       = ifxExecForeignDelete;
-	fdwRoutine->ExecForeignUpdate       = ifxExecForeignUpdate;
-	fdwRoutine->EndForeignModify        = ifxEndForeignModify;
-	fdwRoutine->IsForeignRelUpdatable   = ifxIsForeignRelUpdatable;
-	fdwRoutine->ExplainForeignModify    = ifxExplainForeignModify;
+	planState->remote_conds = list_concat(planState->remote_conds, outer_conds);
 
-	#endif
+	if (jointype == JOIN_INNER)
+		planState->remote_conds = list_concat(planState->remote_conds,
+											  inner_conds);
+	else
+		planState->joinclauses = list_concat(planState->joinclauses,
+											 inner_conds);
 
-    #if PG_VERSION_NUM >= 90500
+	/*
+	 * Build the target list of the remote query. It must include all
+	 * columns required by the local conditions, too.
+	 */
+	tlist = add_to_flat_tlist(NIL,
+							  pull_var_clause((Node *) joinrel->reltarget->exprs,
+											  PVC_RECURSE_PLACEHOLDERS));
+	tlist = add_to_flat_tlist(tlist,
+							  pull_var_clause((Node *) planState->local_conds,
+											  PVC_RECURSE_PLACEHOLDERS));
 
-	fdwRoutine->ImportForeignSchema = ifxImportForeignSchema;
+	foreach(cell, tlist)
+	{
+		TargetEntry *tle = (TargetEntry *) lfirst(cell);
 
-    #endif
+		/* e.g. whole row references or system columns */
+		if (!ifxIsShippableExpr(root, joinrel, (Node *) tle->expr))
+			return false;
+	}
 
-	PG_RETURN_POINTER(fdwRoutine);
+	planState->scan_tlist = tlist;
+	return true;
 }
 
-
 /*
- * ifxReScanForeignScan
- *
- *   Restart the scan with new parameters.
+ * Adds a path for a join pushed down to the Informix server.
  */
-static void ifxReScanForeignScan(ForeignScanState *state)
+static void ifxGetForeignJoinPaths(PlannerInfo *root,
+								   RelOptInfo *joinrel,
+								   RelOptInfo *outerrel,
+								   RelOptInfo *innerrel,
+								   JoinType jointype,
+								   JoinPathExtraData *extra)
 {
-	IfxFdwExecutionState *fdw_state;
-	fdw_state = (IfxFdwExecutionState *) state->fdw_state;
-
-	elog(DEBUG1, "informix_fdw: rescan");
+	IfxFdwPlanState *planState;
+	IfxFdwPlanState *outerState;
+	IfxFdwPlanState *innerState;
+	Cost             remote_cost;
+	Cost             startup_cost;
+	Cost             total_cost;
 
 	/*
-	 * We're in a rescan condition on our foreign table.
+	 * We might get called for different combinations of outer and
+	 * inner relations. Stop as soon as one of them could be pushed
+	 * down, since the remote query would be the same.
 	 */
-	fdw_state->rescan = true;
-}
+	if (joinrel->fdw_private != NULL)
+		return;
 
-/*
- * Validate options passed to the INFORMIX FDW (that are,
- * FOREIGN DATA WRAPPER, SERVER, USER MAPPING and FOREIGN TABLE)
- */
-Datum
-ifx_fdw_validator(PG_FUNCTION_ARGS)
-{
-	List     *ifx_options_list = untransformRelOptions(PG_GETARG_DATUM(0));
-	Oid       catalogOid = PG_GETARG_OID(1);
-	IfxConnectionInfo coninfo = {0};
-	ListCell *cell;
+	elog(DEBUG3, "informix_fdw: get foreign join paths, jointype %d",
+		 jointype);
 
-	elog(DEBUG1, "validator called");
+	planState = (IfxFdwPlanState *) palloc0(sizeof(IfxFdwPlanState));
 
-	/*
-	 * Check options passed to this FDW. Validate values and required
-	 * arguments.
-	 */
-	foreach(cell, ifx_options_list)
+	if (!ifxForeignJoinOk(root, joinrel, jointype,
+						  outerrel, innerrel, extra, planState))
 	{
-		DefElem *def = (DefElem *) lfirst(cell);
+		elog(DEBUG2, "informix_fdw: join not shippable");
+		return;
+	}
 
-		/*
-		 * Unknown option specified, print an error message
-		 * and a hint message what's wrong.
-		 */
-		if (!ifxIsValidOption(def->defname, catalogOid))
-		{
-			StringInfoData *buf;
+	outerState = (IfxFdwPlanState *) outerrel->fdw_private;
+	innerState = (IfxFdwPlanState *) innerrel->fdw_private;
 
-			buf = ifxFdwOptionsToStringBuf(catalogOid);
+	/*
+	 * The Informix server has to read both relations, but we only need
+	 * to fetch the joined rows. That's what makes the remote join cheaper
+	 * than fetching both relations and joining them locally.
+	 */
+	remote_cost  = outerState->coninfo->planData.remote_costs
+		+ innerState->coninfo->planData.remote_costs
+		+ ((outerrel->rows + innerrel->rows) * cpu_operator_cost);
+	startup_cost = outerState->coninfo->fdw_startup_cost;
+	total_cost   = startup_cost + remote_cost
+		+ (joinrel->rows * (outerState->coninfo->fdw_tuple_cost + cpu_tuple_cost));
 
-			ereport(ERROR,
-					(errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
-					 errmsg("invalid option \"%s\"", def->defname),
-					 errhint("Valid options in this context are: %s", buf->len ? buf->data : "<none>")
-						));
-		}
+	/*
+	 * Remember the estimates, ifxGetForeignPlan() passes them
+	 * over to the executor.
+	 */
+	planState->coninfo = (IfxConnectionInfo *) palloc(sizeof(IfxConnectionInfo));
+	memcpy(planState->coninfo, outerState->coninfo, sizeof(IfxConnectionInfo));
+	planState->coninfo->planData.estimated_rows = joinrel->rows;
+	planState->coninfo->planData.costs          = outerState->coninfo->planData.costs
+		+ innerState->coninfo->planData.costs;
+	planState->coninfo->planData.remote_costs   = remote_cost;
+	planState->coninfo->planData.startup_costs  = startup_cost;
+	planState->coninfo->planData.total_costs    = total_cost;
 
-		/*
-		 * Duplicates present in current options list?
-		 */
-		ifxGetOptionDups(&coninfo, def);
-	}
+	joinrel->fdw_private = (void *) planState;
 
-	PG_RETURN_VOID();
+	add_path(joinrel, (Path *)
+			 create_foreignscan_path(root, joinrel,
+									 NULL,
+									 joinrel->rows,
+									 startup_cost,
+									 total_cost,
+									 NIL,
+									 NULL,
+									 NULL,
+									 NIL));
 }
 
+#endif
+
+#else
+
 /*
- * Retrieves options for ifx_fdw foreign data wrapper.
+ * ifxPlanForeignScan
+ *
+ * Plans a foreign scan on an remote informix relation.
  */
- static void
-ifxGetOptions(Oid foreigntableOid, IfxConnectionInfo *coninfo)
+static FdwPlan *
+ifxPlanForeignScan(Oid foreignTableOid, PlannerInfo *planInfo, RelOptInfo *baserel)
 {
-	ForeignTable  *foreignTable;
-	ForeignServer *foreignServer;
-	UserMapping   *userMap;
-	List          *options;
-	bool           mandatory[IFX_REQUIRED_CONN_KEYWORDS] = { false, false, false, false };
-	int            i;
-
-	Assert(coninfo != NULL);
-
-	foreignTable  = GetForeignTable(foreigntableOid);
-	foreignServer = GetForeignServer(foreignTable->serverid);
-	userMap       = GetUserMapping(GetUserId(), foreignTable->serverid);
+	IfxConnectionInfo    *coninfo;
+	FdwPlan              *plan;
+	List                 *plan_values;
+	IfxFdwExecutionState *state;
+	List                 *excl_restrictInfo;
+	List                 *param_exprs;
 
-	options = NIL;
-	options = list_concat(options, foreignTable->options);
-	options = list_concat(options, foreignServer->options);
-	options = list_concat(options, userMap->options);
+	elog(DEBUG3, "informix_fdw: plan scan");
 
 	/*
-	 * Retrieve required arguments.
+	 * Prepare a generic plan structure
 	 */
-	ifxAssignOptions(coninfo, options, mandatory);
-
-	if ((coninfo->query == NULL)
-		 && (coninfo->tablename == NULL))
-	{
-		ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
-						errmsg("invalid options for remote table \"%s\"",
-							   get_rel_name(foreignTable->relid)),
-						errdetail("either parameter \"query\" or \"table\" is missing")));
-	}
+	plan = makeNode(FdwPlan);
 
 	/*
-	 * Check for all other mandatory options
+	 * Establish remote informix connection or get
+	 * a already cached connection from the informix connection
+	 * cache.
 	 */
-	for (i = 0; i < IFX_REQUIRED_CONN_KEYWORDS; i++)
-	{
-		if (!mandatory[i])
-			ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
-							errmsg("missing required FDW options (informixserver, informixdir, client_locale, database)")));
-	}
-
-}
-
-/*
- * Returns a hashed identifier generate from the contents
- * of buf with the prefix specified in p. p isn't allowed to
- * be null, and neither buf. If one of the arguments are NULL or
- * have a zero-length string specified, the function will return NULL.
- */
-__attribute__((unused)) static char * ifxHashIdentifier(StringInfoData *buf, char *prefix) {
-
-	char *result;
-	size_t ident_len = 0;
-	uint32 key;
+	ifxSetupFdwScan(&coninfo, &state, &plan_values,
+					foreignTableOid, IFX_PLAN_SCAN);
 
-	if ((buf == NULL) || (prefix == NULL))
-		return NULL;
+	/*
+	 * Check for predicates that can be pushed down
+	 * to the informix server, but skip it in case the user
+	 * has set the disable_predicate_pushdown option...
+	 */
+	if (coninfo->predicate_pushdown)
+	{
+		state->stmt_info.predicate = ifxFilterQuals(planInfo, baserel,
+													&excl_restrictInfo,
+													&param_exprs,
+													NIL,
+													NIL,
+													foreignTableOid);
+		elog(DEBUG2, "predicate for pushdown: %s", state->stmt_info.predicate);
+	}
+	else
+	{
+		elog(DEBUG2, "predicate pushdown disabled");
+		state->stmt_info.predicate = "";
+	}
 
-	if (strlen(prefix) <= 0)
-		return NULL;
+	state->stmt_info.directives = ifxOptimizerDirectives(coninfo,
+														 ifxWantsFirstRows(planInfo));
 
-	if (buf->len <= 0)
-		return NULL;
+	/*
+	 * Prepare parameters of the state structure
+	 * and cursor definition.
+	 */
+	ifxPrepareScan(coninfo, state, foreignTableOid, NULL);
 
 	/*
-	 * Hash the identifier string.
+	 * After declaring the cursor, the row and cost estimates
+	 * are saved into the IfxPlanData structure member of
+	 * IfxConnectionInfo. Assign the values to our plan node.
 	 */
-	key = string_hash(buf->data, buf->len);
+	ifxCalculateScanCosts(coninfo, true);
+	baserel->rows = coninfo->planData.estimated_rows;
+	plan->startup_cost = coninfo->planData.startup_costs;
+	plan->total_cost = coninfo->planData.total_costs;
 
 	/*
-	 * Copy over the statement identifier in a
-	 * dynamically palloc'ed string buffer, since it might
-	 * get reused over various call sites until query/transaction
-	 * ends.
+	 * Save parameters to our plan. We need to make sure they
+	 * are copyable by copyObject(), so use a list with
+	 * bytea const nodes.
+	 *
+	 * NOTE: we *must* not allocate serialized nodes within
+	 *       the current memory context, because this will crash
+	 *       on prepared statements and subsequent EXECUTE calls
+	 *       since they will be freed after. Instead, use the
+	 *       planner context, which will remain as long as
+	 *       the plan exists.
+	 *
 	 */
-	ident_len = buf->len + strlen(prefix);
-	result = (char *) palloc0(ident_len + 1);
-	snprintf(result, ident_len, "%s%u",
-			 prefix, key);
+	plan_values = ifxSerializePlanData(coninfo, state, planInfo);
+	plan->fdw_private = plan_values;
 
-	return result;
+	return plan;
 }
 
+#endif
+
 /*
- * Generate a unique statement identifier to create
- * on the target database. Informix requires us to build
- * a unique name among all concurrent connections.
+ * ifxPushCallstack()
  *
- * Returns a palloc'ed string containing a statement identifier
- * suitable to pass to an Informix database.
+ * Updates the call stack with the new
+ * stackentry.
  */
-static char *ifxGenStatementName(int stmt_id)
+static inline void ifxPushCallstack(IfxStatementInfo *info,
+									unsigned short stackentry)
 {
-	char *stmt_name = NULL;
-	StringInfoData *buf;
-
-	buf = makeStringInfo();
-	initStringInfo(buf);
-
-	appendStringInfo(buf, "s%d_%d",
-					 MyBackendId, stmt_id);
-
-	stmt_name = (char *) palloc0(buf->len + 1);
-	strncpy(stmt_name, buf->data, buf->len);
-
-	/*
-	 * Free temporary resources.
-	 */
-	resetStringInfo(buf);
-	pfree(buf);
-
-	if (stmt_name == NULL)
-		ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DESCRIPTOR_FIELD_IDENTIFIER),
-						errmsg("could not generate informix identifier for statement")));
-
-	elog(DEBUG5, "generated statement name %s", stmt_name);
-
-	return stmt_name;
+	if (stackentry == 0)
+		return;
+	info->call_stack |= stackentry;
 }
 
-static char *ifxGenDescrName(int descr_id)
+/*
+ * ifxPopCallstack()
+ *
+ * Sets the status of the call stack to the
+ * given state.
+ */
+static inline void ifxPopCallstack(IfxStatementInfo *info,
+								   unsigned short stackentry)
 {
-	char *descr_name = NULL;
-	StringInfoData *buf;
-
-	buf = makeStringInfo();
-	initStringInfo(buf);
-
-	appendStringInfo(buf, "d%d_%d",
-					 MyBackendId, descr_id);
-
-	descr_name = (char *) palloc0(buf->len + 1);
-	strncpy(descr_name, buf->data, buf->len);
-
-	/*
-	 * Free temporary resources.
-	 */
-	resetStringInfo(buf);
-	pfree(buf);
-
-	if (descr_name == NULL)
-		ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DESCRIPTOR_FIELD_IDENTIFIER),
-						errmsg("could not generate informix descriptor identifier for statement")));
-
-	elog(DEBUG5, "generated descriptor name %s", descr_name);
-
-	return descr_name;
+	info->call_stack &= ~stackentry;
 }
 
-
 /*
- * Generate a unique cursor identifier
+ * ifxRewindCallstack()
  *
- * The specified curid should be a unique number
- * identifying the returned cursor name uniquely throughout
- * the backend.
+ * Gets the call back and tries to free
+ * all resources associated with the call stack
+ * in the given state.
  */
-static char *ifxGenCursorName(int curid)
+void ifxRewindCallstack(IfxStatementInfo *info)
 {
-	char *cursor_name = NULL;
-	StringInfoData *buf;
-
-	buf = makeStringInfo();
-	initStringInfo(buf);
-
-	appendStringInfo(buf, "c%d_%d",
-					 MyBackendId, curid);
-
-	cursor_name = (char *) palloc0(buf->len + 1);
-	strncpy(cursor_name, buf->data, buf->len);
+	/*
+	 * Statements owned by the statement cache are kept.
+	 */
+	if ((info->call_stack & IFX_STACK_CACHED) == IFX_STACK_CACHED)
+	{
+		ifxReleaseCachedStatement(info);
+		return;
+	}
 
 	/*
-	 * Free temporary resources.
+	 * NOTE: IFX_STACK_DESCRIBE doesn't need any special handling here,
+	 * so just ignore it until the end of rewinding the call stack
+	 * and set it to IFX_STACK_EMPTY if everything else is undone.
 	 */
-	resetStringInfo(buf);
-	pfree(buf);
 
-	if (cursor_name == NULL)
-		ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DESCRIPTOR_FIELD_IDENTIFIER),
-						errmsg("could not generate informix cursor identifier for statement")));
+	if ((info->call_stack & IFX_STACK_OPEN) == IFX_STACK_OPEN)
+	{
+		ifxCloseCursor(info);
+		elog(DEBUG2, "informix_fdw: undo open");
+		ifxPopCallstack(info, IFX_STACK_OPEN);
+	}
 
-	elog(DEBUG5, "generated cursor name %s", cursor_name);
+	if ((info->call_stack & IFX_STACK_ALLOCATE) == IFX_STACK_ALLOCATE)
+	{
+		/*
+		 * Deallocating allocated memory by sqlda data structure
+		 * is going to be little tricky here: sqlda is allocated
+		 * by the Informix ESQL/C API, so we don't have any influence
+		 * via memory contexts...we aren't allowed to use pfree()!
+		 *
+		 * The memory area for SQL data values retrieved by any
+		 * FETCH from the underlying cursor is allocated by palloc(),
+		 * however. We don't free them immediately and leave this up
+		 * to memory context cleanup.
+		 */
+		ifxDeallocateSQLDA(info);
+		elog(DEBUG2, "informix_fdw: undo allocate");
+		ifxPopCallstack(info, IFX_STACK_ALLOCATE);
+	}
 
-	return cursor_name;
+	if ((info->call_stack & IFX_STACK_DECLARE) == IFX_STACK_DECLARE)
+	{
+		ifxFreeResource(info, IFX_STACK_DECLARE);
+		elog(DEBUG2, "informix_fdw: undo declare");
+		ifxPopCallstack(info, IFX_STACK_DECLARE);
+	}
+
+	if ((info->call_stack & IFX_STACK_PREPARE) == IFX_STACK_PREPARE)
+	{
+		ifxFreeResource(info, IFX_STACK_PREPARE);
+		elog(DEBUG2, "informix_fdw: undo prepare");
+		ifxPopCallstack(info, IFX_STACK_PREPARE);
+	}
+
+	info->call_stack = IFX_STACK_EMPTY;
 }
 
 /*
- * Prepare informix query object identifier
+ * Trap errors from the informix FDW API.
+ *
+ * This function checks exceptions from ESQL
+ * and creates corresponding NOTICE, WARN or ERROR
+ * messages.
+ *
  */
-static void ifxPrepareParamsForScan(IfxFdwExecutionState *state,
-									IfxConnectionInfo *coninfo)
+static IfxSqlStateClass ifxCatchExceptions(IfxStatementInfo *state,
+										   unsigned short stackentry)
 {
-	StringInfoData *buf;
-	char           *rowid_str;
-
-	buf = makeStringInfo();
-	initStringInfo(buf);
+	IfxSqlStateClass errclass;
 
 	/*
-	 * We depend on ROWID per default.
+	 * Set last error, if any
 	 */
-	if (state->use_rowid == 1)
-		rowid_str = ", rowid";
-	else
-		rowid_str = "";
+	errclass = ifxSetException(state);
 
-	/*
-	 * Record the given query and pass it over
-	 * to the state structure.
-	 */
-	if (coninfo->query)
+	if (errclass != IFX_SUCCESS)
 	{
 		/*
-		 * IMPORTANT: When a query was specified, we don't
-		 *            retrieve the ROWID. This doesn't matter here,
-		 *            since we don't support modifying such
-		 *            a foreign table anyways. Force disabling rowid
-		 *            in this case to be consistent regardless.
+		 * Obtain the error message. Since ifxRewindCallstack()
+		 * will release any associated resources before we can
+		 * print an ERROR message, we save the current from
+		 * the caller within an IfxSqlStateMessage structure.
 		 */
-		state->use_rowid = 0;
+		IfxSqlStateMessage message;
 
-		if ((state->stmt_info.predicate != NULL)
-			&& (strlen(state->stmt_info.predicate) > 0)
-			&& coninfo->predicate_pushdown)
-		{
-			appendStringInfo(buf, "%s WHERE %s",
-							 coninfo->query,
-							 state->stmt_info.predicate);
-		}
-		else
+		elog(DEBUG1, "informix FDW exception count: %d",
+			 state->exception_count);
+
+		ifxGetSqlStateMessage(1, &message);
+
+		switch (errclass)
 		{
-			appendStringInfo(buf, "%s",
-							 coninfo->query);
+			case IFX_RT_ERROR:
+				/*
+				 * log Informix runtime error.
+				 *
+				 * There's no ERRCODE_FDW_FATAL, so we go with a HV000 error
+				 * code for now, but print out the error message as ERROR.
+				 *
+				 * A runtime error normally means a SQL error. Formerly, we did
+				 * a FATAL here, but this stroke me as far to hard (it will exit
+				 * the backend). Go with an ERROR instead...
+				 *
+				 * We don't know wether a cached statement is still
+				 * usable, so remove it from the statement cache.
+				 */
+				ifxUncacheStatement(state);
+				ifxRewindCallstack(state);
+			case IFX_ERROR:
+			case IFX_ERROR_INVALID_NAME:
+				/* log ERROR */
+				ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
+								errmsg("informix FDW error: \"%s\"",
+									   message.text),
+								errdetail("SQLSTATE %s (SQLCODE=%d)",
+										  message.sqlstate, message.sqlcode)));
+				break;
+			case IFX_WARNING:
+				/* log WARN */
+				ereport(WARNING, (errcode(ERRCODE_FDW_ERROR),
+								  errmsg("informix FDW warning: \"%s\"",
+										 message.text),
+								  errdetail("SQLSTATE %s", message.sqlstate)));
+				break;
+			case IFX_ERROR_TABLE_NOT_FOUND:
+				/* log missing FDW table */
+				ereport(ERROR, (errcode(ERRCODE_FDW_TABLE_NOT_FOUND),
+								errmsg("informix FDW missing table: \"%s\"",
+									   message.text),
+								errdetail("SQLSTATE %s", message.sqlstate)));
+				break;
+			case IFX_NOT_FOUND:
+			default:
+				/* needs no log */
+				break;
 		}
 	}
-	else
+
+	/*
+	 * IFX_SUCCESS
+	 */
+	ifxPushCallstack(state, stackentry);
+
+	return errclass;
+}
+
+/*
+ * Retrieve the local column definition of the
+ * foreign table (attribute number, type and additional
+ * options).
+ */
+static void ifxPgColumnData(Oid foreignTableOid, IfxFdwExecutionState *festate)
+{
+	HeapTuple         tuple;
+	Relation          attrRel;
+	SysScanDesc       scan;
+	ScanKeyData       key[2];
+	Form_pg_attribute attrTuple;
+	Relation          foreignRel;
+	int               pgAttrIndex;
+	int               ifxAttrIndex;
+
+	pgAttrIndex  = 0;
+	ifxAttrIndex = 0;
+	festate->pgDroppedAttrCount = 0;
+
+	/* open foreign table, should be locked already */
+	foreignRel = heap_open(foreignTableOid, NoLock);
+	festate->pgAttrCount = RelationGetNumberOfAttributes(foreignRel);
+	heap_close(foreignRel, NoLock);
+
+	/*
+	 * Use IFX_PGATTRCOUNT to reflect extra space for retrieval of ROWID,
+	 * if necessary.
+	 */
+	festate->pgAttrDefs = palloc0fast(sizeof(PgAttrDef) * IFX_PGATTRCOUNT(festate));
+
+	/*
+	 * Get all attributes for the given foreign table.
+	 */
+	attrRel = heap_open(AttributeRelationId, AccessShareLock);
+	ScanKeyInit(&key[0], Anum_pg_attribute_attrelid,
+				BTEqualStrategyNumber, F_OIDEQ,
+				ObjectIdGetDatum(foreignTableOid));
+	ScanKeyInit(&key[1], Anum_pg_attribute_attnum,
+				BTGreaterStrategyNumber, F_INT2GT,
+				Int16GetDatum((int16)0));
+	scan = systable_beginscan(attrRel, AttributeRelidNumIndexId, true,
+							  IFX_SYSTABLE_SCAN_SNAPSHOT, 2, key);
+
+	while (HeapTupleIsValid(tuple = systable_getnext(scan)))
 	{
+		attrTuple = (Form_pg_attribute) GETSTRUCT(tuple);
+
 		/*
-		 * NOTE:
-		 *
-		 * Don't declare the query as READ ONLY. We can't really
-		 * distinguish wether the scan is related to a DELETE or UPDATE.
-		 *
-		 * XXX:
-		 *
-		 * We declare the Informix transaction with REPEATABLE READ
-		 * isolation level. Consider different modes here, e.g. FOR UPDATE
-		 * with READ COMMITTED...
-		 *
-		 * In case disable_rowid was specified, we cannot rely on the
-		 * ROWID (for example, if fragmented tables are used on the Informix
-		 * server).
+		 * Current PostgreSQL attnum.
+		 */
+		++pgAttrIndex;
+
+		/*
+		 * Ignore dropped columns.
 		 */
-		if ((state->stmt_info.predicate != NULL)
-			&& (strlen(state->stmt_info.predicate) > 0)
-			&& coninfo->predicate_pushdown)
+		if (attrTuple->attisdropped)
 		{
-			appendStringInfo(buf, "SELECT *%s FROM %s WHERE %s",
-							 rowid_str,
-							 ifxQuoteIdent(coninfo, coninfo->tablename),
-							 state->stmt_info.predicate);
+			festate->pgAttrDefs[pgAttrIndex - 1].attnum = -1;
+
+			/*
+			 * In case of dropped columns, we differ from the attribute
+			 * numbers used for Informix. Record them accordingly.
+			 */
+			festate->pgAttrDefs[pgAttrIndex - 1].ifx_attnum = -1;
+			festate->pgAttrDefs[pgAttrIndex - 1].atttypid = -1;
+			festate->pgAttrDefs[pgAttrIndex - 1].atttypmod = -1;
+			festate->pgAttrDefs[pgAttrIndex - 1].attname = NULL;
+			festate->pgDroppedAttrCount++;
+			continue;
 		}
-		else
+
+		/*
+		 * Don't rely on pgAttrIndex directly.
+		 *
+		 * RelationGetNumberOfAttributes() always counts the number
+		 * of attributes *including* dropped columns.
+		 *
+		 * Increment ifxAttrIndex only in case we don't have
+		 * a dropped column. Otherwise we won't match the
+		 * Informix attribute list.
+		 */
+		++ifxAttrIndex;
+
+		/*
+		 * Protect against corrupted numbers in pg_class.relnatts
+		 * and number of attributes retrieved from pg_attribute.
+		 */
+		if (pgAttrIndex > festate->pgAttrCount)
 		{
-			appendStringInfo(buf, "SELECT *%s FROM %s",
-							 rowid_str,
-							 ifxQuoteIdent(coninfo, coninfo->tablename));
+			systable_endscan(scan);
+			heap_close(attrRel, AccessShareLock);
+			elog(ERROR, "unexpected number of attributes in foreign table");
 		}
+
+		/*
+		 * Save the attribute and all required properties for
+		 * later usage.
+		 */
+		festate->pgAttrDefs[pgAttrIndex - 1].attnum = attrTuple->attnum;
+		festate->pgAttrDefs[pgAttrIndex - 1].ifx_attnum = ifxAttrIndex;
+		festate->pgAttrDefs[pgAttrIndex - 1].atttypid = attrTuple->atttypid;
+		festate->pgAttrDefs[pgAttrIndex - 1].atttypmod = attrTuple->atttypmod;
+		festate->pgAttrDefs[pgAttrIndex - 1].attname = pstrdup(NameStr(attrTuple->attname));
+		festate->pgAttrDefs[pgAttrIndex - 1].attnotnull = attrTuple->attnotnull;
+
+		elog(DEBUG5, "mapped attnum PG/IFX %d => %d",
+			 festate->pgAttrDefs[pgAttrIndex - 1].attnum,
+			 PG_MAPPED_IFX_ATTNUM(festate, pgAttrIndex - 1));
 	}
 
 	/*
-	 * In case we got a foreign scan initiated by
-	 * an UPDATE/DELETE DML command, we need to do a
-	 * FOR UPDATE, otherwise the cursor won't be updatable
-	 * later in the modify actions.
+	 * Request information for the resjunk ROWID column.
 	 */
-	if (state->stmt_info.cursorUsage == IFX_UPDATE_CURSOR)
+	if (festate->use_rowid)
 	{
-		appendStringInfoString(buf, " FOR UPDATE");
+		Assert(IFX_PGATTRCOUNT(festate) > festate->pgAttrCount);
+
+		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].attnum = IFX_PGATTRCOUNT(festate);
+		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].ifx_attnum = IFX_PGATTRCOUNT(festate);
+		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].atttypid   = INT4OID;
+		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].atttypmod  = -1;
+		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].attname    = "rowid";
+		festate->pgAttrDefs[IFX_PGATTRCOUNT(festate) - 1].attnotnull = true;
 	}
 
-	state->stmt_info.query = buf->data;
+	/* finish */
+	systable_endscan(scan);
+	heap_close(attrRel, AccessShareLock);
+}
 
-	/*
-	 * Save the connection identifier.
-	 */
-	StrNCpy(state->stmt_info.conname, coninfo->conname, IFX_CONNAME_LEN);
+#if PG_VERSION_NUM >= 90600
+
+/*
+ * Retrieve the column definition of a foreign scan without
+ * a scan relation (e.g. a pushed down grouped query) from its scan
+ * tuple descriptor. The columns returned by the remote query match
+ * the descriptor one by one.
+ */
+static void ifxPgColumnDataFromTupleDesc(TupleDesc tupdesc,
+										 IfxFdwExecutionState *festate)
+{
+	int i;
+
+	festate->pgDroppedAttrCount = 0;
+	festate->pgAttrCount        = tupdesc->natts;
+
+	/* never a ROWID here */
+	festate->use_rowid = false;
+
+	festate->pgAttrDefs = palloc0fast(sizeof(PgAttrDef) * festate->pgAttrCount);
+
+	for (i = 0; i < tupdesc->natts; i++)
+	{
+		Form_pg_attribute attr = TUPDESC_GET_ATTR(tupdesc, i);
+
+		festate->pgAttrDefs[i].attnum     = i + 1;
+		festate->pgAttrDefs[i].ifx_attnum = i + 1;
+		festate->pgAttrDefs[i].atttypid   = attr->atttypid;
+		festate->pgAttrDefs[i].atttypmod  = attr->atttypmod;
+		festate->pgAttrDefs[i].attname    = pstrdup(NameStr(attr->attname));
+		festate->pgAttrDefs[i].attnotnull = false;
+	}
 }
 
+#endif
+
 /*
- * ifxBeginForeignScan
+ * Returns the OID of the foreign table the specified
+ * foreign scan belongs to.
  *
- * Implements FDW BeginForeignScan callback function.
+ * Foreign scans without a scan relation (e.g. a pushed down grouped
+ * query) use the foreign table of the first base relation they
+ * cover, which provides the connection options.
+ */
+static Oid ifxGetForeignScanTableOid(ForeignScanState *node)
+{
+#if PG_VERSION_NUM >= 90600
+	if (node->ss.ss_currentRelation == NULL)
+	{
+		ForeignScan *fsplan = (ForeignScan *) node->ss.ps.plan;
+		int          rtindex;
+
+		rtindex = bms_next_member(fsplan->fs_relids, -1);
+		return rt_fetch(rtindex, node->ss.ps.state->es_range_table)->relid;
+	}
+#endif
+
+	return RelationGetRelid(node->ss.ss_currentRelation);
+}
+
+/*
+ * Checks for duplicate and redundant options.
+ *
+ * Check for redundant options. Error out in case we've found
+ * any duplicates or, in case it is an empty option, assign
+ * it to the connection info.
  */
 static void
-ifxBeginForeignScan(ForeignScanState *node, int eflags)
+ifxGetOptionDups(IfxConnectionInfo *coninfo, DefElem *def)
+{
+	Assert(coninfo != NULL);
+
+	if (strcmp(def->defname, "informixdir") == 0)
+	{
+		if (coninfo->informixdir)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting or redundant options: informixdir(%s)",
+								   defGetString(def))));
+
+		coninfo->informixdir = defGetString(def);
+	}
+
+	if (strcmp(def->defname, "gl_date") == 0)
+	{
+		if (coninfo->gl_date)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting or redundant options: gl_date(%s)",
+								   defGetString(def))));
+
+		coninfo->gl_date = defGetString(def);
+	}
+
+	if (strcmp(def->defname, "db_monetary") == 0)
+	{
+		if (coninfo->db_monetary)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting or redundant options: db_monetary(%s)",
+								   defGetString(def))));
+
+		coninfo->db_monetary = defGetString(def);
+	}
+
+	if (strcmp(def->defname, "db_locale") == 0)
+	{
+		if (coninfo->db_locale)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting or redundant options: db_locale(%s)",
+								   defGetString(def))));
+
+		coninfo->db_locale = defGetString(def);
+	}
+
+
+	if (strcmp(def->defname, "gl_datetime") == 0)
+	{
+		if (coninfo->gl_datetime)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting or redundant options: gl_datetime(%s)",
+								   defGetString(def))));
+
+		coninfo->gl_datetime = defGetString(def);
+	}
+
+	if (strcmp(def->defname, "client_locale") == 0)
+	{
+		if (coninfo->client_locale)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting or redundant options: client_locale(%s)",
+								   defGetString(def))));
+
+		coninfo->client_locale = defGetString(def);
+	}
+
+
+	if (strcmp(def->defname, "servername") == 0)
+	{
+		if (coninfo->servername)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting or redundant options: servername(%s)",
+								   defGetString(def))));
+
+		coninfo->servername = defGetString(def);
+	}
+
+	if (strcmp(def->defname, "database") == 0)
+	{
+		if (coninfo->database)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting or redundant options: database(%s)",
+								   defGetString(def))));
+
+		coninfo->database = defGetString(def);
+	}
+
+	if (strcmp(def->defname, "username") == 0)
+	{
+		if (coninfo->database)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting or redundant options: username(%s)",
+								   defGetString(def))));
+
+		coninfo->username = defGetString(def);
+	}
+
+	if (strcmp(def->defname, "password") == 0)
+	{
+		if (coninfo->password)
+			/* Don't leak the password into log messages */
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting or redundant options: password")));
+
+		coninfo->password = defGetString(def);
+	}
+
+	if (strcmp(def->defname, "query") == 0)
+	{
+		if (coninfo->tablename)
+			ereport(ERROR,
+					(errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+					 errmsg("conflicting options: query cannot be used with table")
+						));
+
+		if (coninfo->query)
+			ereport(ERROR,
+					(errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+					 errmsg("conflicting or redundant options: query (%s)", defGetString(def))
+						));
+
+		coninfo->tablename = defGetString(def);
+	}
+
+	if (strcmp(def->defname, "table") == 0)
+	{
+		if (coninfo->query)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting options: query cannot be used with query")));
+
+		if (coninfo->tablename)
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+							errmsg("conflicting or redundant options: table(%s)",
+								   defGetString(def))));
+
+		coninfo->tablename = defGetString(def);
+	}
+
+}
+
+/*
+ * Returns the value of an option requiring an integer
+ * not less than minvalue. Errors out in case of an invalid value.
+ */
+static int ifxGetIntOption(DefElem *def, int minvalue)
+{
+	char *value = defGetString(def);
+	char *endptr;
+	long  result;
+
+	errno  = 0;
+	result = strtol(value, &endptr, 10);
+
+	if ((errno != 0) || (*value == '\0') || (*endptr != '\0')
+		|| (result < minvalue) || (result > INT_MAX))
+		ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE),
+						errmsg("invalid value for option \"%s\": \"%s\"",
+							   def->defname, value),
+						errhint((minvalue > 0)
+								? "The value must be a positive integer."
+								: "The value must be zero or a positive integer.")));
+
+	return (int) result;
+}
+
+/*
+ * Returns the value of an option requiring a floating
+ * point number not less than zero. Errors out in case of an
+ * invalid value.
+ */
+static double ifxGetFloatOption(DefElem *def)
+{
+	char   *value = defGetString(def);
+	char   *endptr;
+	double  result;
+
+	errno  = 0;
+	result = strtod(value, &endptr);
+
+	if ((errno != 0) || (*value == '\0') || (*endptr != '\0')
+		|| isnan(result) || (result < 0))
+		ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE),
+						errmsg("invalid value for option \"%s\": \"%s\"",
+							   def->defname, value),
+						errhint("The value must be zero or a positive number.")));
+
+	return result;
+}
+
+/*
+ * Returns the database connection string
+ * as 'dbname@servername'
+ */
+static StringInfoData *
+ifxGetDatabaseString(IfxConnectionInfo *coninfo)
+{
+	StringInfoData *buf;
+
+	buf = makeStringInfo();
+	initStringInfo(buf);
+	appendStringInfo(buf, "%s@%s", coninfo->database, coninfo->servername);
+
+	return buf;
+}
+
+/*
+ * Create a unique name for the database connection.
+ *
+ * Currently the name is generated by concatenating the
+ * database name, server name and user into a single string.
+ */
+static StringInfoData *
+ifxGenerateConnName(IfxConnectionInfo *coninfo)
+{
+	StringInfoData *buf;
+	uint32 key;
+
+	buf = makeStringInfo();
+	initStringInfo(buf);
+
+	appendStringInfo(buf, "%s%s%s", coninfo->username, coninfo->database,
+					 coninfo->servername);
+
+	/*
+	 * We create a hash key out of the connection string, which
+	 * the forms the connection identifier with a "con" prefix
+	 * attached.
+	 */
+	key = string_hash(buf->data, buf->len);
+
+	/*
+	 * Reuse the existing string buffer, original content
+	 * not needed anymore.
+	 */
+	resetStringInfo(buf);
+	appendStringInfo(buf, "con_%u", key);
+
+	return buf;
+}
+
+Datum
+ifx_fdw_handler(PG_FUNCTION_ARGS)
+{
+	FdwRoutine *fdwRoutine = makeNode(FdwRoutine);
+
+	fdwRoutine->ExplainForeignScan = ifxExplainForeignScan;
+	fdwRoutine->BeginForeignScan   = ifxBeginForeignScan;
+	fdwRoutine->IterateForeignScan = ifxIterateForeignScan;
+	fdwRoutine->EndForeignScan     = ifxEndForeignScan;
+	fdwRoutine->ReScanForeignScan  = ifxReScanForeignScan;
+
+	#if PG_VERSION_NUM < 90200
+
+	fdwRoutine->PlanForeignScan    = ifxPlanForeignScan;
+
+	#else
+
+	fdwRoutine->GetForeignRelSize = ifxGetForeignRelSize;
+	fdwRoutine->GetForeignPaths   = ifxGetForeignPaths;
+	fdwRoutine->GetForeignPlan    = ifxGetForeignPlan;
+	fdwRoutine->AnalyzeForeignTable = ifxAnalyzeForeignTable;
+
+	#endif
+
+	/*
+	 * Grouping, aggregate and join pushdown requires PostgreSQL 9.6.
+	 */
+	#if PG_VERSION_NUM >= 90600
+
+	fdwRoutine->GetForeignUpperPaths = ifxGetForeignUpperPaths;
+	fdwRoutine->GetForeignJoinPaths  = ifxGetForeignJoinPaths;
+
+	#endif
+
+	/*
+	 * Since PostgreSQL 9.3 we support updatable foreign tables.
+	 */
+	#if PG_VERSION_NUM >= 90300
+
+	fdwRoutine->AddForeignUpdateTargets = ifxAddForeignUpdateTargets;
+	fdwRoutine->PlanForeignModify       = ifxPlanForeignModify;
+	fdwRoutine->BeginForeignModify      = ifxBeginForeignModify;
+	fdwRoutine->ExecForeignInsert       = ifxExecForeignInsert;
+	fdwRoutine->ExecForeignDelete       = ifxExecForeignDelete;
+	fdwRoutine->ExecForeignUpdate       = ifxExecForeignUpdate;
+	fdwRoutine->EndForeignModify        = ifxEndForeignModify;
+	fdwRoutine->IsForeignRelUpdatable   = ifxIsForeignRelUpdatable;
+	fdwRoutine->ExplainForeignModify    = ifxExplainForeignModify;
+
+	#endif
+
+	/*
+	 * COPY FROM and tuple routing into foreign
+	 * tables requires PostgreSQL 11.
+	 */
+	#if PG_VERSION_NUM >= 110000
+
+	fdwRoutine->BeginForeignInsert = ifxBeginForeignInsert;
+	fdwRoutine->EndForeignInsert   = ifxEndForeignModify;
+
+	#endif
+
+	/*
+	 * UPDATE and DELETE executed directly by the Informix server
+	 * share the expression deparser with aggregate pushdown and
+	 * require PostgreSQL 9.6, too.
+	 *
+	 * XXX: ifxPlanDirectModify() relies on the subplans of a
+	 *      ModifyTable in plan->plans, which PostgreSQL 14 doesn't
+	 *      pass anymore. Needs to be revisited when porting.
+	 */
+	#if PG_VERSION_NUM >= 90600
+
+	fdwRoutine->PlanDirectModify    = ifxPlanDirectModify;
+	fdwRoutine->BeginDirectModify   = ifxBeginDirectModify;
+	fdwRoutine->IterateDirectModify = ifxIterateDirectModify;
+	fdwRoutine->EndDirectModify     = ifxEndDirectModify;
+	fdwRoutine->ExplainDirectModify = ifxExplainForeignScan;
+
+	#endif
+
+    #if PG_VERSION_NUM >= 90500
+
+	fdwRoutine->ImportForeignSchema = ifxImportForeignSchema;
+
+    #endif
+
+	PG_RETURN_POINTER(fdwRoutine);
+}
+
+
+/*
+ * ifxReScanForeignScan
+ *
+ *   Restart the scan with new parameters.
+ */
+static void ifxReScanForeignScan(ForeignScanState *state)
+{
+	IfxFdwExecutionState *fdw_state;
+	fdw_state = (IfxFdwExecutionState *) state->fdw_state;
+
+	elog(DEBUG1, "informix_fdw: rescan");
+
+	/*
+	 * We're in a rescan condition on our foreign table.
+	 */
+	fdw_state->rescan        = true;
+	fdw_state->rows_fetched  = 0;
+	fdw_state->scan_complete = false;
+}
+
+/*
+ * Validate options passed to the INFORMIX FDW (that are,
+ * FOREIGN DATA WRAPPER, SERVER, USER MAPPING and FOREIGN TABLE)
+ */
+Datum
+ifx_fdw_validator(PG_FUNCTION_ARGS)
+{
+	List     *ifx_options_list = untransformRelOptions(PG_GETARG_DATUM(0));
+	Oid       catalogOid = PG_GETARG_OID(1);
+	IfxConnectionInfo coninfo = {0};
+	ListCell *cell;
+
+	elog(DEBUG1, "validator called");
+
+	/*
+	 * Check options passed to this FDW. Validate values and required
+	 * arguments.
+	 */
+	foreach(cell, ifx_options_list)
+	{
+		DefElem *def = (DefElem *) lfirst(cell);
+
+		/*
+		 * Unknown option specified, print an error message
+		 * and a hint message what's wrong.
+		 */
+		if (!ifxIsValidOption(def->defname, catalogOid))
+		{
+			StringInfoData *buf;
+
+			buf = ifxFdwOptionsToStringBuf(catalogOid);
+
+			ereport(ERROR,
+					(errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+					 errmsg("invalid option \"%s\"", def->defname),
+					 errhint("Valid options in this context are: %s", buf->len ? buf->data : "<none>")
+						));
+		}
+
+		/*
+		 * Duplicates present in current options list?
+		 */
+		ifxGetOptionDups(&coninfo, def);
+
+		/*
+		 * Check options requiring numeric values.
+		 */
+		if ((strcmp(def->defname, "batch_size") == 0)
+			|| (strcmp(def->defname, "insert_buffer_size") == 0))
+			ifxGetIntOption(def, 1);
+
+		if ((strcmp(def->defname, "statement_cache_size") == 0)
+			|| (strcmp(def->defname, "estimate_cache_ttl") == 0)
+			|| (strcmp(def->defname, "join_filter_rows") == 0))
+			ifxGetIntOption(def, 0);
+
+		if ((strcmp(def->defname, "use_remote_estimate") == 0)
+			|| (strcmp(def->defname, "analyze_sampling") == 0)
+			|| (strcmp(def->defname, "import_statistics") == 0))
+			(void) defGetBoolean(def);
+
+		if ((strcmp(def->defname, "fdw_startup_cost") == 0)
+			|| (strcmp(def->defname, "fdw_tuple_cost") == 0)
+			|| (strcmp(def->defname, "remote_cost_factor") == 0))
+			ifxGetFloatOption(def);
+
+		if (strcmp(def->defname, "extensions") == 0)
+			(void) ifxExtractExtensionList(defGetString(def), true);
+
+		/*
+		 * The directives are enclosed in {+ }, so they must not
+		 * terminate this comment.
+		 */
+		if ((strcmp(def->defname, "optimizer_directives") == 0)
+			&& (strpbrk(defGetString(def), "{}") != NULL))
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE),
+							errmsg("invalid value for option \"%s\": \"%s\"",
+								   def->defname, defGetString(def)),
+							errhint("Optimizer directives must not contain braces.")));
+	}
+
+	PG_RETURN_VOID();
+}
+
+/*
+ * Retrieves options for ifx_fdw foreign data wrapper.
+ */
+ static void
+ifxGetOptions(Oid foreigntableOid, IfxConnectionInfo *coninfo)
+{
+	ForeignTable  *foreignTable;
+	ForeignServer *foreignServer;
+	UserMapping   *userMap;
+	List          *options;
+	bool           mandatory[IFX_REQUIRED_CONN_KEYWORDS] = { false, false, false, false };
+	int            i;
+
+	Assert(coninfo != NULL);
+
+	foreignTable  = GetForeignTable(foreigntableOid);
+	foreignServer = GetForeignServer(foreignTable->serverid);
+	userMap       = GetUserMapping(GetUserId(), foreignTable->serverid);
+
+	/*
+	 * Options of the foreign table are assigned last, so they
+	 * override the cost and planning options also allowed for the
+	 * foreign server. All other options are valid for a single
+	 * object only, the order doesn't matter for them.
+	 */
+	options = NIL;
+	options = list_concat(options, foreignServer->options);
+	options = list_concat(options, userMap->options);
+	options = list_concat(options, foreignTable->options);
+
+	/*
+	 * Retrieve required arguments.
+	 */
+	ifxAssignOptions(coninfo, options, mandatory);
+
+	if ((coninfo->query == NULL)
+		 && (coninfo->tablename == NULL))
+	{
+		ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
+						errmsg("invalid options for remote table \"%s\"",
+							   get_rel_name(foreignTable->relid)),
+						errdetail("either parameter \"query\" or \"table\" is missing")));
+	}
+
+	/*
+	 * Check for all other mandatory options
+	 */
+	for (i = 0; i < IFX_REQUIRED_CONN_KEYWORDS; i++)
+	{
+		if (!mandatory[i])
+			ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
+							errmsg("missing required FDW options (informixserver, informixdir, client_locale, database)")));
+	}
+
+}
+
+/*
+ * Returns a hashed identifier generate from the contents
+ * of buf with the prefix specified in p. p isn't allowed to
+ * be null, and neither buf. If one of the arguments are NULL or
+ * have a zero-length string specified, the function will return NULL.
+ */
+__attribute__((unused)) static char * ifxHashIdentifier(StringInfoData *buf, char *prefix) {
+
+	char *result;
+	size_t ident_len = 0;
+	uint32 key;
+
+	if ((buf == NULL) || (prefix == NULL))
+		return NULL;
+
+	if (strlen(prefix) <= 0)
+		return NULL;
+
+	if (buf->len <= 0)
+		return NULL;
+
+	/*
+	 * Hash the identifier string.
+	 */
+	key = string_hash(buf->data, buf->len);
+
+	/*
+	 * Copy over the statement identifier in a
+	 * dynamically palloc'ed string buffer, since it might
+	 * get reused over various call sites until query/transaction
+	 * ends.
+	 */
+	ident_len = buf->len + strlen(prefix);
+	result = (char *) palloc0(ident_len + 1);
+	snprintf(result, ident_len, "%s%u",
+			 prefix, key);
+
+	return result;
+}
+
+/*
+ * Generate a unique statement identifier to create
+ * on the target database. Informix requires us to build
+ * a unique name among all concurrent connections.
+ *
+ * Returns a palloc'ed string containing a statement identifier
+ * suitable to pass to an Informix database.
+ */
+static char *ifxGenStatementName(int stmt_id)
+{
+	char *stmt_name = NULL;
+	StringInfoData *buf;
+
+	buf = makeStringInfo();
+	initStringInfo(buf);
+
+	appendStringInfo(buf, "s%d_%d",
+					 MyBackendId, stmt_id);
+
+	stmt_name = (char *) palloc0(buf->len + 1);
+	strncpy(stmt_name, buf->data, buf->len);
+
+	/*
+	 * Free temporary resources.
+	 */
+	resetStringInfo(buf);
+	pfree(buf);
+
+	if (stmt_name == NULL)
+		ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DESCRIPTOR_FIELD_IDENTIFIER),
+						errmsg("could not generate informix identifier for statement")));
+
+	elog(DEBUG5, "generated statement name %s", stmt_name);
+
+	return stmt_name;
+}
+
+static char *ifxGenDescrName(int descr_id)
+{
+	char *descr_name = NULL;
+	StringInfoData *buf;
+
+	buf = makeStringInfo();
+	initStringInfo(buf);
+
+	appendStringInfo(buf, "d%d_%d",
+					 MyBackendId, descr_id);
+
+	descr_name = (char *) palloc0(buf->len + 1);
+	strncpy(descr_name, buf->data, buf->len);
+
+	/*
+	 * Free temporary resources.
+	 */
+	resetStringInfo(buf);
+	pfree(buf);
+
+	if (descr_name == NULL)
+		ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DESCRIPTOR_FIELD_IDENTIFIER),
+						errmsg("could not generate informix descriptor identifier for statement")));
+
+	elog(DEBUG5, "generated descriptor name %s", descr_name);
+
+	return descr_name;
+}
+
+
+/*
+ * Generate a unique cursor identifier
+ *
+ * The specified curid should be a unique number
+ * identifying the returned cursor name uniquely throughout
+ * the backend.
+ */
+static char *ifxGenCursorName(int curid)
+{
+	char *cursor_name = NULL;
+	StringInfoData *buf;
+
+	buf = makeStringInfo();
+	initStringInfo(buf);
+
+	appendStringInfo(buf, "c%d_%d",
+					 MyBackendId, curid);
+
+	cursor_name = (char *) palloc0(buf->len + 1);
+	strncpy(cursor_name, buf->data, buf->len);
+
+	/*
+	 * Free temporary resources.
+	 */
+	resetStringInfo(buf);
+	pfree(buf);
+
+	if (cursor_name == NULL)
+		ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DESCRIPTOR_FIELD_IDENTIFIER),
+						errmsg("could not generate informix cursor identifier for statement")));
+
+	elog(DEBUG5, "generated cursor name %s", cursor_name);
+
+	return cursor_name;
+}
+
+/*
+ * Generate the name of the n-th key set table of the foreign
+ * scan with the specified range table index.
+ *
+ * The name is the same each time a query is planned, so that
+ * EXPLAIN and the row feedback see the same query text. The scan
+ * uses a table private to it, see ifxGenScanKeySetNames().
+ */
+static char *ifxGenKeySetName(Oid elemtype, Index rtindex, int n)
+{
+	StringInfoData buf;
+
+	initStringInfo(&buf);
+	appendStringInfo(&buf, "pgifx_ks%u_%u_%d",
+					 elemtype, rtindex, n);
+
+	elog(DEBUG5, "generated key set table name %s", buf.data);
+
+	return buf.data;
+}
+
+/*
+ * Generate the names of the key set tables of a foreign scan
+ * from the names generated at plan time. Temporary tables are
+ * private to the Informix session only, but scans of the same
+ * query might be open at the same time on one connection, e.g.
+ * with two cursors. The refid of the scan is unique on its
+ * connection, so it is appended to each name.
+ */
+static List *ifxGenScanKeySetNames(List *names, int refid)
+{
+	List     *scan_names = NIL;
+	ListCell *cell;
+
+	foreach(cell, names)
+	{
+		StringInfoData buf;
+
+		initStringInfo(&buf);
+		appendStringInfo(&buf, "%s_%d", (char *) lfirst(cell), refid);
+
+		elog(DEBUG5, "generated key set table name %s", buf.data);
+
+		scan_names = lappend(scan_names, buf.data);
+	}
+
+	return scan_names;
+}
+
+/*
+ * Checks wether the planner optimizes the query for its first
+ * rows, e.g. because of LIMIT or a cursor, and the foreign table
+ * is the only relation scanned. A join or a sort might consume all
+ * rows of the scan otherwise.
+ */
+static bool ifxWantsFirstRows(PlannerInfo *root)
+{
+	int nrels = 0;
+	int i;
+
+	if (root->tuple_fraction <= 0.0)
+		return false;
+
+	for (i = 1; i < root->simple_rel_array_size; i++)
+	{
+		RelOptInfo *rel = root->simple_rel_array[i];
+
+		if ((rel != NULL) && (rel->reloptkind == RELOPT_BASEREL))
+			nrels++;
+	}
+
+	return (nrels == 1);
+}
+
+/*
+ * Returns the optimizer directives for the remote query of a scan:
+ * FIRST_ROWS if the scan is expected to be stopped early, ALL_ROWS
+ * otherwise, followed by the directives of the optimizer_directives
+ * option. An optimization goal given by the option takes precedence.
+ */
+static char *ifxOptimizerDirectives(IfxConnectionInfo *coninfo,
+									bool first_rows)
+{
+	StringInfoData  buf;
+	char           *user_directives = coninfo->optimizer_directives;
+
+	initStringInfo(&buf);
+
+	if (user_directives != NULL)
+	{
+		char *upper = pstrdup(user_directives);
+		char *ptr;
+
+		for (ptr = upper; *ptr != '\0'; ptr++)
+			*ptr = pg_toupper((unsigned char) *ptr);
+
+		if ((strstr(upper, "FIRST_ROWS") == NULL)
+			&& (strstr(upper, "ALL_ROWS") == NULL))
+			appendStringInfo(&buf, "%s, ",
+							 first_rows ? "FIRST_ROWS" : "ALL_ROWS");
+
+		appendStringInfoString(&buf, user_directives);
+	}
+	else
+		appendStringInfoString(&buf, first_rows ? "FIRST_ROWS" : "ALL_ROWS");
+
+	return buf.data;
+}
+
+/*
+ * Prepare informix query object identifier
+ */
+static void ifxPrepareParamsForScan(IfxFdwExecutionState *state,
+									IfxConnectionInfo *coninfo)
+{
+	StringInfoData *buf;
+	char           *rowid_str;
+	char           *predicate;
+	StringInfoData  directives_str;
+
+	buf = makeStringInfo();
+	initStringInfo(buf);
+
+	/*
+	 * The WHERE clause is made up of the predicate and the semi
+	 * joins against the key set tables, if any.
+	 */
+	if (!coninfo->predicate_pushdown)
+		predicate = NULL;
+	else if ((state->stmt_info.predicate != NULL)
+			 && (strlen(state->stmt_info.predicate) > 0))
+		predicate = state->stmt_info.predicate;
+	else if (state->keyset_names != NIL)
+		predicate = "";
+	else
+		predicate = NULL;
+
+	/*
+	 * Optimizer directives follow the SELECT keyword.
+	 */
+	initStringInfo(&directives_str);
+
+	if (state->stmt_info.directives != NULL)
+		appendStringInfo(&directives_str, "{+%s} ",
+						 state->stmt_info.directives);
+
+	/*
+	 * We depend on ROWID per default.
+	 */
+	if (state->use_rowid == 1)
+		rowid_str = ", rowid";
+	else
+		rowid_str = "";
+
+	/*
+	 * Record the given query and pass it over
+	 * to the state structure.
+	 */
+	if (coninfo->query)
+	{
+		/*
+		 * IMPORTANT: When a query was specified, we don't
+		 *            retrieve the ROWID. This doesn't matter here,
+		 *            since we don't support modifying such
+		 *            a foreign table anyways. Force disabling rowid
+		 *            in this case to be consistent regardless.
+		 */
+		state->use_rowid = 0;
+
+		if (predicate != NULL)
+		{
+			appendStringInfo(buf, "%s WHERE %s",
+							 coninfo->query,
+							 predicate);
+		}
+		else
+		{
+			appendStringInfo(buf, "%s",
+							 coninfo->query);
+		}
+	}
+	else
+	{
+		/*
+		 * NOTE:
+		 *
+		 * Don't declare the query as READ ONLY. We can't really
+		 * distinguish wether the scan is related to a DELETE or UPDATE.
+		 *
+		 * XXX:
+		 *
+		 * We declare the Informix transaction with REPEATABLE READ
+		 * isolation level. Consider different modes here, e.g. FOR UPDATE
+		 * with READ COMMITTED...
+		 *
+		 * In case disable_rowid was specified, we cannot rely on the
+		 * ROWID (for example, if fragmented tables are used on the Informix
+		 * server).
+		 */
+		if (predicate != NULL)
+		{
+			appendStringInfo(buf, "SELECT %s*%s FROM %s WHERE %s",
+							 directives_str.data,
+							 rowid_str,
+							 ifxQuoteIdent(coninfo, coninfo->tablename),
+							 predicate);
+		}
+		else
+		{
+			appendStringInfo(buf, "SELECT %s*%s FROM %s",
+							 directives_str.data,
+							 rowid_str,
+							 ifxQuoteIdent(coninfo, coninfo->tablename));
+		}
+	}
+
+	/*
+	 * The semi joins against the key set tables are deparsed last,
+	 * the scan deparses them again with the names of the tables it
+	 * creates in place of the ones deparsed here, see
+	 * ifxBeginForeignScan().
+	 */
+	if (state->keyset_names != NIL)
+	{
+		if (strlen(predicate) > 0)
+			appendStringInfoString(buf, " AND ");
+
+		state->keyset_start = buf->len;
+		ifxDeparseKeySetExprs(buf, state->keyset_columns,
+							  state->keyset_names);
+		state->keyset_end   = buf->len;
+	}
+
+	/*
+	 * In case we got a foreign scan initiated by
+	 * an UPDATE/DELETE DML command, we need to do a
+	 * FOR UPDATE, otherwise the cursor won't be updatable
+	 * later in the modify actions.
+	 */
+	if (state->stmt_info.cursorUsage == IFX_UPDATE_CURSOR)
+	{
+		appendStringInfoString(buf, " FOR UPDATE");
+	}
+
+	state->stmt_info.query = buf->data;
+
+	/*
+	 * Save the connection identifier.
+	 */
+	StrNCpy(state->stmt_info.conname, coninfo->conname, IFX_CONNAME_LEN);
+}
+
+/*
+ * ifxBeginForeignScan
+ *
+ * Implements FDW BeginForeignScan callback function.
+ */
+static void
+ifxBeginForeignScan(ForeignScanState *node, int eflags)
+{
+	IfxConnectionInfo    *coninfo;
+	IfxFdwExecutionState *festate;
+	__attribute__((unused)) IfxCachedConnection  *cached;
+	Oid                   foreignTableOid;
+	bool                  conn_cached;
+	bool                  described;
+	List                 *plan_values;
+
+	elog(DEBUG3, "informix_fdw: begin scan");
+
+	plan_values = PG_SCANSTATE_PRIVATE_P(node);
+	foreignTableOid = ifxGetForeignScanTableOid(node);
+	Assert((foreignTableOid != InvalidOid));
+	coninfo = ifxMakeConnectionInfo(foreignTableOid);
+
+	/* Initialize generic execution state structure */
+	festate = makeIfxFdwExecutionState(-1);
+
+	/*
+	 * A scan planned from local statistics (see use_remote_estimate)
+	 * has no statement reference id and might not even have a
+	 * connection to the Informix server yet.
+	 */
+	if ((plan_values != NIL)
+		&& (ifxGetSerializedInt32Field(plan_values, SERIALIZED_REFID) < 0))
+	{
+		node->fdw_state = (void *) festate;
+		ifxDeserializeFdwData(festate, plan_values);
+
+		/* EXPLAIN without ANALYZE doesn't need the Informix server */
+		if (eflags & EXEC_FLAG_EXPLAIN_ONLY)
+		{
+			elog(DEBUG1, "informix_fdw: explain only");
+			return;
+		}
+
+		/*
+		 * Establish the connection and start a transaction if
+		 * required. IFX_PLAN_SCAN gets us a new refid.
+		 */
+		cached = ifxSetupConnection(&coninfo, foreignTableOid,
+									IFX_PLAN_SCAN, true);
+		festate->stmt_info.refid = cached->con.usage;
+	}
+	else
+	{
+		/*
+		 * Tell the connection cache that we are about to start to scan
+		 * the remote table.
+		 */
+		coninfo->scan_mode = IFX_BEGIN_SCAN;
+
+		/*
+		 * We should have a cached connection entry for the requested table.
+		 */
+		cached = ifxConnCache_add(foreignTableOid, coninfo,
+								  &conn_cached);
+
+		/* should not happen here */
+		Assert(conn_cached && cached != NULL);
+
+		/*
+		 * Make the connection current (otherwise we might
+		 * get confused).
+		 */
+		if (conn_cached)
+		{
+			ifxSetConnection(coninfo);
+		}
+
+		/*
+		 * Check connection status.
+		 */
+		if ((ifxConnectionStatus() != IFX_CONNECTION_OK)
+			&& (ifxConnectionStatus() != IFX_CONNECTION_WARN))
+		{
+			elog(ERROR, "could not set requested informix connection");
+		}
+
+		/*
+		 * Record our FDW state structures.
+		 */
+		node->fdw_state = (void *) festate;
+
+		/*
+		 * Cached plan data present?
+		 */
+		if (PG_SCANSTATE_PRIVATE_P(node) != NULL)
+		{
+			/*
+			 * Retrieved cached parameters formerly prepared
+			 * by ifxPlanForeignScan().
+			 */
+			ifxDeserializeFdwData(festate, plan_values);
+		}
+	}
+
+	/*
+	 * Save the connection identifier, required to find
+	 * a cached statement.
+	 */
+	StrNCpy(festate->stmt_info.conname, coninfo->conname, IFX_CONNAME_LEN);
+
+#if PG_VERSION_NUM >= 90200
+	/*
+	 * The query can't be prepared without the key set tables.
+	 * Each scan creates its own tables, named after the refid
+	 * of the scan, and drops them at its end. The semi joins
+	 * against them are deparsed with these names in place of
+	 * the ones deparsed at plan time, see ifxPrepareParamsForScan().
+	 * The query sent to the Informix server differs from the plan
+	 * only, stmt_info.query keeps the text from the plan. Since
+	 * the text sent never repeats, the statement isn't cached.
+	 */
+	if (festate->keyset_names != NIL)
+	{
+		List           *fdw_exprs = ((ForeignScan *) node->ss.ps.plan)->fdw_exprs;
+		char           *query     = festate->stmt_info.query;
+		StringInfoData  buf;
+
+		/* key set scans are always planned without a refid */
+		Assert(festate->stmt_info.call_stack == IFX_STACK_EMPTY);
+
+		festate->keyset_names = ifxGenScanKeySetNames(festate->keyset_names,
+													  festate->stmt_info.refid);
+
+		ifxCreateKeySetTables(&festate->stmt_info,
+							  festate->keyset_names,
+							  list_copy_tail(fdw_exprs,
+											 list_length(fdw_exprs)
+											 - list_length(festate->keyset_names)));
+
+		initStringInfo(&buf);
+		appendBinaryStringInfo(&buf, query, festate->keyset_start);
+		ifxDeparseKeySetExprs(&buf, festate->keyset_columns,
+							  festate->keyset_names);
+		appendStringInfoString(&buf, query + festate->keyset_end);
+
+		festate->stmt_info.query = buf.data;
+		ifxPrepareCursorForScan(&festate->stmt_info, coninfo);
+		festate->stmt_info.query = query;
+	}
+#endif
+
+	/*
+	 * Recheck if everything is already prepared on the
+	 * informix server. If not, we are either in a rescan condition
+	 * or a cached query plan is used. Redo all necessary preparation
+	 * previously done in the planning state. We do this to save
+	 * some cycles when just doing plain SELECTs.
+	 */
+	if (festate->stmt_info.call_stack == IFX_STACK_EMPTY)
+		ifxPrepareCachedCursorForScan(&festate->stmt_info, coninfo);
+
+	/*
+	 * Get the definition of the local foreign table attributes.
+	 */
+#if PG_VERSION_NUM >= 90600
+	if (node->ss.ss_currentRelation == NULL)
+		ifxPgColumnDataFromTupleDesc(node->ss.ss_ScanTupleSlot->tts_tupleDescriptor,
+									 festate);
+	else
+#endif
+		ifxPgColumnData(foreignTableOid, festate);
+
+	/* EXPLAIN without ANALYZE... */
+	if (eflags & EXEC_FLAG_EXPLAIN_ONLY)
+	{
+		elog(DEBUG1, "informix_fdw: explain only");
+		return;
+	}
+
+	/*
+	 * A statement from the statement cache might have been
+	 * DESCRIBEd by an earlier scan already, reuse its
+	 * descriptor area then.
+	 */
+	described = ifxAcquireCachedStatement(&festate->stmt_info, coninfo);
+
+	if (!described)
+	{
+		/*
+		 * Populate the DESCRIPTOR area.
+		 */
+		elog(DEBUG1, "populate descriptor area for statement \"%s\"",
+			 festate->stmt_info.stmt_name);
+		ifxDescribeAllocatorByName(&festate->stmt_info);
+		ifxCatchExceptions(&festate->stmt_info, IFX_STACK_ALLOCATE | IFX_STACK_DESCRIBE);
+
+		/*
+		 * Get the number of columns.
+		 */
+		festate->stmt_info.ifxAttrCount = ifxDescriptorColumnCount(&festate->stmt_info);
+		elog(DEBUG1, "get descriptor column count %d",
+			 festate->stmt_info.ifxAttrCount);
+		ifxCatchExceptions(&festate->stmt_info, 0);
+	}
+
+	/*
+	 * XXX: It makes no sense to have a local column list with *more*
+	 * columns than the remote table. I can't think of any use case
+	 * for this atm, anyone?
+	 */
+	if (PG_VALID_COLS_COUNT(festate) > festate->stmt_info.ifxAttrCount)
+	{
+		ifxRewindCallstack(&(festate->stmt_info));
+		ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
+						errmsg("foreign table \"%s\" has more columns than remote source",
+							   get_rel_name(foreignTableOid))));
+	}
+
+	if (!described)
+	{
+		festate->stmt_info.ifxAttrDefs = palloc(festate->stmt_info.ifxAttrCount
+												* sizeof(IfxAttrDef));
+
+		/*
+		 * Populate result set column info array.
+		 */
+		if ((festate->stmt_info.row_size = ifxGetColumnAttributes(&festate->stmt_info)) == 0)
+		{
+			/* oops, no memory to allocate? Something surely went wrong,
+			 * so abort */
+			ifxRewindCallstack(&festate->stmt_info);
+			ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
+							errmsg("could not initialize informix column properties")));
+		}
+	}
+
+	/*
+	 * Throw an error in case we select from a relation with
+	 * BLOB types and enable_blobs FDW option is unset. We must not
+	 * use a SCROLL cursor in this case. Switching the cursor options
+	 * at this point is too late, since we already DESCRIBEd and PREPAREd
+	 * the cursor. Alternatively, we could re-PREPARE the cursor as a
+	 * NO SCROLL cursor again, but this strikes me as too dangerous (consider
+	 * changing table definitions in the meantime).
+	 *
+	 * NOTE: A non-scrollable cursor requires a serialized transaction to
+	 *       be safe. However, we don't enforce this isolation atm, since
+	 *       Informix databases with no logging would not be queryable at all.
+	 *       But someone have to keep in mind, that a ReScan of the foreign
+	 *       table could lead to inconsistent data due to changed results
+	 *       sets.
+	 */
+	if ((festate->stmt_info.special_cols & IFX_HAS_BLOBS)
+		&& (festate->stmt_info.cursorUsage == IFX_SCROLL_CURSOR))
+	{
+		ifxRewindCallstack(&festate->stmt_info);
+		ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
+						errmsg("could not use a SCROLL cursor to query an "
+							   "informix table with blobs"),
+						errhint("set enable_blobs=1 to your foreign table "
+								"to use a NO SCROLL cursor")));
+	}
+
+	/*
+	 * Keep the descriptor area of a cached statement
+	 * for subsequent scans.
+	 */
+	if (!described)
+		ifxSaveCachedDescriptor(&festate->stmt_info);
+
+	/*
+	 * NOTE:
+	 *
+	 * ifxGetColumnAttributes() obtained all information about the
+	 * returned column and stored them within the informix SQLDA and
+	 * sqlvar structs. However, we don't want to allocate memory underneath
+	 * our current memory context, thus we allocate the required memory structure
+	 * on top here. ifxSetupDataBufferAligned() will assign the allocated
+	 * memory area to the SQLDA structure and will maintain the data offsets
+	 * properly aligned.
+	 */
+	festate->stmt_info.data = (char *) palloc0(festate->stmt_info.row_size);
+	festate->stmt_info.indicator = (short *) palloc0(sizeof(short)
+													 * festate->stmt_info.ifxAttrCount);
+
+	/*
+	 * Assign sqlvar pointers to the allocated memory area.
+	 */
+	ifxSetupDataBufferAligned(&festate->stmt_info);
+
+	/*
+	 * Open the cursor. If the query has parameters of pushed
+	 * down predicates or key sets, their values might not be
+	 * available yet (e.g. PARAM_EXEC params set by an outer
+	 * plan node), so opening the cursor is deferred to the
+	 * first call of ifxIterateForeignScan().
+	 */
+#if PG_VERSION_NUM >= 90200
+	ifxInitScanParams(node, festate);
+
+	if ((festate->nparams > 0)
+		|| (festate->keyset_exprs != NIL))
+	{
+		festate->open_pending = true;
+		return;
+	}
+#endif
+
+	elog(DEBUG1, "open cursor \"%s\"",
+		 festate->stmt_info.cursor_name);
+
+	ifxOpenCursorForPrepared(&festate->stmt_info);
+	ifxCatchExceptions(&festate->stmt_info, IFX_STACK_OPEN);
+
+}
+
+#if PG_VERSION_NUM >= 90200
+
+/*
+ * Initializes the expressions of the query parameters
+ * passed by ifxGetForeignPlan() in fdw_exprs. The arrays of
+ * the key sets, if any, follow the query parameters.
+ */
+static void ifxInitScanParams(ForeignScanState *node,
+							  IfxFdwExecutionState *state)
+{
+	ForeignScan *fsplan = (ForeignScan *) node->ss.ps.plan;
+	List        *exprs;
+
+	if (fsplan->fdw_exprs == NIL)
+		return;
+
+	state->nparams = list_length(fsplan->fdw_exprs)
+		- list_length(state->keyset_names);
+	state->params  = (IfxScanParam *) palloc0(sizeof(IfxScanParam)
+											  * state->nparams);
+
+#if PG_VERSION_NUM >= 100000
+	exprs = ExecInitExprList(fsplan->fdw_exprs,
+							 (PlanState *) node);
+#else
+	exprs = (List *) ExecInitExpr((Expr *) fsplan->fdw_exprs,
+								  (PlanState *) node);
+#endif
+
+	state->param_exprs  = list_truncate(list_copy(exprs), state->nparams);
+	state->keyset_exprs = list_copy_tail(exprs, state->nparams);
+}
+
+/*
+ * Computes the current values of the query parameters and
+ * opens the cursor of the foreign scan with them. The key set
+ * tables are loaded with the current keys before.
+ *
+ * The values are computed in the per-tuple memory context, the
+ * caller must make sure that it isn't reset before we are done.
+ */
+static void ifxOpenCursorForScanParams(ForeignScanState *node,
+									   IfxFdwExecutionState *state)
+{
+	ExprContext  *econtext = node->ss.ps.ps_ExprContext;
+	MemoryContext oldcxt;
+	ListCell     *cell;
+	int           i;
+	int           converrcode;
+	int           failed_param = 0;
+
+	oldcxt = MemoryContextSwitchTo(econtext->ecxt_per_tuple_memory);
+
+	ifxLoadKeySets(node, state);
+
+	i = 0;
+	foreach(cell, state->param_exprs)
+	{
+		ExprState *expr_state = (ExprState *) lfirst(cell);
+		Datum      value;
+		bool       isnull;
+
+#if PG_VERSION_NUM >= 100000
+		value = ExecEvalExpr(expr_state, econtext, &isnull);
+#else
+		value = ExecEvalExpr(expr_state, econtext, &isnull, NULL);
+#endif
+
+		if (!ifxScanParamFromDatum(&state->params[i],
+								   exprType((Node *) expr_state->expr),
+								   value, isnull))
+		{
+			ifxRewindCallstack(&state->stmt_info);
+			ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DATA_TYPE),
+							errmsg("could not convert value of query parameter %d for the Informix server",
+								   i + 1)));
+		}
+
+		i++;
+	}
+
+	MemoryContextSwitchTo(oldcxt);
+
+	if (state->nparams == 0)
+	{
+		ifxOpenCursorForPrepared(&state->stmt_info);
+		return;
+	}
+
+	if ((converrcode = ifxOpenCursorWithParams(&state->stmt_info,
+											   state->params,
+											   state->nparams,
+											   &failed_param)) != 0)
+	{
+		ifxRewindCallstack(&state->stmt_info);
+		ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DATA_TYPE),
+						errmsg("could not convert value of query parameter %d for the Informix server",
+							   failed_param + 1),
+						errdetail("informix conversion error %d", converrcode)));
+	}
+}
+
+/*
+ * Loads the current keys of the key sets of a foreign scan into
+ * their key set tables, replacing the keys of a former scan. The
+ * keys are sent through an INSERT cursor, which buffers them and
+ * transfers many rows at once. NULL keys never match and are
+ * skipped, as well as NaN numeric values unknown to Informix.
+ */
+static void ifxLoadKeySets(ForeignScanState *node,
+						   IfxFdwExecutionState *state)
+{
+	ExprContext *econtext = node->ss.ps.ps_ExprContext;
+	ListCell    *name_cell;
+	ListCell    *expr_cell;
+
+	forboth(name_cell, state->keyset_names, expr_cell, state->keyset_exprs)
+	{
+		char             *tablename  = (char *) lfirst(name_cell);
+		ExprState        *expr_state = (ExprState *) lfirst(expr_cell);
+		IfxStatementInfo  info;
+		IfxScanParam      param;
+		StringInfoData    buf;
+		Datum             value;
+		bool              isnull;
+		ArrayType        *array;
+		Oid               elemtype;
+		int16             elemlen;
+		bool              elembyval;
+		char              elemalign;
+		Datum            *elems;
+		bool             *elemnulls;
+		int               nelems;
+		int               nkeys;
+		int               i;
+
+#if PG_VERSION_NUM >= 100000
+		value = ExecEvalExpr(expr_state, econtext, &isnull);
+#else
+		value = ExecEvalExpr(expr_state, econtext, &isnull, NULL);
+#endif
+
+		initStringInfo(&buf);
+		appendStringInfo(&buf, "DELETE FROM %s", tablename);
+
+		ifxExecuteImmediate(buf.data);
+		ifxCatchExceptions(&state->stmt_info, 0);
+
+		/* = ANY(NULL) never matches */
+		if (isnull)
+			continue;
+
+		array    = DatumGetArrayTypeP(value);
+		elemtype = ARR_ELEMTYPE(array);
+
+		get_typlenbyvalalign(elemtype, &elemlen, &elembyval, &elemalign);
+		deconstruct_array(array, elemtype, elemlen, elembyval, elemalign,
+						  &elems, &elemnulls, &nelems);
+
+		if (nelems == 0)
+			continue;
+
+		/*
+		 * The INSERT cursor gets its own statement and cursor
+		 * identifiers, derived from the table name.
+		 */
+		ifxStatementInfoInit(&info, state->stmt_info.refid);
+		StrNCpy(info.conname, state->stmt_info.conname, IFX_CONNAME_LEN);
+		info.cursorUsage = IFX_INSERT_CURSOR;
+
+		resetStringInfo(&buf);
+		appendStringInfo(&buf, "s_%s", tablename);
+		info.stmt_name = pstrdup(buf.data);
+
+		resetStringInfo(&buf);
+		appendStringInfo(&buf, "c_%s", tablename);
+		info.cursor_name = pstrdup(buf.data);
+
+		resetStringInfo(&buf);
+		appendStringInfo(&buf, "INSERT INTO %s VALUES (?)", tablename);
+
+		ifxPrepareQuery(buf.data, info.stmt_name);
+		ifxCatchExceptions(&info, IFX_STACK_PREPARE);
+
+		ifxDeclareCursorForPrepared(info.stmt_name, info.cursor_name,
+									info.cursorUsage);
+		ifxCatchExceptions(&info, IFX_STACK_DECLARE);
+
+		ifxOpenCursorForPrepared(&info);
+		ifxCatchExceptions(&info, IFX_STACK_OPEN);
+
+		nkeys = 0;
+		for (i = 0; i < nelems; i++)
+		{
+			if (elemnulls[i]
+				|| !ifxScanParamFromDatum(&param, elemtype, elems[i], false))
+				continue;
+
+			if (ifxPutParams(&info, &param, 1) != 0)
+			{
+				ifxRewindCallstack(&info);
+				ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DATA_TYPE),
+								errmsg("could not convert key into an Informix value")));
+			}
+
+			ifxCatchExceptions(&info, 0);
+			nkeys++;
+		}
+
+		ifxFlushCursor(&info);
+		ifxCatchExceptions(&info, 0);
+
+		/* closes the cursor and frees the statement */
+		ifxRewindCallstack(&info);
+
+		elog(DEBUG2, "informix_fdw: loaded %d keys into key set table \"%s\"",
+			 nkeys, tablename);
+	}
+}
+
+/*
+ * Creates the key set tables with the specified names on the
+ * Informix server, if they don't exist yet. keys holds the array
+ * expressions of the key sets, which determine the column types.
+ */
+static void ifxCreateKeySetTables(IfxStatementInfo *info,
+								  List *names,
+								  List *keys)
+{
+	IfxCachedConnection *cached;
+	ListCell            *name_cell;
+	ListCell            *keys_cell;
+	StringInfoData       buf;
+	bool                 found;
+
+	cached = ifxConnCache_exists(info->conname, &found);
+
+	initStringInfo(&buf);
+
+	forboth(name_cell, names, keys_cell, keys)
+	{
+		Oid elemtype = get_element_type(exprType((Node *) lfirst(keys_cell)));
+
+		resetStringInfo(&buf);
+		appendStringInfo(&buf, "CREATE TEMP TABLE %s (k %s) WITH NO LOG",
+						 (char *) lfirst(name_cell),
+						 ifxKeySetColumnType(elemtype));
+
+		elog(DEBUG2, "informix_fdw: create key set table \"%s\"",
+			 (char *) lfirst(name_cell));
+
+		ifxExecuteImmediate(buf.data);
+
+		if (ifxGetSqlCode() != IFX_TABLE_EXISTS)
+			ifxCatchExceptions(info, 0);
+
+		/* dropped by the transaction callbacks in case of an error */
+		if (found)
+			ifxKeySetCache_add(cached, (char *) lfirst(name_cell),
+							   GetCurrentSubTransactionId());
+	}
+}
+
+/*
+ * Drops the specified key set table on the current connection.
+ * Errors are ignored, the temporary tables vanish with the
+ * Informix session anyways. This is also called during abort,
+ * so don't throw an error here.
+ */
+static void ifxDropKeySetTable(char *tablename)
+{
+	StringInfoData buf;
+
+	initStringInfo(&buf);
+	appendStringInfo(&buf, "DROP TABLE %s", tablename);
+
+	ifxExecuteImmediate(buf.data);
+
+	if (ifxGetSqlCode() < 0)
+		elog(DEBUG1, "informix_fdw: \"%s\" failed with SQLCODE=%d",
+			 buf.data, ifxGetSqlCode());
+
+	pfree(buf.data);
+}
+
+/*
+ * Drops the key set tables of a foreign scan at its end, they are
+ * private to the scan.
+ */
+static void ifxDisposeKeySetTables(IfxFdwExecutionState *state)
+{
+	IfxCachedConnection *cached;
+	ListCell            *cell;
+	bool                 found;
+
+	cached = ifxConnCache_exists(state->stmt_info.conname, &found);
+
+	foreach(cell, state->keyset_names)
+	{
+		ifxDropKeySetTable((char *) lfirst(cell));
+
+		if (found)
+			ifxKeySetCache_rm(cached, (char *) lfirst(cell));
+	}
+}
+
+/*
+ * Drops the key set tables left behind on the specified connection
+ * by foreign scans aborted by an error, which never reached
+ * ifxEndForeignScan(). Only the tables created by the subtransaction
+ * subid and its children are dropped, all of them if subid is
+ * InvalidSubTransactionId. Called by the transaction callbacks after
+ * the remote transaction was rolled back, which might have dropped
+ * the tables already.
+ */
+static void ifxDropAbortedKeySets(IfxCachedConnection *cached,
+								  SubTransactionId subid)
+{
+	ListCell *cell;
+	ListCell *next;
+	ListCell *prev;
+
+	if (cached->keysets == NIL)
+		return;
+
+	if (ifxSetConnectionIdent(cached->con.ifx_connection_name) < 0)
+	{
+		elog(DEBUG1, "informix_fdw: could not drop key set tables on connection \"%s\"",
+			 cached->con.ifx_connection_name);
+		return;
+	}
+
+	prev = NULL;
+
+	for (cell = list_head(cached->keysets); cell != NULL; cell = next)
+	{
+		IfxCachedKeySet *keyset = (IfxCachedKeySet *) lfirst(cell);
+
+		next = lnext(cell);
+
+		if (keyset->subid < subid)
+		{
+			prev = cell;
+			continue;
+		}
+
+		ifxDropKeySetTable(keyset->tablename);
+
+		cached->keysets = list_delete_cell(cached->keysets, cell, prev);
+		pfree(keyset->tablename);
+		pfree(keyset);
+	}
+}
+
+/*
+ * Drops the key set tables left behind by aborted foreign scans
+ * on all cached connections, see ifxDropAbortedKeySets().
+ */
+static void ifxCleanupKeySets(SubTransactionId subid)
+{
+	HASH_SEQ_STATUS      hsearch_status;
+	IfxCachedConnection *cached;
+
+	if (!IfxCacheIsInitialized)
+		return;
+
+	hash_seq_init(&hsearch_status, ifxCache.connections);
+	while ((cached = (IfxCachedConnection *) hash_seq_search(&hsearch_status)))
+	{
+		ifxDropAbortedKeySets(cached, subid);
+	}
+}
+
+#endif
+
+/*
+ * Extract the corresponding Informix value for the given PostgreSQL attnum
+ * from the SQLDA structure. The specified attnum should be the target column
+ * of the local table definition and is translated internally to the matching
+ * source column on the remote table.
+ */
+static void ifxColumnValueByAttNum(IfxFdwExecutionState *state, int attnum,
+								   bool *isnull)
+{
+	Assert(state != NULL && attnum >= 0);
+	Assert(state->stmt_info.data != NULL);
+	Assert(state->values != NULL);
+	Assert(state->pgAttrDefs);
+
+	/*
+	 * Setup...
+	 */
+	state->values[PG_MAPPED_IFX_ATTNUM(state, attnum)].def
+		= &state->stmt_info.ifxAttrDefs[PG_MAPPED_IFX_ATTNUM(state, attnum)];
+	IFX_SETVAL_P(state, attnum, PointerGetDatum(NULL));
+	*isnull = false;
+
+	/*
+	 * Retrieve values from Informix and try to convert
+	 * into an appropiate PostgreSQL datum.
+	 */
+
+	switch (IFX_ATTRTYPE_P(state, attnum))
+	{
+		case IFX_FLOAT:
+		case IFX_SMFLOAT:
+		{
+			Datum dat;
+
+			dat = convertIfxFloat(state, attnum);
+			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+
+			/*
+			 * Check for errors. convertIfxFloatAsString() might
+			 * return NULL in case of an error, so make sure we
+			 * catch conversion errors.
+			 */
+			if (! IFX_ATTR_IS_VALID_P(state, attnum))
+			{
+				ifxRewindCallstack(&state->stmt_info);
+				elog(ERROR, "could not convert informix type id %d into pg type %u",
+					 IFX_ATTRTYPE_P(state, attnum),
+					 PG_ATTRTYPE_P(state, attnum));
+			}
+
+			IFX_SETVAL_P(state, attnum, dat);
+			break;
+		}
+		case IFX_SMALLINT:
+			/*
+			 * All int values are handled
+			 * by convertIfxInt()...so fall through.
+			 */
+		case IFX_INTEGER:
+		case IFX_SERIAL:
+		case IFX_INT8:
+		case IFX_SERIAL8:
+		case IFX_INFX_INT8:
+		{
+			Datum dat;
+
+			dat = convertIfxInt(state, attnum);
+			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+
+			/*
+			 * Check for errors, but only if we
+			 * didnt get a validated NULL attribute from
+			 * informix.
+			 */
+			if (! IFX_ATTR_IS_VALID_P(state, attnum))
+			{
+				ifxRewindCallstack(&state->stmt_info);
+				elog(ERROR, "could not convert informix type id %d into pg type %u",
+					 IFX_ATTRTYPE_P(state, attnum),
+					 PG_ATTRTYPE_P(state, attnum));
+			}
+
+			IFX_SETVAL_P(state, attnum, dat);
+			break;
+		}
+		case IFX_CHARACTER:
+		case IFX_VCHAR:
+		case IFX_NCHAR:
+		case IFX_LVARCHAR:
+		case IFX_NVCHAR:
+		{
+			/* SQLCHAR, SQLVCHAR, SQLNCHAR, SQLLVARCHAR, SQLNVCHAR */
+			Datum dat;
+
+			dat = convertIfxCharacterString(state, attnum);
+			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+
+			/*
+			 * Guard against invalid conversion
+			 * attempts.
+			 */
+			if (! IFX_ATTR_IS_VALID_P(state, attnum))
+			{
+				ifxRewindCallstack(&state->stmt_info);
+				ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DATA_TYPE),
+								errmsg("conversion in column \"%s\" with unsupported character type mapping",
+									   state->pgAttrDefs[attnum].attname)));
+			}
+
+			/*
+			 * At this point we never expect a NULL datum without
+			 * having retrieved NULL from informix. Check it.
+			 * If it's a validated NULL value from informix,
+			 * don't throw an error.
+			 */
+			if ((DatumGetPointer(dat) == NULL)
+				&& !*isnull)
+			{
+				ifxRewindCallstack(&state->stmt_info);
+				elog(ERROR, "could not convert informix character type into pg type %u",
+					 PG_ATTRTYPE_P(state, attnum));
+			}
+
+			IFX_SETVAL_P(state, attnum, dat);
+			break;
+		}
+		case IFX_BYTES:
+		case IFX_TEXT:
+		{
+			Datum dat;
+
+			dat = convertIfxSimpleLO(state, attnum);
+
+			/*
+			 * Check for invalid datum conversion.
+			 */
+			if (! IFX_ATTR_IS_VALID_P(state, attnum))
+			{
+				elog(ERROR, "could not convert informix LO type into pg type %u",
+					 PG_ATTRTYPE_P(state, attnum));
+			}
+
+			/*
+			 * Valid NULL datum?
+			 */
+			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+			IFX_SETVAL_P(state, attnum, dat);
+
+			break;
+		}
+		case IFX_BOOLEAN:
+		{
+			/* SQLBOOL value */
+			Datum dat;
+			dat = convertIfxBoolean(state, attnum);
+
+			/*
+			 * Unlike other types, a NULL datum is treated
+			 * like a normal FALSE value in case the indicator
+			 * value tells that we got a NOT NULL column.
+			 */
+			if (! IFX_ATTR_IS_VALID_P(state, attnum))
+			{
+				ifxRewindCallstack(&state->stmt_info);
+				elog(ERROR, "could not convert informix boolean into pg type %u",
+					 PG_ATTRTYPE_P(state, attnum));
+			}
+
+			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+			IFX_SETVAL_P(state, attnum, dat);
+
+			break;
+		}
+		case IFX_DATE:
+		{
+			/* SQLDATE value */
+			Datum dat;
+			dat = convertIfxDateString(state, attnum);
+
+			/*
+			 * Valid datum?
+			 */
+			if ((DatumGetPointer(dat) == NULL)
+				&& ! IFX_ATTR_IS_VALID_P(state, attnum))
+			{
+				ifxRewindCallstack(&state->stmt_info);
+				elog(ERROR, "could not convert informix date into pg type %u",
+					 PG_ATTRTYPE_P(state, attnum));
+			}
+
+			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+			IFX_SETVAL_P(state, attnum, dat);
+			break;
+		}
+		case IFX_DTIME:
+		{
+			/* SQLDTIME value */
+			Datum dat;
+			dat = convertIfxTimestampString(state, attnum);
+
+			/*
+			 * Valid datum?
+			 */
+			if ((DatumGetPointer(dat) == NULL)
+				&& ! IFX_ATTR_IS_VALID_P(state, attnum))
+			{
+				ifxRewindCallstack(&state->stmt_info);
+				elog(ERROR, "could not convert informix datetime into pg type %u",
+					 PG_ATTRTYPE_P(state, attnum));
+			}
+
+			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+			IFX_SETVAL_P(state, attnum, dat);
+			break;
+		}
+		case IFX_INTERVAL:
+		{
+			/* SQLINTERVAL value */
+			Datum dat;
+			dat = convertIfxInterval(state, attnum);
+
+			/* Valid datum ? */
+			if ((DatumGetPointer(dat) == NULL)
+				&& ! IFX_ATTR_IS_VALID_P(state, attnum))
+			{
+				ifxRewindCallstack(&state->stmt_info);
+				elog(ERROR, "could not convert informix interval into pg type %u",
+					 PG_ATTRTYPE_P(state, attnum));
+			}
+
+			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+			IFX_SETVAL_P(state, attnum, dat);
+			break;
+		}
+		case IFX_MONEY:
+		case IFX_DECIMAL:
+		{
+			/* DECIMAL value */
+			Datum dat;
+			dat = convertIfxDecimal(state, attnum);
+
+			/*
+			 * Valid datum?
+			 */
+			if ((DatumGetPointer(dat) == NULL)
+				&& ! IFX_ATTR_IS_VALID_P(state, attnum))
+			{
+				ifxRewindCallstack(&state->stmt_info);
+				elog(ERROR, "could not convert informix decimal into pg type %u",
+					 PG_ATTRTYPE_P(state, attnum));
+			}
+
+			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+			IFX_SETVAL_P(state, attnum, dat);
+			break;
+		}
+		default:
+		{
+			ifxRewindCallstack(&state->stmt_info);
+			elog(ERROR, "\"%d\" is not a known informix type id",
+				state->stmt_info.ifxAttrDefs[attnum].type);
+			break;
+		}
+	}
+}
+
+static void ifxEndForeignScan(ForeignScanState *node)
+{
+	IfxFdwExecutionState *state;
+	List                 *plan_values;
+	unsigned short        call_stack;
+
+	elog(DEBUG3, "informix_fdw: end scan");
+
+	state = (IfxFdwExecutionState *) node->fdw_state;
+	plan_values = PG_SCANSTATE_PRIVATE_P(node);
+
+	/*
+	 * A statement owned by the statement cache stays prepared on
+	 * the Informix server, only its cursor is closed below. If the
+	 * plan refers to this statement, it can be reused by the next
+	 * execution of the plan (e.g. EXECUTE of a prepared statement
+	 * or a loop in PL/pgSQL) without preparing it again. The plan
+	 * doesn't own the statement, so there's nothing to clean up when
+	 * the plan is dropped. ifxBeginForeignScan() prepares the query
+	 * again in case the statement was evicted from the cache or the
+	 * connection was closed meanwhile.
+	 */
+	call_stack = IFX_STACK_EMPTY;
+
+	if (((state->stmt_info.call_stack & IFX_STACK_CACHED) == IFX_STACK_CACHED)
+		&& (strcmp(state->stmt_info.stmt_name,
+				   ifxGetSerializedStringField(plan_values,
+											   SERIALIZED_STMT_NAME)) == 0))
+		call_stack = IFX_STACK_PREPARE | IFX_STACK_DECLARE | IFX_STACK_CACHED;
+
+	/*
+	 * Remember the number of rows of a completed scan
+	 * of the foreign table for later planning.
+	 */
+	if (state->scan_complete
+#if PG_VERSION_NUM >= 90600
+		&& (node->ss.ss_currentRelation != NULL)
+#endif
+		)
+		ifxRecordRowFeedback(ifxGetForeignScanTableOid(node), state);
+
+	/*
+	 * Dispose SQLDA resource, allocated database objects, ...
+	 */
+	ifxRewindCallstack(&state->stmt_info);
+
+#if PG_VERSION_NUM >= 90200
+	/*
+	 * The cursor is closed and the statement freed now, so the
+	 * key set tables of the scan can be dropped. A scan planned
+	 * from local statistics has no refid and hasn't created them
+	 * in EXPLAIN without ANALYZE.
+	 */
+	if ((state->keyset_names != NIL)
+		&& (state->stmt_info.refid >= 0))
+		ifxDisposeKeySetTables(state);
+#endif
+
+	/*
+	 * Save the callstack into cached plan structure. This
+	 * is necessary to teach ifxBeginForeignScan() to do the
+	 * right thing(tm)...
+	 */
+	ifxSetSerializedInt16Field(plan_values,
+							   SERIALIZED_CALLSTACK,
+							   call_stack);
+}
+
+static TupleTableSlot *ifxIterateForeignScan(ForeignScanState *node)
 {
+	TupleTableSlot       *tupleSlot = node->ss.ss_ScanTupleSlot;
+	Relation              rel       = node->ss.ss_currentRelation;
 	IfxConnectionInfo    *coninfo;
-	IfxFdwExecutionState *festate;
-	__attribute__((unused)) IfxCachedConnection  *cached;
+	IfxFdwExecutionState *state;
+	IfxSqlStateClass      errclass;
 	Oid                   foreignTableOid;
 	bool                  conn_cached;
-	List                 *plan_values;
 
-	elog(DEBUG3, "informix_fdw: begin scan");
+	state = (IfxFdwExecutionState *) node->fdw_state;
 
-	plan_values = PG_SCANSTATE_PRIVATE_P(node);
-	foreignTableOid = RelationGetRelid(node->ss.ss_currentRelation);
-	Assert((foreignTableOid != InvalidOid));
-	coninfo = ifxMakeConnectionInfo(foreignTableOid);
+	elog(DEBUG3, "informix_fdw: iterate scan");
 
 	/*
-	 * Tell the connection cache that we are about to start to scan
-	 * the remote table.
+	 * Make the informix connection belonging to this
+	 * iteration current.
 	 */
-	coninfo->scan_mode = IFX_BEGIN_SCAN;
+	foreignTableOid = ifxGetForeignScanTableOid(node);
+	coninfo= ifxMakeConnectionInfo(foreignTableOid);
 
 	/*
-	 * We should have a cached connection entry for the requested table.
+	 * Set appropiate scan mode.
 	 */
-	cached = ifxConnCache_add(foreignTableOid, coninfo,
-							  &conn_cached);
-
-	/* should not happen here */
-	Assert(conn_cached && cached != NULL);
+	coninfo->scan_mode = IFX_ITERATE_SCAN;
 
-	/* Initialize generic execution state structure */
-	festate = makeIfxFdwExecutionState(-1);
+	/*
+	 * ...and get the handle.
+	 */
+	ifxConnCache_add(foreignTableOid, coninfo, &conn_cached);
 
 	/*
 	 * Make the connection current (otherwise we might
@@ -4415,788 +9117,945 @@ ifxBeginForeignScan(ForeignScanState *node, int eflags)
 	}
 
 	/*
-	 * Record our FDW state structures.
+	 * Prepare a virtual tuple.
 	 */
-	node->fdw_state = (void *) festate;
+	ExecClearTuple(tupleSlot);
 
+#if PG_VERSION_NUM >= 90200
 	/*
-	 * Cached plan data present?
+	 * A cursor with query parameters is opened on the first call,
+	 * since the values of the parameters aren't available before.
+	 * Query parameters might also have changed their values in a
+	 * rescan, so the cursor must be reopened with the current
+	 * values. This can't be done by ifxReScanForeignScan(), since
+	 * the per-tuple memory context gets reset before we are called.
+	 * The same applies to the keys of key sets.
 	 */
-	if (PG_SCANSTATE_PRIVATE_P(node) != NULL)
+	if ((state->open_pending || state->rescan)
+		&& ((state->nparams > 0) || (state->keyset_exprs != NIL)))
 	{
-		/*
-		 * Retrieved cached parameters formerly prepared
-		 * by ifxPlanForeignScan().
-		 */
-		ifxDeserializeFdwData(festate, plan_values);
-	}
+		if ((state->stmt_info.call_stack & IFX_STACK_OPEN) == IFX_STACK_OPEN)
+		{
+			elog(DEBUG3, "re-opening informix cursor with current parameter values");
+			ifxCloseCursor(&state->stmt_info);
+			ifxCatchExceptions(&state->stmt_info, 0);
 
-	/*
-	 * Recheck if everything is already prepared on the
-	 * informix server. If not, we are either in a rescan condition
-	 * or a cached query plan is used. Redo all necessary preparation
-	 * previously done in the planning state. We do this to save
-	 * some cycles when just doing plain SELECTs.
-	 */
-	if (festate->stmt_info.call_stack == IFX_STACK_EMPTY)
-		ifxPrepareCursorForScan(&festate->stmt_info, coninfo);
+			ifxOpenCursorForScanParams(node, state);
+			ifxCatchExceptions(&state->stmt_info, 0);
+		}
+		else
+		{
+			elog(DEBUG1, "open cursor \"%s\"",
+				 state->stmt_info.cursor_name);
+
+			ifxOpenCursorForScanParams(node, state);
+			ifxCatchExceptions(&state->stmt_info, IFX_STACK_OPEN);
+		}
+
+		state->open_pending = false;
+		state->rescan = false;
+	}
+#endif
 
 	/*
-	 * Get the definition of the local foreign table attributes.
+	 * Catch any informix exception. We also need to
+	 * check for IFX_NOT_FOUND, in which case no more rows
+	 * must be processed.
 	 */
-	ifxPgColumnData(foreignTableOid, festate);
+	errclass = ifxFetchTuple(state);
 
-	/* EXPLAIN without ANALYZE... */
-	if (eflags & EXEC_FLAG_EXPLAIN_ONLY)
+	if (errclass != IFX_SUCCESS)
 	{
-		elog(DEBUG1, "informix_fdw: explain only");
-		return;
+
+		if (errclass == IFX_NOT_FOUND)
+		{
+			/*
+			 * Create an empty tuple slot and we're done.
+			 */
+			elog(DEBUG2, "informix fdw scan end");
+
+			/* XXX: not required here ifxRewindCallstack(&(state->stmt_info)); */
+			state->scan_complete = true;
+			return tupleSlot;
+		}
+
+		/*
+		 * All other error/warning cases should be catched.
+		 */
+		ifxCatchExceptions(&(state->stmt_info), 0);
 	}
 
-	/*
-	 * Populate the DESCRIPTOR area.
-	 */
-	elog(DEBUG1, "populate descriptor area for statement \"%s\"",
-		 festate->stmt_info.stmt_name);
-	ifxDescribeAllocatorByName(&festate->stmt_info);
-	ifxCatchExceptions(&festate->stmt_info, IFX_STACK_ALLOCATE | IFX_STACK_DESCRIBE);
+	state->rows_fetched++;
+
+	ifxSetupTupleTableSlot(state, tupleSlot);
 
 	/*
-	 * Get the number of columns.
+	 * The cursor should now be positioned at the current row
+	 * we want to retrieve. Loop through the columns and retrieve
+	 * their values.
 	 */
-	festate->stmt_info.ifxAttrCount = ifxDescriptorColumnCount(&festate->stmt_info);
-	elog(DEBUG1, "get descriptor column count %d",
-		 festate->stmt_info.ifxAttrCount);
-	ifxCatchExceptions(&festate->stmt_info, 0);
+	ifxGetValuesFromTuple(state, tupleSlot);
 
 	/*
-	 * XXX: It makes no sense to have a local column list with *more*
-	 * columns than the remote table. I can't think of any use case
-	 * for this atm, anyone?
+	 * Get the ROWID for the current value, if required.
 	 */
-	if (PG_VALID_COLS_COUNT(festate) > festate->stmt_info.ifxAttrCount)
+	if (state->use_rowid)
 	{
-		ifxRewindCallstack(&(festate->stmt_info));
-		ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
-						errmsg("foreign table \"%s\" has more columns than remote source",
-							   get_rel_name(foreignTableOid))));
-	}
+		ItemPointer iptr;
+		HeapTuple   tuple;
 
-	festate->stmt_info.ifxAttrDefs = palloc(festate->stmt_info.ifxAttrCount
-											* sizeof(IfxAttrDef));
+		iptr = ifxGetRowIdForTuple(state);
+		tuple = ifxFdwMakeTuple(state, rel, iptr, tupleSlot);
 
-	/*
-	 * Populate result set column info array.
-	 */
-	if ((festate->stmt_info.row_size = ifxGetColumnAttributes(&festate->stmt_info)) == 0)
-	{
-		/* oops, no memory to allocate? Something surely went wrong,
-		 * so abort */
-		ifxRewindCallstack(&festate->stmt_info);
-		ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
-						errmsg("could not initialize informix column properties")));
+		tuple->t_self = *iptr;
+
+		ExecStoreTuple(tuple,
+					   tupleSlot,
+					   InvalidBuffer,
+					   false);
 	}
+	else
+		ExecStoreVirtualTuple(tupleSlot);
+
+	return tupleSlot;
+}
+
+/*
+ * Returns a new allocated pointer
+ * to IfxConnectionInfo.
+ */
+static IfxConnectionInfo *ifxMakeConnectionInfo(Oid foreignTableOid)
+{
+	IfxConnectionInfo *coninfo;
+	StringInfoData    *buf;
+	StringInfoData    *dsn;
 
 	/*
-	 * Throw an error in case we select from a relation with
-	 * BLOB types and enable_blobs FDW option is unset. We must not
-	 * use a SCROLL cursor in this case. Switching the cursor options
-	 * at this point is too late, since we already DESCRIBEd and PREPAREd
-	 * the cursor. Alternatively, we could re-PREPARE the cursor as a
-	 * NO SCROLL cursor again, but this strikes me as too dangerous (consider
-	 * changing table definitions in the meantime).
-	 *
-	 * NOTE: A non-scrollable cursor requires a serialized transaction to
-	 *       be safe. However, we don't enforce this isolation atm, since
-	 *       Informix databases with no logging would not be queryable at all.
-	 *       But someone have to keep in mind, that a ReScan of the foreign
-	 *       table could lead to inconsistent data due to changed results
-	 *       sets.
+	 * Initialize connection handle, set
+	 * defaults.
 	 */
-	if ((festate->stmt_info.special_cols & IFX_HAS_BLOBS)
-		&& (festate->stmt_info.cursorUsage == IFX_SCROLL_CURSOR))
+	coninfo = (IfxConnectionInfo *) palloc(sizeof(IfxConnectionInfo));
+	bzero(coninfo->conname, IFX_CONNAME_LEN + 1);
+	ifxConnInfoSetDefaults(coninfo);
+	ifxGetOptions(foreignTableOid, coninfo);
+
+	buf = ifxGenerateConnName(coninfo);
+	StrNCpy(coninfo->conname, buf->data, IFX_CONNAME_LEN);
+
+	dsn = ifxGetDatabaseString(coninfo);
+	coninfo->dsn = pstrdup(dsn->data);
+
+	return coninfo;
+}
+
+/*
+ * ifxDeparseQualClause
+ *
+ * Deparses a single restriction clause into buf. Boolean
+ * expressions are deparsed recursively and their arguments
+ * parenthesized, all other expressions are examined by
+ * ifx_predicate_tree_walker(). Returns false in case any
+ * part of the clause can't be pushed down, the contents
+ * of buf are undefined then.
+ *
+ * Expressions sent as query parameters are appended to params.
+ * lossy is set if the deparsed clause might match more rows
+ * than the original one, due to rounded parameter values.
+ */
+static bool ifxDeparseQualClause(Node *clause,
+								 Oid foreignTableOid,
+								 Index foreign_rtid,
+								 StringInfo buf,
+								 List **params,
+								 bool *lossy)
+{
+	IfxPushdownOprContext pushdownCxt;
+	IfxPushdownOprInfo   *info;
+
+	if (clause == NULL)
+		return false;
+
+	if (IsA(clause, BoolExpr))
 	{
-		ifxRewindCallstack(&festate->stmt_info);
-		ereport(ERROR, (errcode(ERRCODE_FDW_ERROR),
-						errmsg("could not use a SCROLL cursor to query an "
-							   "informix table with blobs"),
-						errhint("set enable_blobs=1 to your foreign table "
-								"to use a NO SCROLL cursor")));
+		BoolExpr *boolexpr = (BoolExpr *) clause;
+		ListCell *cell;
+		char     *oprStr;
+
+		if (boolexpr->boolop == NOT_EXPR)
+		{
+			bool arg_lossy = false;
+
+			appendStringInfoString(buf, "NOT (");
+
+			/*
+			 * The negation of a lossy clause would miss rows.
+			 */
+			if (!ifxDeparseQualClause((Node *) linitial(boolexpr->args),
+									  foreignTableOid, foreign_rtid, buf,
+									  params, &arg_lossy)
+				|| arg_lossy)
+				return false;
+
+			appendStringInfoChar(buf, ')');
+			return true;
+		}
+
+		oprStr = (boolexpr->boolop == AND_EXPR) ? " AND " : " OR ";
+
+		appendStringInfoChar(buf, '(');
+
+		foreach(cell, boolexpr->args)
+		{
+			if (cell != list_head(boolexpr->args))
+				appendStringInfoString(buf, oprStr);
+
+			/*
+			 * Any unsupported argument invalidates the whole
+			 * expression. Pushing down the remaining arguments of
+			 * an OR expression would lead to wrong results.
+			 */
+			if (!ifxDeparseQualClause((Node *) lfirst(cell),
+									  foreignTableOid, foreign_rtid, buf,
+									  params, lossy))
+				return false;
+		}
+
+		appendStringInfoChar(buf, ')');
+		return true;
 	}
 
-	/*
-	 * NOTE:
-	 *
-	 * ifxGetColumnAttributes() obtained all information about the
-	 * returned column and stored them within the informix SQLDA and
-	 * sqlvar structs. However, we don't want to allocate memory underneath
-	 * our current memory context, thus we allocate the required memory structure
-	 * on top here. ifxSetupDataBufferAligned() will assign the allocated
-	 * memory area to the SQLDA structure and will maintain the data offsets
-	 * properly aligned.
-	 */
-	festate->stmt_info.data = (char *) palloc0(festate->stmt_info.row_size);
-	festate->stmt_info.indicator = (short *) palloc0(sizeof(short)
-													 * festate->stmt_info.ifxAttrCount);
+	pushdownCxt.foreign_relid = foreignTableOid;
+	pushdownCxt.foreign_rtid  = foreign_rtid;
+	pushdownCxt.predicates    = NIL;
+	pushdownCxt.count         = 0;
+	pushdownCxt.count_removed = 0;
+	pushdownCxt.params        = NIL;
+	pushdownCxt.lossy         = false;
 
-	/*
-	 * Assign sqlvar pointers to the allocated memory area.
-	 */
-	ifxSetupDataBufferAligned(&festate->stmt_info);
+	ifx_predicate_tree_walker(clause, &pushdownCxt);
 
 	/*
-	 * Open the cursor.
+	 * A supported operand expression yields exactly one
+	 * deparsed predicate, anything else isn't pushed down.
 	 */
-	elog(DEBUG1, "open cursor \"%s\"",
-		 festate->stmt_info.cursor_name);
-	ifxOpenCursorForPrepared(&festate->stmt_info);
-	ifxCatchExceptions(&festate->stmt_info, IFX_STACK_OPEN);
+	if (pushdownCxt.count != 1
+		|| pushdownCxt.count_removed > 0)
+		return false;
+
+	info = (IfxPushdownOprInfo *) linitial(pushdownCxt.predicates);
 
+	if (info->type == IFX_OPR_NOT_SUPPORTED
+		|| info->expr_string == NULL)
+		return false;
+
+	appendStringInfoString(buf, text_to_cstring(info->expr_string));
+
+	*params = list_concat(*params, pushdownCxt.params);
+	*lossy  = *lossy || pushdownCxt.lossy;
+
+	return true;
 }
 
 /*
- * Extract the corresponding Informix value for the given PostgreSQL attnum
- * from the SQLDA structure. The specified attnum should be the target column
- * of the local table definition and is translated internally to the matching
- * source column on the remote table.
+ * ifxFilterQuals
+ *
+ * Walk through all FDW-related predicate expressions passed
+ * by baserel->restrictinfo and examine them for pushdown.
+ *
+ * Any predicates able to be pushed down are converted into a
+ * character string, suitable to be passed directly as SQL to
+ * an informix server. An empty string is returned in case
+ * no predicates are found.
+ *
+ * Each RestrictInfo is examined on its own, since they are
+ * AND'ed together: a clause which can't be pushed down completely
+ * doesn't prevent pushing down the other ones. Top level AND
+ * arguments of a clause are pushed down independently, too, but
+ * the clause is rechecked locally then.
+ *
+ * Params and stable expressions compared with a column are sent
+ * as query parameters (?), whose values are bound when the cursor
+ * is opened. Clauses with parameters are rechecked locally, since
+ * Informix might convert the parameter values slightly different.
+ *
+ * On PostgreSQL 9.6 and above, clauses rejected by the predicate
+ * walker are deparsed by ifxDeparseRemoteExpr() as a last resort,
+ * which knows about arithmetic, string and date functions and the
+ * functions of the extensions listed in extensions.
+ *
+ * Clauses chosen by ifxPlanKeySets() are passed in keysets and
+ * left out of the predicate, ifxPrepareParamsForScan() appends the
+ * semi joins against their key set tables. They are rechecked
+ * locally like clauses with parameters.
+ *
+ * NOTE: excl_restrictInfo is a List, holding all rejected RestrictInfo
+ * structs found not able to be pushed down. param_exprs gets the
+ * expressions of all query parameters, in the order of their
+ * placeholders.
  */
-static void ifxColumnValueByAttNum(IfxFdwExecutionState *state, int attnum,
-								   bool *isnull)
+static char * ifxFilterQuals(PlannerInfo *planInfo,
+							 RelOptInfo *baserel,
+							 List **excl_restrictInfo,
+							 List **param_exprs,
+							 List *extensions,
+							 List *keysets,
+							 Oid foreignTableOid)
 {
-	Assert(state != NULL && attnum >= 0);
-	Assert(state->stmt_info.data != NULL);
-	Assert(state->values != NULL);
-	Assert(state->pgAttrDefs);
+	ListCell       *cell;
+	StringInfoData  buf;
+	StringInfoData  clausebuf;
 
-	/*
-	 * Setup...
-	 */
-	state->values[PG_MAPPED_IFX_ATTNUM(state, attnum)].def
-		= &state->stmt_info.ifxAttrDefs[PG_MAPPED_IFX_ATTNUM(state, attnum)];
-	IFX_SETVAL_P(state, attnum, PointerGetDatum(NULL));
-	*isnull = false;
+	Assert(foreignTableOid != InvalidOid);
 
-	/*
-	 * Retrieve values from Informix and try to convert
-	 * into an appropiate PostgreSQL datum.
-	 */
+	/* Be paranoid, excluded RestrictInfo list initialized to be empty */
+	*excl_restrictInfo = NIL;
+	*param_exprs       = NIL;
 
-	switch (IFX_ATTRTYPE_P(state, attnum))
+	initStringInfo(&buf);
+	initStringInfo(&clausebuf);
+
+	foreach(cell, baserel->baserestrictinfo)
 	{
-		case IFX_FLOAT:
-		case IFX_SMFLOAT:
-		{
-			Datum dat;
+		RestrictInfo *info;
+		List         *conjuncts;
+		ListCell     *conj_cell;
+		bool          complete;
 
-			dat = convertIfxFloat(state, attnum);
-			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+		info = (RestrictInfo *) lfirst(cell);
 
-			/*
-			 * Check for errors. convertIfxFloatAsString() might
-			 * return NULL in case of an error, so make sure we
-			 * catch conversion errors.
-			 */
-			if (! IFX_ATTR_IS_VALID_P(state, attnum))
-			{
-				ifxRewindCallstack(&state->stmt_info);
-				elog(ERROR, "could not convert informix type id %d into pg type %u",
-					 IFX_ATTRTYPE_P(state, attnum),
-					 PG_ATTRTYPE_P(state, attnum));
-			}
+		/*
+		 * Pseudoconstant clauses are evaluated by the executor
+		 * before the foreign scan is started at all.
+		 */
+		if (info->pseudoconstant)
+			continue;
 
-			IFX_SETVAL_P(state, attnum, dat);
-			break;
-		}
-		case IFX_SMALLINT:
-			/*
-			 * All int values are handled
-			 * by convertIfxInt()...so fall through.
-			 */
-		case IFX_INTEGER:
-		case IFX_SERIAL:
-		case IFX_INT8:
-		case IFX_SERIAL8:
-		case IFX_INFX_INT8:
+		/*
+		 * Split up a top level AND expression, so that its
+		 * supported arguments can be pushed down separately.
+		 */
+		conjuncts = make_ands_implicit(info->clause);
+		complete  = true;
+
+		foreach(conj_cell, conjuncts)
 		{
-			Datum dat;
+			List     *params = NIL;
+			bool      lossy  = false;
+			bool      shipped;
+			ListCell *ks_cell;
 
-			dat = convertIfxInt(state, attnum);
-			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+			resetStringInfo(&clausebuf);
 
-			/*
-			 * Check for errors, but only if we
-			 * didnt get a validated NULL attribute from
-			 * informix.
-			 */
-			if (! IFX_ATTR_IS_VALID_P(state, attnum))
+			foreach(ks_cell, keysets)
 			{
-				ifxRewindCallstack(&state->stmt_info);
-				elog(ERROR, "could not convert informix type id %d into pg type %u",
-					 IFX_ATTRTYPE_P(state, attnum),
-					 PG_ATTRTYPE_P(state, attnum));
+				IfxKeySet *keyset = (IfxKeySet *) lfirst(ks_cell);
+
+				if (keyset->clause == (Node *) lfirst(conj_cell))
+					break;
 			}
 
-			IFX_SETVAL_P(state, attnum, dat);
-			break;
-		}
-		case IFX_CHARACTER:
-		case IFX_VCHAR:
-		case IFX_NCHAR:
-		case IFX_LVARCHAR:
-		case IFX_NVCHAR:
-		{
-			/* SQLCHAR, SQLVCHAR, SQLNCHAR, SQLLVARCHAR, SQLNVCHAR */
-			Datum dat;
+			if (ks_cell != NULL)
+			{
+				complete = false;
+				continue;
+			}
 
-			dat = convertIfxCharacterString(state, attnum);
-			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
+			shipped = ifxDeparseQualClause((Node *) lfirst(conj_cell),
+										   foreignTableOid, baserel->relid,
+										   &clausebuf, &params, &lossy);
 
-			/*
-			 * Guard against invalid conversion
-			 * attempts.
-			 */
-			if (! IFX_ATTR_IS_VALID_P(state, attnum))
+#if PG_VERSION_NUM >= 90600
+			if (!shipped)
 			{
-				ifxRewindCallstack(&state->stmt_info);
-				ereport(ERROR, (errcode(ERRCODE_FDW_INVALID_DATA_TYPE),
-								errmsg("conversion in column \"%s\" with unsupported character type mapping",
-									   state->pgAttrDefs[attnum].attname)));
+				IfxDeparseContext context;
+
+				resetStringInfo(&clausebuf);
+				params = NIL;
+
+				context.root        = planInfo;
+				context.scanrel     = baserel;
+				context.buf         = &clausebuf;
+				context.qualify_col = false;
+				context.extensions  = extensions;
+
+				shipped = ifxDeparseRemoteExpr((Node *) lfirst(conj_cell),
+											   &context);
 			}
+#endif
 
-			/*
-			 * At this point we never expect a NULL datum without
-			 * having retrieved NULL from informix. Check it.
-			 * If it's a validated NULL value from informix,
-			 * don't throw an error.
-			 */
-			if ((DatumGetPointer(dat) == NULL)
-				&& !*isnull)
+			if (!shipped)
 			{
-				ifxRewindCallstack(&state->stmt_info);
-				elog(ERROR, "could not convert informix character type into pg type %u",
-					 PG_ATTRTYPE_P(state, attnum));
+				complete = false;
+				continue;
 			}
 
-			IFX_SETVAL_P(state, attnum, dat);
-			break;
-		}
-		case IFX_BYTES:
-		case IFX_TEXT:
-		{
-			Datum dat;
+			if (buf.len > 0)
+				appendStringInfoString(&buf, " AND ");
 
-			dat = convertIfxSimpleLO(state, attnum);
+			appendStringInfoString(&buf, clausebuf.data);
 
-			/*
-			 * Check for invalid datum conversion.
-			 */
-			if (! IFX_ATTR_IS_VALID_P(state, attnum))
+			if (params != NIL)
 			{
-				elog(ERROR, "could not convert informix LO type into pg type %u",
-					 PG_ATTRTYPE_P(state, attnum));
+				*param_exprs = list_concat(*param_exprs, params);
+				complete = false;
 			}
-
-			/*
-			 * Valid NULL datum?
-			 */
-			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
-			IFX_SETVAL_P(state, attnum, dat);
-
-			break;
 		}
-		case IFX_BOOLEAN:
+
+		/*
+		 * The whole RestrictInfo must be checked locally if anything
+		 * of it wasn't pushed down.
+		 */
+		if (!complete)
 		{
-			/* SQLBOOL value */
-			Datum dat;
-			dat = convertIfxBoolean(state, attnum);
+			elog(DEBUG2, "RestrictInfo not pushed down completely, evaluating locally");
+			*excl_restrictInfo = lappend(*excl_restrictInfo, info);
+		}
+	}
 
-			/*
-			 * Unlike other types, a NULL datum is treated
-			 * like a normal FALSE value in case the indicator
-			 * value tells that we got a NOT NULL column.
-			 */
-			if (! IFX_ATTR_IS_VALID_P(state, attnum))
-			{
-				ifxRewindCallstack(&state->stmt_info);
-				elog(ERROR, "could not convert informix boolean into pg type %u",
-					 PG_ATTRTYPE_P(state, attnum));
-			}
+	/* empty string in case no pushdown predicates are found */
+	return buf.data;
+}
 
-			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
-			IFX_SETVAL_P(state, attnum, dat);
+#if PG_VERSION_NUM >= 90200
 
-			break;
-		}
-		case IFX_DATE:
-		{
-			/* SQLDATE value */
-			Datum dat;
-			dat = convertIfxDateString(state, attnum);
+/*
+ * Assumed number of keys of an array computed at runtime.
+ */
+#define IFX_KEYSET_DEFAULT_KEYS 100
 
-			/*
-			 * Valid datum?
-			 */
-			if ((DatumGetPointer(dat) == NULL)
-				&& ! IFX_ATTR_IS_VALID_P(state, attnum))
-			{
-				ifxRewindCallstack(&state->stmt_info);
-				elog(ERROR, "could not convert informix date into pg type %u",
-					 PG_ATTRTYPE_P(state, attnum));
-			}
+/*
+ * ifxPlanKeySets
+ *
+ * Decides which restriction clauses of a foreign scan comparing a
+ * column with the elements of an array are pushed down as a semi join
+ * against a key set table. That's a temporary table on the Informix
+ * server, loaded with the elements of the array when the scan cursor
+ * is opened.
+ * See ifxIsKeySetExpr() for the supported clauses.
+ *
+ * The choice is cost based. A constant IN list is deparsed literally
+ * otherwise, which makes the Informix server compare each row with all
+ * its elements, unless the column is the leading column of an index.
+ * Arrays computed at runtime, e.g. col = ANY(ARRAY(SELECT ...)), can't
+ * be pushed down at all otherwise: all rows are fetched and filtered
+ * locally. A key set table costs another round trip to load the keys,
+ * but is joined by a single pass over the remote table.
+ */
+static void ifxPlanKeySets(PlannerInfo       *root,
+						   RelOptInfo        *baserel,
+						   IfxConnectionInfo *coninfo,
+						   IfxFdwPlanState   *planState)
+{
+	ListCell *cell;
+	double    ntuples;
 
-			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
-			IFX_SETVAL_P(state, attnum, dat);
-			break;
-		}
-		case IFX_DTIME:
-		{
-			/* SQLDTIME value */
-			Datum dat;
-			dat = convertIfxTimestampString(state, attnum);
+	planState->keysets = NIL;
 
-			/*
-			 * Valid datum?
-			 */
-			if ((DatumGetPointer(dat) == NULL)
-				&& ! IFX_ATTR_IS_VALID_P(state, attnum))
-			{
-				ifxRewindCallstack(&state->stmt_info);
-				elog(ERROR, "could not convert informix datetime into pg type %u",
-					 PG_ATTRTYPE_P(state, attnum));
-			}
+	/*
+	 * Row estimates aren't available yet. Use the statistics of the
+	 * foreign table, if analyzed, or the defaults of
+	 * ifxEstimateLocalRelSize().
+	 */
+	ntuples = (baserel->tuples > 0) ? baserel->tuples : (10 * BLCKSZ) / 100;
 
-			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
-			IFX_SETVAL_P(state, attnum, dat);
-			break;
-		}
-		case IFX_INTERVAL:
-		{
-			/* SQLINTERVAL value */
-			Datum dat;
-			dat = convertIfxInterval(state, attnum);
+	foreach(cell, baserel->baserestrictinfo)
+	{
+		RestrictInfo *info = (RestrictInfo *) lfirst(cell);
+		ListCell     *conj_cell;
 
-			/* Valid datum ? */
-			if ((DatumGetPointer(dat) == NULL)
-				&& ! IFX_ATTR_IS_VALID_P(state, attnum))
-			{
-				ifxRewindCallstack(&state->stmt_info);
-				elog(ERROR, "could not convert informix interval into pg type %u",
-					 PG_ATTRTYPE_P(state, attnum));
-			}
+		if (info->pseudoconstant)
+			continue;
 
-			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
-			IFX_SETVAL_P(state, attnum, dat);
-			break;
-		}
-		case IFX_MONEY:
-		case IFX_DECIMAL:
+		foreach(conj_cell, make_ands_implicit(info->clause))
 		{
-			/* DECIMAL value */
-			Datum dat;
-			dat = convertIfxDecimal(state, attnum);
+			Node      *clause = (Node *) lfirst(conj_cell);
+			IfxKeySet *keyset;
+			Var       *colref;
+			Node      *keys;
+			double     nkeys;
+			Cost       keyset_cost;
+			Cost       other_cost;
+
+			if (!ifxIsKeySetExpr(clause, baserel->relid, &colref, &keys))
+				continue;
+
+			if (IsA(keys, Const))
+			{
+				ArrayType *array = DatumGetArrayTypeP(((Const *) keys)->constvalue);
+				bool       indexed = false;
 
-			/*
-			 * Valid datum?
-			 */
-			if ((DatumGetPointer(dat) == NULL)
-				&& ! IFX_ATTR_IS_VALID_P(state, attnum))
+				nkeys = ArrayGetNItems(ARR_NDIM(array), ARR_DIMS(array));
+
+#if PG_VERSION_NUM >= 90600
+				{
+					int i;
+
+					for (i = 0; i < planState->nindexes; i++)
+					{
+						if ((planState->indexes[i].nparts > 0)
+							&& (planState->indexes[i].parts[0] == colref->varattno))
+							indexed = true;
+					}
+				}
+#endif
+
+				/* Informix looks up each element in the index */
+				if (indexed)
+					continue;
+
+				other_cost = ntuples * nkeys * cpu_operator_cost / 2;
+			}
+			else
 			{
-				ifxRewindCallstack(&state->stmt_info);
-				elog(ERROR, "could not convert informix decimal into pg type %u",
-					 PG_ATTRTYPE_P(state, attnum));
+				Selectivity selec;
+
+				nkeys = IFX_KEYSET_DEFAULT_KEYS;
+
+				/* rows not matching are fetched in vain */
+				selec = clause_selectivity(root, clause, 0, JOIN_INNER, NULL);
+				other_cost = ntuples * (1.0 - selec)
+					* (coninfo->fdw_tuple_cost + cpu_tuple_cost);
 			}
 
-			*isnull = (IFX_ATTR_ISNULL_P(state, attnum));
-			IFX_SETVAL_P(state, attnum, dat);
-			break;
-		}
-		default:
-		{
-			ifxRewindCallstack(&state->stmt_info);
-			elog(ERROR, "\"%d\" is not a known informix type id",
-				state->stmt_info.ifxAttrDefs[attnum].type);
-			break;
+			keyset_cost = coninfo->fdw_startup_cost
+				+ (nkeys * (coninfo->fdw_tuple_cost + cpu_tuple_cost))
+				+ (ntuples * cpu_operator_cost);
+
+			elog(DEBUG2, "informix_fdw: key set costs %.2f, without key set %.2f",
+				 keyset_cost, other_cost);
+
+			if (keyset_cost >= other_cost)
+				continue;
+
+			keyset = (IfxKeySet *) palloc(sizeof(IfxKeySet));
+			keyset->clause    = clause;
+			keyset->keys      = keys;
+			keyset->tablename = ifxGenKeySetName(get_element_type(exprType(keys)),
+												 baserel->relid,
+												 list_length(planState->keysets) + 1);
+			keyset->column    = ifxDeparseColumnRef(planState->foreignTableOid,
+													baserel->relid, colref);
+
+			planState->keysets = lappend(planState->keysets, keyset);
 		}
 	}
 }
 
-static void ifxEndForeignScan(ForeignScanState *node)
+#endif
+
+/*
+ * ifxPrepareCursorForScan()
+ *
+ * Prepares the remote informix FDW to scan the relation.
+ * This basically means to allocate the SQLDA description area and
+ * declaring the cursor. The reason why this is a separate function is,
+ * that we are eventually required to do it twice,
+ * once in ifxPlanForeignScan() and in ifxBeginForeignScan().
+ * When doing a scan, we  need the query plan from
+ * the DECLARE CURSOR statement in ifxPlanForeignScan()
+ * to get the query costs from the informix server easily. However, that
+ * involves declaring the cursor in ifxPlanForeignScan(), which will be then
+ * reused in ifxBeginForeignScan() later. To save extra cycles and declaring
+ * the cursor twice, we just reuse the cursor previously declared in
+ * ifxBeginForeignScan() later. However, if used for example with a prepared
+ * statement, ifxPlanForeignScan() won't be called again, instead the
+ * previously plan prepared by ifxPlanForeignScan() will be re-used. Since
+ * ifxEndForeignScan() already has deallocated the complete structure, we
+ * are required to redeclare the cursor again, to satisfy subsequent
+ * EXECUTE calls to the prepared statement. This is relatively easy
+ * to check, since the only thing we need to do in ifxBeginForeignScan()
+ * is to recheck wether the call stack is empty or not.
+ */
+static void ifxPrepareCursorForScan(IfxStatementInfo *info,
+									IfxConnectionInfo *coninfo)
 {
-	IfxFdwExecutionState *state;
-	List                 *plan_values;
+	/*
+	 * Generate a statement identifier. Required to uniquely
+	 * identify the prepared statement within Informix.
+	 */
+	info->stmt_name = ifxGenStatementName(info->refid);
 
-	elog(DEBUG3, "informix_fdw: end scan");
+	/*
+	 * An identifier for the dynamically allocated
+	 * DESCRIPTOR area.
+	 */
+	info->descr_name = ifxGenDescrName(info->refid);
 
-	state = (IfxFdwExecutionState *) node->fdw_state;
-	plan_values = PG_SCANSTATE_PRIVATE_P(node);
-	ifxDeserializeFdwData(state, plan_values);
+	/*
+	 * ...and finally the cursor name.
+	 */
+	info->cursor_name = ifxGenCursorName(info->refid);
+
+	/* Prepare the query. */
+	elog(DEBUG1, "prepare query \"%s\"", info->query);
+	ifxPrepareQuery(info->query,
+					info->stmt_name);
+	ifxCatchExceptions(info, IFX_STACK_PREPARE);
 
 	/*
-	 * Dispose SQLDA resource, allocated database objects, ...
+	 * Remember the row and cost estimates the Informix server
+	 * reports for the prepared query. SQLCA is overwritten by
+	 * subsequent statements.
 	 */
-	ifxRewindCallstack(&state->stmt_info);
+	coninfo->planData.estimated_rows = (double) ifxGetSQLCAErrd(SQLCA_NROWS_PROCESSED);
+	coninfo->planData.costs          = (double) ifxGetSQLCAErrd(SQLCA_NROWS_WEIGHT);
 
 	/*
-	 * Save the callstack into cached plan structure. This
-	 * is necessary to teach ifxBeginForeignScan() to do the
-	 * right thing(tm)...
+	 * Declare the cursor for the prepared
+	 * statement. Check out, if we need to switch the cursor
+	 * type depending on special datatypes first.
 	 */
-	ifxSetSerializedInt16Field(plan_values,
-							   SERIALIZED_CALLSTACK,
-							   state->stmt_info.call_stack);
+	if (coninfo->enable_blobs)
+	{
+		elog(NOTICE, "informix_fdw: enable_blobs specified, forcing NO SCROLL cursor");
+
+		if (!coninfo->tx_enabled)
+			ereport(WARNING,
+					(errcode(ERRCODE_FDW_INCONSISTENT_DESCRIPTOR_INFORMATION),
+					 errmsg("informix_fdw: using NO SCROLL cursor without transactions")));
+
+		info->cursorUsage = IFX_DEFAULT_CURSOR;
+	}
+
+	elog(DEBUG1, "declare cursor \"%s\"", info->cursor_name);
+	ifxDeclareCursorForPrepared(info->stmt_name,
+								info->cursor_name,
+								info->cursorUsage);
+	ifxCatchExceptions(info, IFX_STACK_DECLARE);
 }
 
-static TupleTableSlot *ifxIterateForeignScan(ForeignScanState *node)
+/*
+ * Returns the cached connection with the specified name, if
+ * its statement cache is enabled. Returns NULL otherwise.
+ */
+static IfxCachedConnection *ifxGetStmtCache(char *conname)
 {
-	TupleTableSlot       *tupleSlot = node->ss.ss_ScanTupleSlot;
-	Relation              rel       = node->ss.ss_currentRelation;
-	IfxConnectionInfo    *coninfo;
-	IfxFdwExecutionState *state;
-	IfxSqlStateClass      errclass;
-	Oid                   foreignTableOid;
-	bool                  conn_cached;
+	IfxCachedConnection *cached;
+	bool                 found;
 
-	state = (IfxFdwExecutionState *) node->fdw_state;
+	if (!IfxCacheIsInitialized || (conname[0] == '\0'))
+		return NULL;
 
-	elog(DEBUG3, "informix_fdw: iterate scan");
+	cached = ifxConnCache_exists(conname, &found);
 
-	/*
-	 * Make the informix connection belonging to this
-	 * iteration current.
-	 */
-	foreignTableOid = RelationGetRelid(node->ss.ss_currentRelation);
-	coninfo= ifxMakeConnectionInfo(foreignTableOid);
+	if (!found || (cached->stmt_cache_size <= 0))
+		return NULL;
 
-	/*
-	 * Set appropiate scan mode.
-	 */
-	coninfo->scan_mode = IFX_ITERATE_SCAN;
+	return cached;
+}
 
-	/*
-	 * ...and get the handle.
-	 */
-	ifxConnCache_add(foreignTableOid, coninfo, &conn_cached);
+/*
+ * Same as ifxPrepareCursorForScan(), but reuses the prepared statement
+ * and cursor of a former scan with the same query from the statement
+ * cache of the connection. This saves the round trips to PREPARE the
+ * query and DECLARE its cursor. Newly prepared statements are added to
+ * the cache, replacing the least recently used one if the cache is full.
+ *
+ * Updatable cursors and cursors on BLOB columns are never cached.
+ */
+static void ifxPrepareCachedCursorForScan(IfxStatementInfo *info,
+										  IfxConnectionInfo *coninfo)
+{
+	IfxCachedConnection *cached;
+	IfxCachedStatement  *stmt;
 
-	/*
-	 * Make the connection current (otherwise we might
-	 * get confused).
-	 */
-	if (conn_cached)
+	cached = ifxGetStmtCache(coninfo->conname);
+
+	if ((cached == NULL)
+		|| (info->cursorUsage == IFX_UPDATE_CURSOR)
+		|| coninfo->enable_blobs)
 	{
-		ifxSetConnection(coninfo);
+		ifxPrepareCursorForScan(info, coninfo);
+		return;
 	}
 
-	/*
-	 * Check connection status.
-	 */
-	if ((ifxConnectionStatus() != IFX_CONNECTION_OK)
-		&& (ifxConnectionStatus() != IFX_CONNECTION_WARN))
+	stmt = ifxStmtCache_lookup(cached, info->query, info->cursorUsage);
+
+	if (stmt != NULL)
 	{
-		elog(ERROR, "could not set requested informix connection");
+		elog(DEBUG2, "informix_fdw: reusing cached statement \"%s\"",
+			 stmt->stmt_name);
+
+		info->stmt_name   = pstrdup(stmt->stmt_name);
+		info->descr_name  = ifxGenDescrName(info->refid);
+		info->cursor_name = pstrdup(stmt->cursor_name);
+
+		coninfo->planData.estimated_rows = stmt->estimated_rows;
+		coninfo->planData.costs          = stmt->costs;
+
+		ifxPushCallstack(info, IFX_STACK_PREPARE
+						 | IFX_STACK_DECLARE
+						 | IFX_STACK_CACHED);
+		return;
 	}
 
-	/*
-	 * Prepare a virtual tuple.
-	 */
-	ExecClearTuple(tupleSlot);
+	ifxPrepareCursorForScan(info, coninfo);
 
 	/*
-	 * Catch any informix exception. We also need to
-	 * check for IFX_NOT_FOUND, in which case no more rows
-	 * must be processed.
+	 * Make room for the new statement.
 	 */
-	errclass = ifxFetchTuple(state);
+	while ((stmt = ifxStmtCache_victim(cached, IFX_CURRENT_LXID)) != NULL)
+		ifxEvictCachedStatement(cached, stmt);
 
-	if (errclass != IFX_SUCCESS)
+	if (list_length(cached->stmt_cache) < cached->stmt_cache_size)
 	{
+		ifxStmtCache_add(cached, info,
+						 coninfo->planData.estimated_rows,
+						 coninfo->planData.costs);
+		ifxPushCallstack(info, IFX_STACK_CACHED);
 
-		if (errclass == IFX_NOT_FOUND)
-		{
-			/*
-			 * Create an empty tuple slot and we're done.
-			 */
-			elog(DEBUG2, "informix fdw scan end");
+		elog(DEBUG2, "informix_fdw: cached statement \"%s\"",
+			 info->stmt_name);
+	}
+}
 
-			/* XXX: not required here ifxRewindCallstack(&(state->stmt_info)); */
-			return tupleSlot;
-		}
+/*
+ * Closes the cursor of a cached statement still marked in use.
+ * The cursor might have been left open by an aborted transaction,
+ * but the scan might also have ended before opening it. The cache
+ * doesn't know, so the errors for a cursor which isn't open are
+ * ignored.
+ */
+static void ifxCloseLeftoverCursor(IfxStatementInfo *info)
+{
+	int sqlcode;
 
-		/*
-		 * All other error/warning cases should be catched.
-		 */
-		ifxCatchExceptions(&(state->stmt_info), 0);
+	ifxCloseCursor(info);
+
+	sqlcode = ifxGetSqlCode();
+
+	if ((sqlcode == -400) || (sqlcode == -404))
+	{
+		elog(DEBUG2, "informix_fdw: cursor \"%s\" wasn't open",
+			 info->cursor_name);
+		return;
 	}
 
-	ifxSetupTupleTableSlot(state, tupleSlot);
+	ifxCatchExceptions(info, 0);
+}
 
-	/*
-	 * The cursor should now be positioned at the current row
-	 * we want to retrieve. Loop through the columns and retrieve
-	 * their values.
-	 */
-	ifxGetValuesFromTuple(state, tupleSlot);
+/*
+ * Removes the specified statement from the statement cache
+ * and frees its resources on the Informix server. The connection
+ * of the cache must be current.
+ */
+static void ifxEvictCachedStatement(IfxCachedConnection *cached,
+									IfxCachedStatement *stmt)
+{
+	IfxStatementInfo info;
 
-	/*
-	 * Get the ROWID for the current value, if required.
-	 */
-	if (state->use_rowid)
-	{
-		ItemPointer iptr;
-		HeapTuple   tuple;
+	elog(DEBUG2, "informix_fdw: evict cached statement \"%s\"",
+		 stmt->stmt_name);
 
-		iptr = ifxGetRowIdForTuple(state);
-		tuple = ifxFdwMakeTuple(state, rel, iptr, tupleSlot);
+	ifxStatementInfoInit(&info, -1);
+	info.stmt_name   = stmt->stmt_name;
+	info.cursor_name = stmt->cursor_name;
 
-		tuple->t_self = *iptr;
+	if (stmt->in_use != InvalidLocalTransactionId)
+		ifxCloseLeftoverCursor(&info);
 
-		ExecStoreTuple(tuple,
-					   tupleSlot,
-					   InvalidBuffer,
-					   false);
-	}
-	else
-		ExecStoreVirtualTuple(tupleSlot);
+	ifxFreeResource(&info, IFX_STACK_DECLARE);
+	ifxFreeResource(&info, IFX_STACK_PREPARE);
 
-	return tupleSlot;
+	ifxStmtCache_rm(cached, stmt);
+	ifxStmtCache_free(stmt);
 }
 
 /*
- * Returns a new allocated pointer
- * to IfxConnectionInfo.
+ * Marks the cached statement of the specified statement info
+ * in use by a scan of the current transaction. If an earlier scan
+ * already DESCRIBEd the statement, its SQLDA structure and column
+ * descriptors are assigned to info and true is returned. Otherwise
+ * the caller is responsible to describe the statement and to pass
+ * the descriptor to ifxSaveCachedDescriptor().
+ *
+ * If the statement was removed from the cache since planning or its
+ * cursor is opened by another scan of the current transaction, a
+ * private statement and cursor are prepared instead.
  */
-static IfxConnectionInfo *ifxMakeConnectionInfo(Oid foreignTableOid)
+static bool ifxAcquireCachedStatement(IfxStatementInfo *info,
+									  IfxConnectionInfo *coninfo)
 {
-	IfxConnectionInfo *coninfo;
-	StringInfoData    *buf;
-	StringInfoData    *dsn;
+	IfxCachedConnection *cached;
+	IfxCachedStatement  *stmt;
+	bool                 found;
+
+	if ((info->call_stack & IFX_STACK_CACHED) != IFX_STACK_CACHED)
+		return false;
+
+	cached = ifxConnCache_exists(info->conname, &found);
+	stmt   = (found) ? ifxStmtCache_find(cached, info->stmt_name) : NULL;
 
 	/*
-	 * Initialize connection handle, set
-	 * defaults.
+	 * Statement identifiers are only unique during the lifetime
+	 * of a connection. If the plan outlived its connection, a new
+	 * statement with the same name might be cached, so also
+	 * check the query.
 	 */
-	coninfo = (IfxConnectionInfo *) palloc(sizeof(IfxConnectionInfo));
-	bzero(coninfo->conname, IFX_CONNAME_LEN + 1);
-	ifxConnInfoSetDefaults(coninfo);
-	ifxGetOptions(foreignTableOid, coninfo);
+	if ((stmt != NULL)
+		&& ((stmt->cursorUsage != info->cursorUsage)
+			|| (strcmp(stmt->query, info->query) != 0)))
+		stmt = NULL;
+
+	if ((stmt == NULL) || (stmt->in_use == IFX_CURRENT_LXID))
+	{
+		elog(DEBUG2, "informix_fdw: cached statement \"%s\" not available",
+			 info->stmt_name);
+
+		/*
+		 * Get a new refid, the identifiers derived from the
+		 * current one might still be in use.
+		 */
+		info->call_stack = IFX_STACK_EMPTY;
+		if (found)
+			info->refid = ++cached->con.usage;
+
+		ifxPrepareCursorForScan(info, coninfo);
+		return false;
+	}
 
-	buf = ifxGenerateConnName(coninfo);
-	StrNCpy(coninfo->conname, buf->data, IFX_CONNAME_LEN);
+	if (stmt->in_use != InvalidLocalTransactionId)
+		ifxCloseLeftoverCursor(info);
 
-	dsn = ifxGetDatabaseString(coninfo);
-	coninfo->dsn = pstrdup(dsn->data);
+	stmt->in_use = IFX_CURRENT_LXID;
 
-	return coninfo;
+	if (stmt->sqlda == NULL)
+		return false;
+
+	info->sqlda        = stmt->sqlda;
+	info->ifxAttrCount = stmt->ifxAttrCount;
+	info->row_size     = stmt->row_size;
+	info->special_cols = stmt->special_cols;
+	info->ifxAttrDefs  = (IfxAttrDef *) palloc(stmt->ifxAttrCount
+												* sizeof(IfxAttrDef));
+	memcpy(info->ifxAttrDefs, stmt->ifxAttrDefs,
+		   stmt->ifxAttrCount * sizeof(IfxAttrDef));
+
+	ifxPushCallstack(info, IFX_STACK_ALLOCATE | IFX_STACK_DESCRIBE);
+
+	return true;
 }
 
 /*
- * ifxFilterQuals
- *
- * Walk through all FDW-related predicate expressions passed
- * by baserel->restrictinfo and examine them for pushdown.
- *
- * Any predicates able to be pushed down are converted into a
- * character string, suitable to be passed directly as SQL to
- * an informix server. An empty string is returned in case
- * no predicates are found.
- *
- * NOTE: excl_restrictInfo is a List, holding all rejected RestrictInfo
- * structs found not able to be pushed down.
+ * Saves the SQLDA structure and column descriptors of the
+ * specified statement info into its cached statement, so that
+ * subsequent scans don't need to DESCRIBE it again.
  */
-static char * ifxFilterQuals(PlannerInfo *planInfo,
-							 RelOptInfo *baserel,
-							 List **excl_restrictInfo,
-							 Oid foreignTableOid)
+static void ifxSaveCachedDescriptor(IfxStatementInfo *info)
 {
-	IfxPushdownOprContext pushdownCxt;
-	ListCell             *cell;
-	StringInfoData       *buf;
-	char                 *oprStr;
-	int i;
-
-	Assert(foreignTableOid != InvalidOid);
+	IfxCachedConnection *cached;
+	IfxCachedStatement  *stmt;
+	MemoryContext        old_cxt;
 
-	pushdownCxt.foreign_relid = foreignTableOid;
-	pushdownCxt.foreign_rtid  = baserel->relid;
-	pushdownCxt.predicates    = NIL;
-	pushdownCxt.count         = 0;
-	pushdownCxt.count_removed = 0;
-	pushdownCxt.has_or_expr   = false;
+	if ((info->call_stack & IFX_STACK_CACHED) != IFX_STACK_CACHED)
+		return;
 
-	/* Be paranoid, excluded RestrictInfo list initialized to be empty */
-	*excl_restrictInfo = NIL;
+	if ((cached = ifxGetStmtCache(info->conname)) == NULL)
+		return;
 
-	buf = makeStringInfo();
-	initStringInfo(buf);
+	stmt = ifxStmtCache_find(cached, info->stmt_name);
 
-	/*
-	 * Loop through the operator nodes and try to
-	 * extract the pushdown expressions as a text datum
-	 * to the pushdown context structure.
-	 */
-	foreach(cell, baserel->baserestrictinfo)
-	{
-		RestrictInfo *info;
-		int found;
+	if ((stmt == NULL) || (stmt->sqlda != NULL))
+		return;
 
-		info = (RestrictInfo *) lfirst(cell);
+	old_cxt = MemoryContextSwitchTo(TopMemoryContext);
+	stmt->ifxAttrDefs = (IfxAttrDef *) palloc(info->ifxAttrCount
+											  * sizeof(IfxAttrDef));
+	MemoryContextSwitchTo(old_cxt);
 
-		found = pushdownCxt.count;
-		ifx_predicate_tree_walker((Node *)info->clause, &pushdownCxt);
+	memcpy(stmt->ifxAttrDefs, info->ifxAttrDefs,
+		   info->ifxAttrCount * sizeof(IfxAttrDef));
 
-		if (found == pushdownCxt.count)
-		{
-			elog(DEBUG2, "RestrictInfo doesn't hold anything interesting, skipping");
-			*excl_restrictInfo = lappend(*excl_restrictInfo, info);
-		}
+	stmt->sqlda        = info->sqlda;
+	stmt->ifxAttrCount = info->ifxAttrCount;
+	stmt->row_size     = info->row_size;
+	stmt->special_cols = info->special_cols;
+}
 
-		/*
-		 * Each list element from baserestrictinfo is AND'ed together.
-		 * Record a corresponding IfxPushdownOprInfo structure in
-		 * the context, so that it get decoded properly below.
-		 */
-		if (lnext(cell) != NULL)
-		{
-			IfxPushdownOprInfo *pushAndInfo;
+/*
+ * Counterpart of ifxRewindCallstack() for cached statements. Closes
+ * the cursor, if opened, and returns the statement to the cache. The
+ * prepared statement, the cursor and the cached SQLDA structure
+ * are kept.
+ */
+static void ifxReleaseCachedStatement(IfxStatementInfo *info)
+{
+	IfxCachedConnection *cached;
+	IfxCachedStatement  *stmt = NULL;
 
-			pushAndInfo              = palloc(sizeof(IfxPushdownOprInfo));
-			pushAndInfo->type        = IFX_OPR_AND;
-			pushAndInfo->expr_string = cstring_to_text("AND");
+	if ((cached = ifxGetStmtCache(info->conname)) != NULL)
+		stmt = ifxStmtCache_find(cached, info->stmt_name);
 
-			pushdownCxt.predicates = lappend(pushdownCxt.predicates, pushAndInfo);
-			pushdownCxt.count++;
-		}
+	if ((info->call_stack & IFX_STACK_OPEN) == IFX_STACK_OPEN)
+	{
+		ifxCloseCursor(info);
+		elog(DEBUG2, "informix_fdw: undo open");
 	}
 
 	/*
-	 * Since restriction clauses are always AND together,
-	 * assume a AND_EXPR per default.
-	 */
-	oprStr = "AND";
-
-	/*
-	 * Check wether ifx_predicate_tree_walker() encountered a OR'ed
-	 * expression and removed some clauses...we can't rely on the returned
-	 * predicate string, so assume we can't push down any. This won't be safe,
-	 * since we might push down a partial OR expression which would lead
-	 * to wrong results. We might try to be a little smarter here, but leave
-	 * that to future improvements...
+	 * Free a SQLDA structure not saved by the cache.
 	 */
-	if (pushdownCxt.has_or_expr
-		&& ( pushdownCxt.count_removed > 0))
-		return "";
+	if (((info->call_stack & IFX_STACK_ALLOCATE) == IFX_STACK_ALLOCATE)
+		&& ((stmt == NULL) || (stmt->sqlda != info->sqlda)))
+	{
+		ifxDeallocateSQLDA(info);
+		elog(DEBUG2, "informix_fdw: undo allocate");
+	}
 
 	/*
-	 * Filter step done, if any predicates to be able to be
-	 * pushed down are found, we have a list of IfxPushDownOprInfo
-	 * structure in the IfxPushdownOprContext structure. Loop
-	 * through them and attach all supported filter quals into
-	 * our result buffer.
+	 * Only a scan which has DESCRIBEd the statement has
+	 * marked it in use, see ifxAcquireCachedStatement().
 	 */
-	for (i = 0; i < pushdownCxt.count; i++)
-	{
-		IfxPushdownOprInfo *info;
-
-		info = (IfxPushdownOprInfo *) list_nth(pushdownCxt.predicates, i);
-
-		/* ignore filtered expressions */
-		if (info->type == IFX_OPR_NOT_SUPPORTED)
-		{
-			continue;
-		}
+	if ((stmt != NULL)
+		&& ((info->call_stack & IFX_STACK_DESCRIBE) == IFX_STACK_DESCRIBE))
+		stmt->in_use = InvalidLocalTransactionId;
 
-		switch (info->type)
-		{
-			case IFX_OPR_OR:
-			case IFX_OPR_AND:
-			case IFX_OPR_NOT:
-				/* save current boolean opr context */
-				oprStr = text_to_cstring(info->expr_string);
-				break;
-			case IFX_IS_NULL:
-			case IFX_IS_NOT_NULL:
-				/* fall through, no special action necessary */
-			default:
-				appendStringInfo(buf, " %s %s",
-								 (i > 1) ? oprStr : "",
-								 text_to_cstring(info->expr_string));
-		}
-	}
+	elog(DEBUG2, "informix_fdw: released cached statement \"%s\"",
+		 info->stmt_name);
 
-	/* empty string in case no pushdown predicates are found */
-	return buf->data;
+	info->sqlda      = NULL;
+	info->call_stack = IFX_STACK_EMPTY;
 }
 
 /*
- * ifxPrepareCursorForScan()
- *
- * Prepares the remote informix FDW to scan the relation.
- * This basically means to allocate the SQLDA description area and
- * declaring the cursor. The reason why this is a separate function is,
- * that we are eventually required to do it twice,
- * once in ifxPlanForeignScan() and in ifxBeginForeignScan().
- * When doing a scan, we  need the query plan from
- * the DECLARE CURSOR statement in ifxPlanForeignScan()
- * to get the query costs from the informix server easily. However, that
- * involves declaring the cursor in ifxPlanForeignScan(), which will be then
- * reused in ifxBeginForeignScan() later. To save extra cycles and declaring
- * the cursor twice, we just reuse the cursor previously declared in
- * ifxBeginForeignScan() later. However, if used for example with a prepared
- * statement, ifxPlanForeignScan() won't be called again, instead the
- * previously plan prepared by ifxPlanForeignScan() will be re-used. Since
- * ifxEndForeignScan() already has deallocated the complete structure, we
- * are required to redeclare the cursor again, to satisfy subsequent
- * EXECUTE calls to the prepared statement. This is relatively easy
- * to check, since the only thing we need to do in ifxBeginForeignScan()
- * is to recheck wether the call stack is empty or not.
+ * Removes the statement of the specified statement info from
+ * the statement cache. Afterwards, ifxRewindCallstack() frees
+ * all its resources like for any other statement. Used when an
+ * error occurred, since we can't tell wether the statement
+ * is still usable.
  */
-static void ifxPrepareCursorForScan(IfxStatementInfo *info,
-									IfxConnectionInfo *coninfo)
+static void ifxUncacheStatement(IfxStatementInfo *info)
 {
-	/*
-	 * Generate a statement identifier. Required to uniquely
-	 * identify the prepared statement within Informix.
-	 */
-	info->stmt_name = ifxGenStatementName(info->refid);
+	IfxCachedConnection *cached;
+	IfxCachedStatement  *stmt = NULL;
 
-	/*
-	 * An identifier for the dynamically allocated
-	 * DESCRIPTOR area.
-	 */
-	info->descr_name = ifxGenDescrName(info->refid);
+	if ((info->call_stack & IFX_STACK_CACHED) != IFX_STACK_CACHED)
+		return;
 
-	/*
-	 * ...and finally the cursor name.
-	 */
-	info->cursor_name = ifxGenCursorName(info->refid);
+	ifxPopCallstack(info, IFX_STACK_CACHED);
 
-	/* Prepare the query. */
-	elog(DEBUG1, "prepare query \"%s\"", info->query);
-	ifxPrepareQuery(info->query,
-					info->stmt_name);
-	ifxCatchExceptions(info, IFX_STACK_PREPARE);
+	if ((cached = ifxGetStmtCache(info->conname)) != NULL)
+		stmt = ifxStmtCache_find(cached, info->stmt_name);
 
-	/*
-	 * Declare the cursor for the prepared
-	 * statement. Check out, if we need to switch the cursor
-	 * type depending on special datatypes first.
-	 */
-	if (coninfo->enable_blobs)
+	if (stmt == NULL)
 	{
-		elog(NOTICE, "informix_fdw: enable_blobs specified, forcing NO SCROLL cursor");
+		/*
+		 * Already evicted, nothing left to free
+		 * on the Informix server.
+		 */
+		ifxPopCallstack(info, IFX_STACK_PREPARE | IFX_STACK_DECLARE);
+		return;
+	}
 
-		if (!coninfo->tx_enabled)
-			ereport(WARNING,
-					(errcode(ERRCODE_FDW_INCONSISTENT_DESCRIPTOR_INFORMATION),
-					 errmsg("informix_fdw: using NO SCROLL cursor without transactions")));
+	elog(DEBUG2, "informix_fdw: uncache statement \"%s\"",
+		 stmt->stmt_name);
 
-		info->cursorUsage = IFX_DEFAULT_CURSOR;
-	}
+	/* The SQLDA structure is freed along with info */
+	if (stmt->sqlda == info->sqlda)
+		stmt->sqlda = NULL;
 
-	elog(DEBUG1, "declare cursor \"%s\"", info->cursor_name);
-	ifxDeclareCursorForPrepared(info->stmt_name,
-								info->cursor_name,
-								info->cursorUsage);
-	ifxCatchExceptions(info, IFX_STACK_DECLARE);
+	ifxStmtCache_rm(cached, stmt);
+	ifxStmtCache_free(stmt);
 }
 
 /*
@@ -5214,9 +10073,13 @@ ifxExplainForeignScan(ForeignScanState *node, ExplainState *es)
 
 	/*
 	 * XXX: We need to get the info from the cached connection!
+	 *
+	 * NOTE: The execution state was already initialized from the
+	 *       plan by the Begin callback. Don't deserialize it again,
+	 *       with EXPLAIN ANALYZE this would overwrite the call stack
+	 *       of the scan before ifxEndForeignScan() is called.
 	 */
 	plan_values = PG_SCANSTATE_PRIVATE_P(node);
-	ifxDeserializeFdwData(festate, plan_values);
 	ifxDeserializePlanData(&planData, plan_values);
 
 	/* Give some possibly useful info about startup costs */
@@ -5227,10 +10090,15 @@ ifxExplainForeignScan(ForeignScanState *node, ExplainState *es)
 #else
 		ExplainPropertyFloat("Informix costs", planData.costs, 2, es);
 #endif
+	}
 
-		/* print planned foreign query */
+	/*
+	 * Print planned foreign query. VERBOSE prints it even
+	 * without costs, so that the query text can be checked
+	 * without depending on the estimates of the Informix server.
+	 */
+	if (es->costs || es->verbose)
 		ExplainPropertyText("Informix query", festate->stmt_info.query, es);
-	}
 }
 
 
@@ -5266,6 +10134,39 @@ static void ifxConnInfoSetDefaults(IfxConnectionInfo *coninfo)
 	 */
 	coninfo->disable_rowid = 0;
 
+	/* leave INSERT cursor buffering to ESQL/C */
+	coninfo->batch_size         = 0;
+	coninfo->insert_buffer_size = 0;
+
+	/* cache prepared statements per connection */
+	coninfo->stmt_cache_size    = IFX_STMT_CACHE_SIZE;
+
+	/* cache plan-time estimates per foreign table */
+	coninfo->estimate_cache_ttl = IFX_ESTIMATE_CACHE_TTL;
+
+	/* ask the Informix server for estimates during planning */
+	coninfo->use_remote_estimate = 1;
+
+	/* costs of remote queries */
+	coninfo->fdw_startup_cost   = IFX_DEFAULT_FDW_STARTUP_COST;
+	coninfo->fdw_tuple_cost     = IFX_DEFAULT_FDW_TUPLE_COST;
+	coninfo->remote_cost_factor = IFX_DEFAULT_REMOTE_COST_FACTOR;
+
+	/* sample remote rows on the Informix server for ANALYZE */
+	coninfo->analyze_sampling   = 1;
+
+	/* ANALYZE samples rows instead of importing Informix statistics */
+	coninfo->import_statistics  = 0;
+
+	/* no functions of extensions are pushed down */
+	coninfo->extensions         = NULL;
+
+	/* no parameterized scans driven by joined relations */
+	coninfo->join_filter_rows   = 0;
+
+	/* optimizer directives are chosen by the plan only */
+	coninfo->optimizer_directives = NULL;
+
 	coninfo->gl_date       = IFX_ISO_DATE;
 	coninfo->gl_datetime   = IFX_ISO_TIMESTAMP;
 	coninfo->db_locale     = NULL;
@@ -5418,6 +10319,92 @@ ifxCloseConnection(PG_FUNCTION_ARGS)
 	PG_RETURN_VOID();
 }
 
+/*
+ * Empties the remote table of the specified foreign table by
+ * TRUNCATE TABLE on the Informix server. The statement runs within
+ * the remote transaction of the cached connection, so it is
+ * rolled back along with the local transaction.
+ */
+static void ifxTruncateForeignTable(Relation rel)
+{
+	IfxConnectionInfo *coninfo;
+	IfxStatementInfo   info;
+	StringInfoData     buf;
+
+	/*
+	 * Activate cached connection, this also starts
+	 * a transaction if required.
+	 */
+	ifxSetupConnection(&coninfo,
+					   RelationGetRelid(rel),
+					   IFX_BEGIN_SCAN,
+					   true);
+
+	if (coninfo->query != NULL)
+		ereport(ERROR, (errcode(ERRCODE_FDW_UNABLE_TO_CREATE_EXECUTION),
+						errmsg("cannot truncate foreign table \"%s\" which is based on a query",
+							   RelationGetRelationName(rel))));
+
+	ifxStatementInfoInit(&info, -1);
+	StrNCpy(info.conname, coninfo->conname, IFX_CONNAME_LEN);
+
+	initStringInfo(&buf);
+	appendStringInfo(&buf, "TRUNCATE TABLE %s",
+					 ifxQuoteIdent(coninfo, coninfo->tablename));
+
+	elog(DEBUG2, "informix_fdw: truncate query \"%s\"", buf.data);
+
+	ifxExecuteImmediate(buf.data);
+	ifxCatchExceptions(&info, 0);
+}
+
+/*
+ * SQL callable TRUNCATE of a foreign table.
+ *
+ * The function is executable by everyone, so check the relkind,
+ * the FDW and the TRUNCATE privilege before locking the relation.
+ * Otherwise any user could queue an AccessExclusiveLock on
+ * arbitrary relations, including catalogs.
+ */
+Datum
+ifxTruncateTable(PG_FUNCTION_ARGS)
+{
+	Oid        relid = PG_GETARG_OID(0);
+	char       relkind;
+	Relation   rel;
+	AclResult  aclresult;
+
+	relkind = get_rel_relkind(relid);
+
+	if (relkind == '\0')
+		ereport(ERROR, (errcode(ERRCODE_UNDEFINED_TABLE),
+						errmsg("relation with OID %u does not exist", relid)));
+
+	if ((relkind != RELKIND_FOREIGN_TABLE)
+		|| (GetFdwRoutineByRelId(relid)->BeginForeignScan != ifxBeginForeignScan))
+		ereport(ERROR, (errcode(ERRCODE_WRONG_OBJECT_TYPE),
+						errmsg("\"%s\" is not a foreign table of informix_fdw",
+							   get_rel_name(relid))));
+
+	aclresult = pg_class_aclcheck(relid, GetUserId(), ACL_TRUNCATE);
+
+	if (aclresult != ACLCHECK_OK)
+#if PG_VERSION_NUM >= 110000
+		aclcheck_error(aclresult, OBJECT_FOREIGN_TABLE,
+					   get_rel_name(relid));
+#else
+		aclcheck_error(aclresult, ACL_KIND_CLASS,
+					   get_rel_name(relid));
+#endif
+
+	rel = heap_open(relid, AccessExclusiveLock);
+
+	ifxTruncateForeignTable(rel);
+
+	heap_close(rel, NoLock);
+	PG_RETURN_VOID();
+}
+
 Datum
 ifxGetConnections(PG_FUNCTION_ARGS)
 {
@@ -5758,33 +10745,46 @@ static void ifx_fdw_xact_callback(XactEvent event, void *arg
 	HASH_SEQ_STATUS      hsearch_status;
 	IfxCachedConnection *cached;
 
-	/*
-	 * No-op if this backend has no in-progress transactions in Informix.
-	 */
-	if (ifxXactInProgress < 1)
-		return;
-
 	/*
 	 * We need to scan through all cached connections to check
-	 * wether they have in-progress transactions.
+	 * wether they have in-progress transactions. Nothing to do
+	 * if this backend has no in-progress transactions in Informix.
 	 */
-	hash_seq_init(&hsearch_status, ifxCache.connections);
-	while ((cached = (IfxCachedConnection *) hash_seq_search(&hsearch_status)))
+	if (ifxXactInProgress > 0)
 	{
-		/*
-		 * No transaction in progress? If true, get to next...
-		 */
-		if (cached->con.tx_in_progress < 1)
-			continue;
+		hash_seq_init(&hsearch_status, ifxCache.connections);
+		while ((cached = (IfxCachedConnection *) hash_seq_search(&hsearch_status)))
+		{
+			/*
+			 * No transaction in progress? If true, get to next...
+			 */
+			if (cached->con.tx_in_progress < 1)
+				continue;
 
-		elog(DEBUG3, "informix_fdw: xact_callback on connection \"%s\"",
-			 cached->con.ifx_connection_name);
+			elog(DEBUG3, "informix_fdw: xact_callback on connection \"%s\"",
+				 cached->con.ifx_connection_name);
 
-		/*
-		 * Execute required actions...
-		 */
-		ifx_fdw_xact_callback_internal(cached, event);
+			/*
+			 * Execute required actions...
+			 */
+			ifx_fdw_xact_callback_internal(cached, event);
+		}
 	}
+
+#if PG_VERSION_NUM >= 90200
+	/*
+	 * Key set tables of foreign scans aborted by an error are
+	 * left behind, since ifxEndForeignScan() isn't called then.
+	 * This is also required without a remote transaction, since
+	 * the temp tables live as long as the Informix session.
+	 */
+	if (event == XACT_EVENT_ABORT
+#if PG_VERSION_NUM >= 90500
+		|| event == XACT_EVENT_PARALLEL_ABORT
+#endif
+		)
+		ifxCleanupKeySets(InvalidSubTransactionId);
+#endif
 }
 
 static void ifx_fdw_subxact_callback(SubXactEvent event,
@@ -5803,10 +10803,18 @@ static void ifx_fdw_subxact_callback(SubXactEvent event,
 	int                  curlevel;
 
 	/*
-	 * No-op if no transaction in progress.
+	 * No-op if no transaction in progress, except for
+	 * the key set tables of foreign scans aborted within
+	 * this subtransaction.
 	 */
 	if (ifxXactInProgress < 1)
+	{
+#if PG_VERSION_NUM >= 90200
+		if (event == SUBXACT_EVENT_ABORT_SUB)
+			ifxCleanupKeySets(subId);
+#endif
 		return;
+	}
 
 	/*
 	 * Nothing to do on subtransaction start or abort.
@@ -5882,10 +10890,51 @@ static void ifx_fdw_subxact_callback(SubXactEvent event,
 		}
 	}
 
+#if PG_VERSION_NUM >= 90200
+	/*
+	 * Drop the key set tables left behind by foreign scans
+	 * aborted within this subtransaction.
+	 */
+	if (event == SUBXACT_EVENT_ABORT_SUB)
+		ifxCleanupKeySets(subId);
+#endif
+}
+
+/*
+ * Drops the cached estimates of a foreign table on relcache
+ * invalidation, e.g. by ALTER FOREIGN TABLE. InvalidOid means
+ * all relations.
+ */
+static void ifx_fdw_relcache_callback(Datum arg, Oid relid)
+{
+	ifxFTCache_invalidate(relid);
+}
+
+/*
+ * Drops all cached estimates if options of a foreign
+ * table or server were changed.
+ */
+static void ifx_fdw_syscache_callback(Datum arg, int cacheid,
+#if PG_VERSION_NUM >= 90200
+									  uint32 hashvalue
+#else
+									  ItemPointer tuplePtr
+#endif
+	)
+{
+	ifxFTCache_invalidate(InvalidOid);
 }
 
 void _PG_init()
 {
 	RegisterXactCallback(ifx_fdw_xact_callback, NULL);
 	RegisterSubXactCallback(ifx_fdw_subxact_callback, NULL);
+
+	CacheRegisterRelcacheCallback(ifx_fdw_relcache_callback, (Datum) 0);
+	CacheRegisterSyscacheCallback(FOREIGNTABLEREL,
+								  ifx_fdw_syscache_callback,
+								  (Datum) 0);
+	CacheRegisterSyscacheCallback(FOREIGNSERVEROID,
+								  ifx_fdw_syscache_callback,
+								  (Datum) 0);
 }
@@ -141,6 +141,13 @@ typedef struct IfxFdwExecutionState
 	 */
 	bool rescan;
 
+	/*
+	 * Set to true by ifxBeginForeignScan() if opening the
+	 * cursor is deferred until the values of its query
+	 * parameters are known.
+	 */
+	bool open_pending;
+
 	/*
 	 * Use rowid in modify actions. This is the default
 	 * and is set during ifxBeginForeignModify().
@@ -178,6 +185,69 @@ typedef struct IfxFdwExecutionState
 	 */
 	bool has_after_row_triggers;
 
+	/*
+	 * Number of rows affected by a modify action sent
+	 * directly to the Informix server. -1 as long as the
+	 * statement wasn't executed.
+	 */
+	int affected_rows;
+
+	/*
+	 * Number of rows fetched by a foreign scan since the cursor
+	 * was opened last. scan_complete is set as soon as the cursor
+	 * reported the end of the result set.
+	 */
+	double rows_fetched;
+	bool   scan_complete;
+
+	/*
+	 * Number of rows to PUT into an INSERT cursor before it gets
+	 * flushed explicitly, 0 leaves flushing to ESQL/C. rows_buffered
+	 * counts the rows not flushed yet.
+	 */
+	int batch_size;
+	int rows_buffered;
+
+	/*
+	 * Set if an INSERT executes the prepared statement for each
+	 * row instead of PUTting it into the INSERT cursor, to return
+	 * the SERIAL values generated for it, see ifxExecInsertReturning().
+	 */
+	bool insert_returning;
+
+	/*
+	 * ROWIDs of the rows modified by the next execution of a
+	 * batched UPDATE or DELETE. For UPDATE, batch_values and
+	 * batch_nulls hold the column values assigned to all rows
+	 * of the batch.
+	 */
+	int   *batch_rowids;
+	Datum *batch_values;
+	bool  *batch_nulls;
+
+	/*
+	 * Query parameters of the predicates pushed down by a
+	 * foreign scan. param_exprs holds their ExprState, params
+	 * their current values, bound when the cursor is opened.
+	 */
+	List         *param_exprs;
+	int           nparams;
+	IfxScanParam *params;
+
+	/*
+	 * Names of the key set tables on the Informix server, loaded
+	 * with the array values of keyset_exprs (ExprState) before the
+	 * cursor is opened. See ifxPlanKeySets() for details.
+	 * keyset_columns holds the deparsed columns compared with the
+	 * keys, the semi joins against the key set tables make up the
+	 * text between keyset_start and keyset_end of the query.
+	 */
+	List         *keyset_names;
+	List         *keyset_columns;
+	List         *keyset_exprs;
+	int           keyset_start;
+	int           keyset_end;
+
 } IfxFdwExecutionState;
 
 #if PG_VERSION_NUM >= 90200
@@ -196,8 +266,75 @@ typedef struct IfxFdwPlanState
 	 * Excluded RestrictInfo after pushdown analysis.
 	 */
 	List *excl_restrictInfo;
+
+	/*
+	 * Expressions of the query parameters of the pushed
+	 * down predicates, passed to the executor as fdw_exprs.
+	 */
+	List *param_exprs;
+
+	/*
+	 * IfxKeySet structures of the clauses pushed down as a
+	 * semi join against a key set table. Their arrays are passed
+	 * to the executor after param_exprs in fdw_exprs.
+	 */
+	List *keysets;
+
+	/*
+	 * OID of the foreign table providing the connection
+	 * options. For upper relations this is the foreign table
+	 * of the underlying scan relation.
+	 */
+	Oid foreignTableOid;
+
+	/*
+	 * The following members are used by upper and join relations
+	 * (grouping, aggregation and joins pushed down to the Informix
+	 * server) only.
+	 */
+	RelOptInfo *outerrel;  /* input relation of an upper relation or
+							  outer relation of a join */
+	RelOptInfo *innerrel;  /* inner relation of a join */
+	JoinType jointype;     /* type of join */
+	List *joinclauses;     /* join conditions, evaluated remotely */
+	List *scan_tlist;      /* target list of the remote query */
+	List *remote_conds;    /* WHERE or HAVING expressions evaluated remotely */
+	List *local_conds;     /* expressions evaluated locally */
+
+	/*
+	 * Indexes of the remote table of a simple relation, with
+	 * attribute numbers of the foreign table as index parts.
+	 */
+	int          nindexes;
+	IfxIndexDef *indexes;
+
+	/*
+	 * OIDs of the extensions whose functions can be pushed
+	 * down, see the extensions option. Simple relations only.
+	 */
+	List *extensions;
 } IfxFdwPlanState;
 
+/*
+ * Array of keys compared with a column of a foreign table, shipped
+ * to the Informix server as a temporary table (key set table).
+ */
+typedef struct IfxKeySet
+{
+	Node *clause;    /* the original = ANY() restriction clause */
+	Node *keys;      /* array expression of the keys */
+	char *tablename; /* name of the key set table */
+	char *column;    /* deparsed column compared with the keys */
+} IfxKeySet;
+
+/*
+ * Relation scanning a single foreign table, either directly
+ * or as a member of an inheritance tree or partitioned table.
+ */
+#define IFX_IS_SIMPLE_REL(rel) \
+	(((rel)->reloptkind == RELOPT_BASEREL) \
+	 || ((rel)->reloptkind == RELOPT_OTHER_MEMBER_REL))
+
 #endif
 
 /*
@@ -213,6 +350,7 @@ typedef enum IfxOprType
 	IFX_OPR_GT,
 	IFX_OPR_LT,
 	IFX_OPR_LIKE,
+	IFX_OPR_NOT_LIKE,
 	IFX_OPR_AND,
 	IFX_OPR_OR,
 	IFX_OPR_NOT,
@@ -284,9 +422,71 @@ typedef struct IfxPushdownOprContext
 	List *predicates;    /* list of IfxPushDownOprInfo */
 	int   count;         /* number of elements in predicates list */
 	int   count_removed; /* number of removed predicates for FDW pushdown */
-	bool  has_or_expr;
+	List *params;        /* expressions sent as query parameters (?) */
+	bool  lossy;         /* parameter values might be rounded */
 } IfxPushdownOprContext;
 
+#if PG_VERSION_NUM >= 90600
+
+/*
+ * Context for deparsing complete expression trees into
+ * Informix SQL, see ifxDeparseRemoteExpr().
+ */
+typedef struct IfxDeparseContext
+{
+	PlannerInfo *root;        /* planner state of the current query */
+	RelOptInfo  *scanrel;     /* relation column references must belong to */
+	StringInfo   buf;         /* output buffer */
+	bool         qualify_col; /* qualify column references with the
+								 alias of their relation (joins) */
+	List        *extensions;  /* OIDs of extensions with shippable functions */
+} IfxDeparseContext;
+
+/*
+ * Styles of deparsing built-in operators and functions
+ * into Informix SQL, see ifxShippableObjects in ifx_conv.c.
+ */
+typedef enum IfxShippableStyle
+{
+	IFX_SHIP_INFIX,       /* (a op b), or (op a) for prefix operators */
+	IFX_SHIP_INFIX_UPPER, /* (UPPER(a) op UPPER(b)), case insensitive matching */
+	IFX_SHIP_FUNCTION,    /* name(a, b, ...) */
+	IFX_SHIP_DATE_PART    /* name(b), first argument selects the function */
+} IfxShippableStyle;
+
+/*
+ * Classes of argument types accepted by a shippable
+ * operator or function.
+ */
+typedef enum IfxShippableTypes
+{
+	IFX_SHIP_TYPE_NONE,         /* no argument at this position */
+	IFX_SHIP_TYPE_INTEGER,      /* SMALLINT, INTEGER, INT8 */
+	IFX_SHIP_TYPE_POSITIVE_INT, /* INTEGER constant greater than zero */
+	IFX_SHIP_TYPE_FLOAT,        /* SMALLFLOAT, FLOAT */
+	IFX_SHIP_TYPE_NUMERIC,      /* any of the above and DECIMAL */
+	IFX_SHIP_TYPE_TEXT,         /* text and varchar */
+	IFX_SHIP_TYPE_BPCHAR,       /* blank padded character strings */
+	IFX_SHIP_TYPE_DATETIME,     /* DATE and timestamp without time zone */
+	IFX_SHIP_TYPE_FIELD         /* text constant naming a date/time field */
+} IfxShippableTypes;
+
+#define IFX_SHIP_MAX_ARGS 3
+
+/*
+ * Built-in operator or function with an Informix equivalent.
+ */
+typedef struct IfxShippableObject
+{
+	char               kind;     /* 'o' operator, 'f' function */
+	char              *pgname;   /* name in pg_catalog */
+	IfxShippableTypes  argtypes[IFX_SHIP_MAX_ARGS]; /* accepted argument types */
+	char              *ifxname;  /* Informix spelling */
+	IfxShippableStyle  style;    /* how to deparse the expression */
+} IfxShippableObject;
+
+#endif
+
 #if PG_VERSION_NUM >= 90500
 
 typedef struct IfxImportTableDef
@@ -306,6 +506,27 @@ typedef struct IfxImportTableDef
  */
 #define IFX_REQUIRED_CONN_KEYWORDS 4
 
+/*
+ * Default costs of a foreign scan, see the fdw_startup_cost,
+ * fdw_tuple_cost and remote_cost_factor options.
+ */
+#define IFX_DEFAULT_FDW_STARTUP_COST   100.0
+#define IFX_DEFAULT_FDW_TUPLE_COST     0.01
+#define IFX_DEFAULT_REMOTE_COST_FACTOR 1.0
+
+/*
+ * Costs of sorting the result of a foreign scan on the Informix
+ * server without a matching index are estimated by multiplying
+ * the costs of the unsorted scan with this factor.
+ */
+#define IFX_DEFAULT_FDW_SORT_MULTIPLIER 1.2
+
+/*
+ * Size of the fetch buffer used by ANALYZE, which transfers
+ * as many sample rows at once as fit into it.
+ */
+#define IFX_ANALYZE_FETCH_BUFFER_SIZE 32767
+
 /*
  * Helper macros to access various struct members.
  */
@@ -414,19 +635,31 @@ void setIfxDecimal(IfxFdwExecutionState *state,
 void setIfxFloat(IfxFdwExecutionState *state,
 				 TupleTableSlot       *slot,
 				 int                   attnum);
+bool ifxScanParamFromDatum(IfxScanParam *param, Oid typid,
+						   Datum value, bool isnull);
+List *ifxExtractExtensionList(char *extensions, bool warnOnMissing);
+char *ifxKeySetColumnType(Oid typid);
+bool ifxIsKeySetExpr(Node *clause, Index foreign_rtid,
+					 Var **colref, Node **keys);
+void ifxDeparseKeySetExprs(StringInfo buf, List *columns, List *tablenames);
+bool ifxIsJoinParamExpr(Node *clause, Index foreign_rtid,
+						Var **colref, Node **param);
+char *ifxDeparseColumnRef(Oid foreign_relid, Index foreign_rtid,
+						  Var *colref);
 
 /*
  * Internal API for PostgreSQL 9.3 and above.
  */
 
 #if PG_VERSION_NUM >= 90300
-char *dispatchColumnIdentifier(int varno, int varattno, PlannerInfo *root);
+char *dispatchColumnIdentifier(int varno, int varattno, PlannerInfo *root,
+							   bool qualify);
+char *ifxColumnIdentifierByRelid(Oid relid, int attnum);
 void ifxGenerateDeleteSql(IfxFdwExecutionState *state,
 						  IfxConnectionInfo    *coninfo);
 void ifxGenerateInsertSql(IfxFdwExecutionState *state,
 						  IfxConnectionInfo    *coninfo,
-						  PlannerInfo *root,
-						  Index        rtindex);
+						  Oid                   foreignTableOid);
 #endif
 
 /*
@@ -434,5 +667,41 @@ void ifxGenerateInsertSql(IfxFdwExecutionState *state,
  */
 bool ifx_predicate_tree_walker(Node *node, struct IfxPushdownOprContext *context);
 
+#if PG_VERSION_NUM >= 90600
+bool ifxDeparseRemoteExpr(Node *node, IfxDeparseContext *context);
+bool ifxIsShippableExpr(PlannerInfo *root, RelOptInfo *scanrel, Node *expr);
+List *ifxRelShippableExtensions(PlannerInfo *root, RelOptInfo *rel);
+Var *ifxPathKeyVar(PathKey *pathkey, RelOptInfo *rel);
+void ifxGenerateOrderBySql(StringInfo   buf,
+						   PlannerInfo *root,
+						   RelOptInfo  *rel,
+						   List        *pathkeys);
+void ifxGenerateGroupedSql(IfxFdwExecutionState *state,
+						   IfxConnectionInfo    *coninfo,
+						   PlannerInfo          *root,
+						   RelOptInfo           *scanrel,
+						   List                 *tlist,
+						   List                 *where_conds,
+						   List                 *having_conds);
+void ifxGenerateJoinSql(IfxFdwExecutionState *state,
+						PlannerInfo          *root,
+						RelOptInfo           *joinrel,
+						List                 *tlist);
+void ifxGenerateDirectModifySql(IfxFdwExecutionState *state,
+								IfxConnectionInfo    *coninfo,
+								PlannerInfo          *root,
+								RelOptInfo           *baserel,
+								CmdType               operation,
+								List                 *targetlist,
+								List                 *where_conds);
+void ifxGenerateInsertSelectSql(IfxFdwExecutionState *state,
+								IfxConnectionInfo    *coninfo,
+								Oid                   foreignTableOid,
+								PlannerInfo          *root,
+								RelOptInfo           *scanrel,
+								List                 *targetlist,
+								List                 *where_conds);
+#endif
+
 #endif
 
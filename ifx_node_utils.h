@@ -42,7 +42,7 @@
  * Number of serialized Const nodes passed
  * from ifxPlanForeignScan()
  */
-#define N_SERIALIZED_FIELDS 11
+#define N_SERIALIZED_FIELDS 15
 
 /*
  * Identifier for serialized Const fields
@@ -61,9 +61,14 @@
 #define SERIALIZED_REFID        8
 #define SERIALIZED_USE_ROWID    9
 #define SERIALIZED_HAS_AFTER_TRIGGERS 10
+#define SERIALIZED_BATCH_SIZE   11
+#define SERIALIZED_KEYSETS      12
+#define SERIALIZED_KEYSET_START 13
+#define SERIALIZED_KEYSET_END   14
 
 #define SERIALIZED_DATA(_vals_) Const * (_vals_)[N_SERIALIZED_FIELDS]
 #define AFFECTED_ATTR_NUMS_IDX (N_SERIALIZED_FIELDS)
+#define KEYSET_COLUMNS_IDX (N_SERIALIZED_FIELDS + 1)
 
 /*******************************************************************************
  * Node helper functions.
@@ -88,10 +93,10 @@ void ifxGenerateUpdateSql(IfxFdwExecutionState *state,
 						  Index                 rtindex);
 void ifxGenerateInsertSql(IfxFdwExecutionState *state,
 						  IfxConnectionInfo    *coninfo,
-						  PlannerInfo *root,
-						  Index        rtindex);
+						  Oid                   foreignTableOid);
 char *ifxGetIntervalFormatString(IfxTemporalRange range, IfxFormatMode mode);
 char *ifxQuoteIdent(IfxConnectionInfo *coninfo, char *ident);
+char *ifxQueryShape(char *query);
 
 #if PG_VERSION_NUM >= 90500
 
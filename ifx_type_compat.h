@@ -63,6 +63,11 @@
 #define IFX_CONVERSION_UNDEFINED -254
 #define	IFX_CONVERSION_OK 0
 
+/*
+ * SQLCODE of CREATE TABLE if the table already exists.
+ */
+#define IFX_TABLE_EXISTS -310
+
 /*
  * Flags to identify current state
  * of informix calls.
@@ -74,6 +79,14 @@
 #define IFX_STACK_DESCRIBE 8
 #define IFX_STACK_OPEN     16
 
+/*
+ * Set in addition to IFX_STACK_PREPARE and IFX_STACK_DECLARE
+ * if the prepared statement and its cursor are owned by the
+ * statement cache of the connection. These are never freed
+ * when rewinding the call stack.
+ */
+#define IFX_STACK_CACHED   32
+
 /*
  * Special flags set during DESCRIBE phase to
  * identify special columns (e.g. BLOBS)
@@ -227,7 +240,8 @@ typedef enum IfxSourceType
 	 */
 	IFX_LVARCHAR  = 43,
 	IFX_BOOLEAN   = 45,
-	IFX_INFX_INT8 = 52
+	IFX_INFX_INT8 = 52,
+	IFX_BIGSERIAL = 53
 
 } IfxSourceType;
 
@@ -364,8 +378,15 @@ typedef struct IfxPlanData
 {
 	double estimated_rows;
 	double costs;
+	double startup_costs;
 	double total_costs;
 
+	/*
+	 * Costs of the remote query in PostgreSQL
+	 * cost units, see remote_cost_factor.
+	 */
+	double remote_costs;
+
 	/*
 	 * Table statistics derived
 	 * from Informix.
@@ -378,6 +399,62 @@ typedef struct IfxPlanData
 
 } IfxPlanData;
 
+/*
+ * Column statistics derived from the Informix
+ * system catalog, see ifxGetColumnStats().
+ */
+typedef struct IfxColumnStats
+{
+	/* syscolumns, without the NOT NULL flag */
+	short coltype;
+
+	/* 1 if the column is declared NOT NULL */
+	short notnull;
+
+	/*
+	 * Second smallest and second largest value of the
+	 * column, only maintained by UPDATE STATISTICS for
+	 * indexed numeric columns.
+	 */
+	short has_minmax;
+	int   colmin;
+	int   colmax;
+
+	/*
+	 * Number of distinct values of the column, if it is the
+	 * leading column of an index. 0 if unknown.
+	 */
+	double nunique;
+
+	/* 1 if there's a unique index on this column alone */
+	short unique;
+
+} IfxColumnStats;
+
+/*
+ * Maximum number of columns of an Informix index and the
+ * maximum number of indexes retrieved per table.
+ */
+#define IFX_MAX_INDEX_PARTS 16
+#define IFX_MAX_INDEX_DEFS  32
+
+/*
+ * Definition of an index of a remote table, see
+ * ifxGetIndexDefs().
+ */
+typedef struct IfxIndexDef
+{
+	short unique;   /* 1 = unique index */
+	short nparts;   /* number of index columns */
+
+	/*
+	 * Column numbers of the index columns, starting at 1. The
+	 * sort direction is ignored, Informix traverses indexes in
+	 * both directions.
+	 */
+	short parts[IFX_MAX_INDEX_PARTS];
+} IfxIndexDef;
+
 /*
  * Foreign scan modes.
  *
@@ -446,6 +523,19 @@ typedef struct IfxConnectionInfo
 						   1 = special BLOB support */
 	short disable_rowid; /* 1 = disable, 0 enable rowid (default) */
 	short delimident; /* 1 = DELIMIDENT set, 0 = disabled */
+	int   batch_size; /* rows per explicit FLUSH of an INSERT cursor, 0 = disabled */
+	int   insert_buffer_size; /* size of the INSERT cursor buffer, 0 = ESQL/C default */
+	int   stmt_cache_size; /* statements cached per connection, 0 = disabled */
+	int   estimate_cache_ttl; /* seconds to keep cached estimates, 0 = disabled */
+	short use_remote_estimate; /* 1 = plan with Informix estimates (default), 0 = local statistics */
+	double fdw_startup_cost; /* costs of starting a remote query */
+	double fdw_tuple_cost; /* costs of transferring a row */
+	double remote_cost_factor; /* converts Informix costs into PostgreSQL costs */
+	short analyze_sampling; /* 1 = sample remote rows by ROWID for ANALYZE (default), 0 = full scan */
+	short import_statistics; /* 1 = ANALYZE imports Informix catalog statistics, 0 = sample rows (default) */
+	char *extensions; /* comma separated list of extensions with shippable functions */
+	int   join_filter_rows; /* max rows of a joined relation driving parameterized scans, 0 = disabled */
+	char *optimizer_directives; /* Informix optimizer directives added to scans of the table */
 
 	/* plan data */
 	IfxPlanData planData;
@@ -480,6 +570,30 @@ typedef struct IfxPGCachedConnection
 	int tx_num_rollback;
 } IfxPGCachedConnection;
 
+/*
+ * Types of the parameter values bound to a cursor
+ * by ifxOpenCursorWithParams().
+ */
+typedef enum IfxParamType
+{
+	IFX_PARAM_STRING,   /* character string, converted by the server */
+	IFX_PARAM_INTEGER,  /* 4 byte integer */
+	IFX_PARAM_DATE,     /* DATE, number of days since 1899-12-31 */
+	IFX_PARAM_DATETIME  /* DATETIME YEAR TO FRACTION(5) as ANSI string */
+} IfxParamType;
+
+/*
+ * Value of a query parameter pushed down by a
+ * foreign scan.
+ */
+typedef struct IfxScanParam
+{
+	IfxParamType type;
+	short        isnull;
+	int          intval; /* IFX_PARAM_INTEGER and IFX_PARAM_DATE */
+	char        *strval; /* IFX_PARAM_STRING and IFX_PARAM_DATETIME */
+} IfxScanParam;
+
 /*
  * IfxStatementInfo
  *
@@ -542,6 +656,12 @@ typedef struct IfxStatementInfo
 	 */
 	char *predicate;
 
+	/*
+	 * Optimizer directives added to the query, without
+	 * the surrounding {+ }. NULL if there are none.
+	 */
+	char *directives;
+
 	/*
 	 * Name of an associated cursor.
 	 */
@@ -620,9 +740,18 @@ void ifxPrepareQuery(char *query, char *stmt_name);
 void ifxAllocateDescriptor(char *descr_name, int num_items);
 void ifxDescribeAllocatorByName(IfxStatementInfo *state);
 int ifxDescriptorColumnCount(IfxStatementInfo *state);
+int ifxDescriptorColumnWidth(IfxStatementInfo *state, int ifx_attnum);
 void ifxDeclareCursorForPrepared(char *stmt_name, char *cursor_name,
 								 IfxCursorUsage cursorType);
 void ifxOpenCursorForPrepared(IfxStatementInfo *state);
+int ifxOpenCursorWithParams(IfxStatementInfo *state,
+							IfxScanParam *params,
+							int nparams,
+							int *failed_param);
+int ifxPutParams(IfxStatementInfo *state,
+				 IfxScanParam *params,
+				 int nparams);
+void ifxExecuteImmediate(char *query);
 size_t ifxGetColumnAttributes(IfxStatementInfo *state);
 void ifxFetchRowFromCursor(IfxStatementInfo *state);
 void ifxFetchFirstRowFromCursor(IfxStatementInfo *state);
@@ -636,8 +765,11 @@ char ifxGetSQLCAWarn(signed short warn);
 int ifxGetSQLCAErrd(signed short ca);
 void ifxSetDescriptorCount(char *descr_name, int count);
 void ifxGetSystableStats(char *tablename, IfxPlanData *planData);
+void ifxGetColumnStats(char *tablename, int colno, IfxColumnStats *stats);
+int ifxGetIndexDefs(char *tablename, IfxIndexDef *indexes, int maxindexes);
 void ifxPutValuesInPrepared(IfxStatementInfo *state);
 void ifxFlushCursor(IfxStatementInfo *info);
+int ifxSetFetchBufferSize(int size);
 IfxIndicatorValue ifxSetSqlVarIndicator(IfxStatementInfo *info, int ifx_attnum,
 										IfxIndicatorValue value);
 void ifxExecuteStmt(IfxStatementInfo *state);
@@ -672,6 +804,7 @@ int ifxGetSqlCode(void);
 char *ifxGetFloatAsString(IfxStatementInfo *state, int attnum, char *buf);
 char *ifxGetInt8(IfxStatementInfo *state, int attnum, char *buf);
 char *ifxGetBigInt(IfxStatementInfo *state, int attnum, char *buf);
+char *ifxGetSerial8(int bigserial, char *buf);
 char *ifxGetDateAsString(IfxStatementInfo *state, int ifx_attnum,
 						 char *buf);
 char *ifxGetTimestampAsString(IfxStatementInfo *state, int ifx_attnum,
@@ -738,6 +871,8 @@ short ifxMaskTypeId(short typeid);
 #define SQLCA_WARN(a) sqlca.sqlwarn.sqlwarn##a
 
 #define SQLCA_NROWS_PROCESSED 0
+#define SQLCA_SERIAL_VALUE    1
+#define SQLCA_NROWS_AFFECTED  2
 #define SQLCA_NROWS_WEIGHT    3
 
 #endif
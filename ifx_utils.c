@@ -20,10 +20,18 @@
 
 #include <utils/syscache.h>
 
+#if PG_VERSION_NUM >= 90600
+#include <access/stratnum.h>
+#include <utils/lsyscache.h>
+#include <utils/typcache.h>
+#endif
+
 static void ifxFdwExecutionStateToList(Const *const_vals[],
 									   IfxFdwExecutionState *state);
 static Datum
 ifxFdwPlanDataAsBytea(IfxConnectionInfo *coninfo);
+static void ifxAppendRowIdCondition(StringInfo sql,
+									IfxFdwExecutionState *state);
 
 #if PG_VERSION_NUM >= 90500
 static char *ifxPgIntervalQualifierString(IfxTemporalRange range);
@@ -89,6 +97,69 @@ char *ifxPgTemporalQualifier[]
 	(((mode) == FMT_PG) ? ifxTemporalFormat[(ident)]._PG \
 	 : ifxTemporalFormat[(ident)]._IFX)
 
+/*
+ * Key set table names are serialized as a comma
+ * separated list, an empty string if there are none.
+ */
+static char *ifxSerializeKeySetNames(List *names)
+{
+	StringInfoData  buf;
+	ListCell       *cell;
+
+	initStringInfo(&buf);
+
+	foreach(cell, names)
+	{
+		if (buf.len > 0)
+			appendStringInfoChar(&buf, ',');
+
+		appendStringInfoString(&buf, (char *) lfirst(cell));
+	}
+
+	return buf.data;
+}
+
+static List *ifxDeserializeKeySetNames(char *serialized)
+{
+	List *result = NIL;
+	char *name;
+
+	for (name = strtok(pstrdup(serialized), ",");
+		 name != NULL;
+		 name = strtok(NULL, ","))
+		result = lappend(result, name);
+
+	return result;
+}
+
+/*
+ * The columns compared with the keys of the key set tables are
+ * deparsed identifiers, which might contain any character. They
+ * are serialized as a list of String nodes, following the
+ * affectedAttrNums list.
+ */
+static List *ifxSerializeKeySetColumns(List *columns)
+{
+	List     *result = NIL;
+	ListCell *cell;
+
+	foreach(cell, columns)
+		result = lappend(result, makeString(pstrdup((char *) lfirst(cell))));
+
+	return result;
+}
+
+static List *ifxDeserializeKeySetColumns(List *serialized)
+{
+	List     *result = NIL;
+	ListCell *cell;
+
+	foreach(cell, serialized)
+		result = lappend(result, strVal(lfirst(cell)));
+
+	return result;
+}
+
 /*
  * Deserialize data from fdw_private, passed
  * from the planner via PlanForeignScan().
@@ -126,12 +197,22 @@ void ifxDeserializeFdwData(IfxFdwExecutionState *state,
 															   SERIALIZED_USE_ROWID);
 	state->has_after_row_triggers = ifxGetSerializedInt16Field(params,
 															   SERIALIZED_HAS_AFTER_TRIGGERS);
+	state->batch_size             = ifxGetSerializedInt32Field(params,
+															   SERIALIZED_BATCH_SIZE);
+	state->keyset_names           = ifxDeserializeKeySetNames(ifxGetSerializedStringField(params,
+																						  SERIALIZED_KEYSETS));
+	state->keyset_start           = ifxGetSerializedInt32Field(params,
+															   SERIALIZED_KEYSET_START);
+	state->keyset_end             = ifxGetSerializedInt32Field(params,
+															   SERIALIZED_KEYSET_END);
 
 	/*
-	 * This has to be the last entry, see ifxSerializedPlanData()
+	 * These have to be the last entries, see ifxSerializedPlanData()
 	 * for details!
 	 */
 	state->affectedAttrNums       = list_nth(params, AFFECTED_ATTR_NUMS_IDX);
+	state->keyset_columns         = ifxDeserializeKeySetColumns(list_nth(params,
+																		 KEYSET_COLUMNS_IDX));
 }
 
 /*
@@ -226,6 +307,18 @@ static void ifxFdwExecutionStateToList(Const *const_vals[],
 
 	const_vals[SERIALIZED_HAS_AFTER_TRIGGERS]
 		= makeFdwInt16Const(state->has_after_row_triggers);
+
+	const_vals[SERIALIZED_BATCH_SIZE]
+		= makeFdwInt32Const(state->batch_size);
+
+	const_vals[SERIALIZED_KEYSETS]
+		= makeFdwStringConst(ifxSerializeKeySetNames(state->keyset_names));
+
+	const_vals[SERIALIZED_KEYSET_START]
+		= makeFdwInt32Const(state->keyset_start);
+
+	const_vals[SERIALIZED_KEYSET_END]
+		= makeFdwInt32Const(state->keyset_end);
 }
 
 /*
@@ -240,10 +333,11 @@ static void ifxFdwExecutionStateToList(Const *const_vals[],
  *
  * 1. Const with a bytea value, holding the binary representation
  *    of IfxPlanData struct
- * 2. - 10. String or int fields of IfxFdwExecutionState, that are:
+ * 2. - 15. String or int fields of IfxFdwExecutionState, that are:
  *         query, stmt_name, cursor_name, ...
- * 11. The last member is always the affectedAttrNums list from the
- *     state structure.
+ * 16. The affectedAttrNums list from the state structure.
+ * 17. The last member is always the list of key set columns
+ *     from the state structure.
  *
  */
 List * ifxSerializePlanData(IfxConnectionInfo *coninfo,
@@ -288,11 +382,13 @@ List * ifxSerializePlanData(IfxConnectionInfo *coninfo,
 	 *
 	 * NOTE:
 	 *
-	 * This should always be the last list member, since
+	 * This should always follow the Const array, since
 	 * this makes it possible to address it via
-	 * AFFECTED_ATTR_NUMS_IDX macro directly.
+	 * AFFECTED_ATTR_NUMS_IDX macro directly. The same applies
+	 * to the key set columns and KEYSET_COLUMNS_IDX.
 	 */
 	result = lappend(result, state->affectedAttrNums);
+	result = lappend(result, ifxSerializeKeySetColumns(state->keyset_columns));
 
 	MemoryContextSwitchTo(old_cxt);
 
@@ -483,11 +579,39 @@ void ifxGenerateDeleteSql(IfxFdwExecutionState *state,
 		appendStringInfo(&sql, " WHERE CURRENT OF %s",
 					 state->stmt_info.cursor_name);
 	else
-		appendStringInfo(&sql, " WHERE rowid = ?");
+	{
+		appendStringInfoChar(&sql, ' ');
+		ifxAppendRowIdCondition(&sql, state);
+	}
 
 	state->stmt_info.query = sql.data;
 }
 
+/*
+ * Appends the WHERE condition identifying the target rows of
+ * an UPDATE or DELETE by their ROWID. If the execution state
+ * requests batching, the condition matches a list of batch_size
+ * ROWIDs, see ifxFlushRowIdBatch() for details.
+ */
+static void ifxAppendRowIdCondition(StringInfo sql,
+									IfxFdwExecutionState *state)
+{
+	int i;
+
+	if (state->batch_size <= 1)
+	{
+		appendStringInfoString(sql, "WHERE rowid = ?");
+		return;
+	}
+
+	appendStringInfoString(sql, "WHERE rowid IN (");
+
+	for (i = 0; i < state->batch_size; i++)
+		appendStringInfoString(sql, (i == 0) ? "?" : ", ?");
+
+	appendStringInfoChar(sql, ')');
+}
+
 /*
  * Generates a SQL statement for UPDATE operation on a
  * remote Informix table. Assumes the caller already
@@ -535,7 +659,7 @@ void ifxGenerateUpdateSql(IfxFdwExecutionState *state,
 		first = false;
 
 		appendStringInfoString(&sql,
-							   dispatchColumnIdentifier(rtindex, attnum, root));
+							   dispatchColumnIdentifier(rtindex, attnum, root, false));
 		appendStringInfoString(&sql, " = ? ");
 	}
 
@@ -549,7 +673,7 @@ void ifxGenerateUpdateSql(IfxFdwExecutionState *state,
 	if (coninfo->disable_rowid)
 		appendStringInfo(&sql, "WHERE CURRENT OF %s", state->stmt_info.cursor_name);
 	else
-		appendStringInfo(&sql, "WHERE rowid = ?");
+		ifxAppendRowIdCondition(&sql, state);
 
 	/*
 	 * And we're done.
@@ -568,8 +692,7 @@ void ifxGenerateUpdateSql(IfxFdwExecutionState *state,
  */
 void ifxGenerateInsertSql(IfxFdwExecutionState *state,
 						  IfxConnectionInfo    *coninfo,
-						  PlannerInfo          *root,
-						  Index                 rtindex)
+						  Oid                   foreignTableOid)
 {
 	StringInfoData  sql;
 	ListCell       *cell;
@@ -606,7 +729,7 @@ void ifxGenerateInsertSql(IfxFdwExecutionState *state,
 		first = false;
 
 		appendStringInfoString(&sql,
-							   dispatchColumnIdentifier(rtindex, attnum, root));
+							   ifxColumnIdentifierByRelid(foreignTableOid, attnum));
 	}
 
 	appendStringInfoString(&sql, ") VALUES(");
@@ -631,6 +754,495 @@ void ifxGenerateInsertSql(IfxFdwExecutionState *state,
 
 #endif
 
+#if PG_VERSION_NUM >= 90600
+
+/*
+ * Appends the specified list of expressions, AND'ed together,
+ * to the SQL string hold by the deparse context. Nothing is
+ * appended in case the list is empty.
+ */
+static void ifxDeparseCondList(List              *conds,
+							   char              *keyword,
+							   IfxDeparseContext *context)
+{
+	ListCell *cell;
+	bool      first;
+
+	first = true;
+	foreach(cell, conds)
+	{
+		appendStringInfoString(context->buf, (first) ? keyword : " AND ");
+		first = false;
+
+		if (!ifxDeparseRemoteExpr((Node *) lfirst(cell), context))
+			elog(ERROR, "could not deparse expression for remote query");
+	}
+}
+
+/*
+ * Generates the SELECT statement for a grouped relation pushed
+ * down to the Informix server. Assumes the caller already
+ * had initialized the specified IfxFdwExecutionState and
+ * IfxConnectionInfo handles correctly.
+ *
+ * All expressions in tlist, where_conds and having_conds must have
+ * been checked by ifxIsShippableExpr() before. GROUP BY expressions
+ * are referenced by their position in the select list, since Informix
+ * doesn't accept arbitrary expressions there.
+ *
+ * The generated query string will be stored into the
+ * specified execution state structure.
+ */
+void ifxGenerateGroupedSql(IfxFdwExecutionState *state,
+						   IfxConnectionInfo    *coninfo,
+						   PlannerInfo          *root,
+						   RelOptInfo           *scanrel,
+						   List                 *tlist,
+						   List                 *where_conds,
+						   List                 *having_conds)
+{
+	StringInfoData    sql;
+	IfxDeparseContext context;
+	ListCell         *cell;
+	bool              first;
+
+	Assert((state != NULL)
+		   && (coninfo != NULL)
+		   && (coninfo->tablename != NULL));
+
+	if (tlist == NIL)
+		elog(ERROR, "empty target list for remote grouped query");
+
+	initStringInfo(&sql);
+
+	context.root        = root;
+	context.scanrel     = scanrel;
+	context.buf         = &sql;
+	context.qualify_col = false;
+	context.extensions  = ifxRelShippableExtensions(root, scanrel);
+
+	appendStringInfoString(&sql, "SELECT ");
+
+	first = true;
+	foreach(cell, tlist)
+	{
+		TargetEntry *tle = (TargetEntry *) lfirst(cell);
+
+		if (!first)
+			appendStringInfoString(&sql, ", ");
+		first = false;
+
+		if (!ifxDeparseRemoteExpr((Node *) tle->expr, &context))
+			elog(ERROR, "could not deparse target list for remote query");
+	}
+
+	appendStringInfo(&sql, " FROM %s",
+					 ifxQuoteIdent(coninfo, coninfo->tablename));
+
+	ifxDeparseCondList(where_conds, " WHERE ", &context);
+
+	/*
+	 * Only grouping expressions carry a sort group reference
+	 * in the remote target list.
+	 */
+	first = true;
+	foreach(cell, tlist)
+	{
+		TargetEntry *tle = (TargetEntry *) lfirst(cell);
+
+		if (tle->ressortgroupref == 0)
+			continue;
+
+		appendStringInfoString(&sql, (first) ? " GROUP BY " : ", ");
+		first = false;
+
+		appendStringInfo(&sql, "%d", tle->resno);
+	}
+
+	ifxDeparseCondList(having_conds, " HAVING ", &context);
+
+	state->stmt_info.query = sql.data;
+}
+
+/*
+ * Appends the FROM clause item for the specified relation
+ * of a join pushed down to the Informix server. Foreign tables
+ * get the alias r<relid>, which is used to qualify column references.
+ * Join relations are deparsed into ANSI join syntax, nested joins
+ * on the inner side are put into parentheses.
+ */
+static void ifxDeparseFromItem(RelOptInfo        *rel,
+							   IfxDeparseContext *context,
+							   bool               parenthesize)
+{
+	IfxFdwPlanState *planState = (IfxFdwPlanState *) rel->fdw_private;
+
+	if (IFX_IS_SIMPLE_REL(rel))
+	{
+		appendStringInfo(context->buf, "%s r%d",
+						 ifxQuoteIdent(planState->coninfo,
+									   planState->coninfo->tablename),
+						 rel->relid);
+		return;
+	}
+
+	if (parenthesize)
+		appendStringInfoChar(context->buf, '(');
+
+	ifxDeparseFromItem(planState->outerrel, context, false);
+
+	switch (planState->jointype)
+	{
+		case JOIN_INNER:
+			appendStringInfoString(context->buf, " INNER JOIN ");
+			break;
+		case JOIN_LEFT:
+			appendStringInfoString(context->buf, " LEFT OUTER JOIN ");
+			break;
+		default:
+			elog(ERROR, "unsupported join type %d for remote query",
+				 planState->jointype);
+	}
+
+	ifxDeparseFromItem(planState->innerrel, context, true);
+
+	if (planState->joinclauses != NIL)
+		ifxDeparseCondList(planState->joinclauses, " ON ", context);
+	else
+		appendStringInfoString(context->buf, " ON (1 = 1)");
+
+	if (parenthesize)
+		appendStringInfoChar(context->buf, ')');
+}
+
+/*
+ * Generates the SELECT statement for a join of foreign tables
+ * pushed down to the Informix server. The plan state of the join
+ * relation must have been initialized by ifxGetForeignJoinPaths().
+ *
+ * Semi joins are deparsed into an EXISTS() subquery on the inner
+ * relation, since Informix doesn't have an equivalent join type.
+ *
+ * The generated query string will be stored into the
+ * specified execution state structure.
+ */
+void ifxGenerateJoinSql(IfxFdwExecutionState *state,
+						PlannerInfo          *root,
+						RelOptInfo           *joinrel,
+						List                 *tlist)
+{
+	IfxFdwPlanState  *planState = (IfxFdwPlanState *) joinrel->fdw_private;
+	StringInfoData    sql;
+	IfxDeparseContext context;
+	ListCell         *cell;
+	bool              first;
+
+	Assert((state != NULL) && (planState != NULL));
+
+	initStringInfo(&sql);
+
+	context.root        = root;
+	context.scanrel     = joinrel;
+	context.buf         = &sql;
+	context.qualify_col = true;
+	context.extensions  = ifxRelShippableExtensions(root, joinrel);
+
+	appendStringInfoString(&sql, "SELECT ");
+
+	/*
+	 * The join might not need any columns at all, e.g. for
+	 * count(*). Informix requires a non-empty select list, though.
+	 */
+	if (tlist == NIL)
+		appendStringInfoString(&sql, "1");
+
+	first = true;
+	foreach(cell, tlist)
+	{
+		TargetEntry *tle = (TargetEntry *) lfirst(cell);
+
+		if (!first)
+			appendStringInfoString(&sql, ", ");
+		first = false;
+
+		if (!ifxDeparseRemoteExpr((Node *) tle->expr, &context))
+			elog(ERROR, "could not deparse target list for remote query");
+	}
+
+	appendStringInfoString(&sql, " FROM ");
+
+	if (planState->jointype == JOIN_SEMI)
+	{
+		ifxDeparseFromItem(planState->outerrel, &context, false);
+		ifxDeparseCondList(planState->remote_conds, " WHERE ", &context);
+
+		appendStringInfoString(&sql,
+							   (planState->remote_conds != NIL) ? " AND " : " WHERE ");
+		appendStringInfoString(&sql, "EXISTS (SELECT 1 FROM ");
+		ifxDeparseFromItem(planState->innerrel, &context, false);
+		ifxDeparseCondList(planState->joinclauses, " WHERE ", &context);
+		appendStringInfoChar(&sql, ')');
+	}
+	else
+	{
+		ifxDeparseFromItem(joinrel, &context, false);
+		ifxDeparseCondList(planState->remote_conds, " WHERE ", &context);
+	}
+
+	state->stmt_info.query = sql.data;
+}
+
+/*
+ * Generates an UPDATE or DELETE statement executed directly
+ * by the Informix server, without fetching the affected rows
+ * first. targetlist holds the TargetEntry of each column set by
+ * an UPDATE, its resno being the attribute number of the column.
+ *
+ * All expressions in targetlist and where_conds must have
+ * been checked by ifxIsShippableExpr() before.
+ *
+ * The generated query string will be stored into the
+ * specified execution state structure.
+ */
+void ifxGenerateDirectModifySql(IfxFdwExecutionState *state,
+								IfxConnectionInfo    *coninfo,
+								PlannerInfo          *root,
+								RelOptInfo           *baserel,
+								CmdType               operation,
+								List                 *targetlist,
+								List                 *where_conds)
+{
+	StringInfoData    sql;
+	IfxDeparseContext context;
+	ListCell         *cell;
+	bool              first;
+
+	Assert((state != NULL)
+		   && (coninfo != NULL)
+		   && (coninfo->tablename != NULL));
+
+	initStringInfo(&sql);
+
+	context.root        = root;
+	context.scanrel     = baserel;
+	context.buf         = &sql;
+	context.qualify_col = false;
+	context.extensions  = ifxRelShippableExtensions(root, baserel);
+
+	switch (operation)
+	{
+		case CMD_UPDATE:
+		{
+			if (targetlist == NIL)
+				elog(ERROR, "empty column list for foreign table");
+
+			appendStringInfo(&sql, "UPDATE %s SET ",
+							 ifxQuoteIdent(coninfo, coninfo->tablename));
+
+			first = true;
+			foreach(cell, targetlist)
+			{
+				TargetEntry *tle = (TargetEntry *) lfirst(cell);
+
+				if (!first)
+					appendStringInfoString(&sql, ", ");
+				first = false;
+
+				appendStringInfo(&sql, "%s = ",
+								 dispatchColumnIdentifier(baserel->relid,
+														  tle->resno,
+														  root, false));
+
+				if (!ifxDeparseRemoteExpr((Node *) tle->expr, &context))
+					elog(ERROR, "could not deparse target list for remote query");
+			}
+
+			break;
+		}
+		case CMD_DELETE:
+			appendStringInfo(&sql, "DELETE FROM %s",
+							 ifxQuoteIdent(coninfo, coninfo->tablename));
+			break;
+		default:
+			elog(ERROR, "unsupported command type %d for remote modify",
+				 operation);
+	}
+
+	ifxDeparseCondList(where_conds, " WHERE ", &context);
+
+	state->stmt_info.query = sql.data;
+}
+
+/*
+ * Generates an INSERT INTO ... SELECT statement executed directly by
+ * the Informix server, inserting the rows of the foreign table scanned
+ * by scanrel into the table described by coninfo and foreignTableOid.
+ * targetlist holds the TargetEntry of each inserted column, its resno
+ * being the attribute number of the column.
+ *
+ * All expressions in targetlist and where_conds must have
+ * been checked by ifxIsShippableExpr() before.
+ *
+ * The generated query string will be stored into the
+ * specified execution state structure.
+ */
+void ifxGenerateInsertSelectSql(IfxFdwExecutionState *state,
+								IfxConnectionInfo    *coninfo,
+								Oid                   foreignTableOid,
+								PlannerInfo          *root,
+								RelOptInfo           *scanrel,
+								List                 *targetlist,
+								List                 *where_conds)
+{
+	IfxFdwPlanState  *planState = (IfxFdwPlanState *) scanrel->fdw_private;
+	StringInfoData    sql;
+	IfxDeparseContext context;
+	ListCell         *cell;
+	bool              first;
+
+	Assert((state != NULL)
+		   && (coninfo != NULL)
+		   && (coninfo->tablename != NULL)
+		   && (planState != NULL));
+
+	if (targetlist == NIL)
+		elog(ERROR, "empty column list for foreign table");
+
+	initStringInfo(&sql);
+
+	context.root        = root;
+	context.scanrel     = scanrel;
+	context.buf         = &sql;
+	context.qualify_col = false;
+	context.extensions  = ifxRelShippableExtensions(root, scanrel);
+
+	appendStringInfo(&sql, "INSERT INTO %s(",
+					 ifxQuoteIdent(coninfo, coninfo->tablename));
+
+	first = true;
+	foreach(cell, targetlist)
+	{
+		TargetEntry *tle = (TargetEntry *) lfirst(cell);
+
+		if (!first)
+			appendStringInfoString(&sql, ", ");
+		first = false;
+
+		appendStringInfoString(&sql,
+							   ifxColumnIdentifierByRelid(foreignTableOid,
+														  tle->resno));
+	}
+
+	appendStringInfoString(&sql, ") SELECT ");
+
+	first = true;
+	foreach(cell, targetlist)
+	{
+		TargetEntry *tle = (TargetEntry *) lfirst(cell);
+
+		if (!first)
+			appendStringInfoString(&sql, ", ");
+		first = false;
+
+		if (!ifxDeparseRemoteExpr((Node *) tle->expr, &context))
+			elog(ERROR, "could not deparse target list for remote query");
+	}
+
+	appendStringInfo(&sql, " FROM %s",
+					 ifxQuoteIdent(planState->coninfo,
+								   planState->coninfo->tablename));
+
+	ifxDeparseCondList(where_conds, " WHERE ", &context);
+
+	state->stmt_info.query = sql.data;
+}
+
+/*
+ * Returns the column of the specified relation the given pathkey
+ * sorts by, if the Informix server sorts it the same way. Columns of
+ * collatable types are never considered, since Informix sorts them
+ * according to the locale of the database. Returns NULL if there's
+ * no such column.
+ */
+Var *ifxPathKeyVar(PathKey *pathkey, RelOptInfo *rel)
+{
+	EquivalenceClass *ec = pathkey->pk_eclass;
+	ListCell         *cell;
+
+	if (ec->ec_has_volatile)
+		return NULL;
+
+	foreach(cell, ec->ec_members)
+	{
+		EquivalenceMember *em  = (EquivalenceMember *) lfirst(cell);
+		Var               *var = (Var *) em->em_expr;
+		TypeCacheEntry    *typentry;
+
+		if (em->em_is_child
+			|| !bms_equal(em->em_relids, rel->relids)
+			|| !IsA(var, Var))
+			continue;
+
+		if ((var->varno != rel->relid)
+			|| (var->varattno <= 0)
+			|| (var->varlevelsup != 0)
+			|| type_is_collatable(var->vartype))
+			continue;
+
+		/* only the default sort order of the column type */
+		typentry = lookup_type_cache(var->vartype, TYPECACHE_BTREE_OPFAMILY);
+
+		if (typentry->btree_opf != pathkey->pk_opfamily)
+			continue;
+
+		return var;
+	}
+
+	return NULL;
+}
+
+/*
+ * Appends an ORDER BY clause for the specified pathkeys of
+ * a foreign table scan to the given query. All pathkeys must have
+ * been checked by ifxPathKeyVar() before. NULL ordering is left to
+ * the Informix server.
+ */
+void ifxGenerateOrderBySql(StringInfo   buf,
+						   PlannerInfo *root,
+						   RelOptInfo  *rel,
+						   List        *pathkeys)
+{
+	IfxDeparseContext context;
+	ListCell         *cell;
+	bool              first;
+
+	context.root        = root;
+	context.scanrel     = rel;
+	context.buf         = buf;
+	context.qualify_col = false;
+	context.extensions  = ifxRelShippableExtensions(root, rel);
+
+	first = true;
+	foreach(cell, pathkeys)
+	{
+		PathKey *pathkey = (PathKey *) lfirst(cell);
+		Var     *var     = ifxPathKeyVar(pathkey, rel);
+
+		appendStringInfoString(buf, (first) ? " ORDER BY " : ", ");
+
+		if ((var == NULL)
+			|| !ifxDeparseRemoteExpr((Node *) var, &context))
+			elog(ERROR, "could not deparse sort key for remote query");
+
+		appendStringInfoString(buf,
+							   (pathkey->pk_strategy == BTLessStrategyNumber)
+							   ? " ASC" : " DESC");
+		first = false;
+	}
+}
+
+#endif
+
 /*
  * If the specified connection handle was initialized
  * with DELIMIDENT, ifxQuoteIdent() will return a quoted
@@ -653,6 +1265,78 @@ char *ifxQuoteIdent(IfxConnectionInfo *coninfo, char *ident)
 	}
 }
 
+/*
+ * Returns the shape of the given remote query, that is
+ * the query text with all string and numeric literals replaced
+ * by a '?' placeholder. Quoted identifiers are kept as they are.
+ */
+char *ifxQueryShape(char *query)
+{
+	StringInfoData buf;
+	char          *ptr = query;
+
+	initStringInfo(&buf);
+
+	while (*ptr != '\0')
+	{
+		if (*ptr == '\'')
+		{
+			/* skip string literal, '' is an escaped quote */
+			ptr++;
+			while (*ptr != '\0')
+			{
+				if (*ptr == '\'' && *(ptr + 1) == '\'')
+					ptr += 2;
+				else if (*ptr == '\'')
+				{
+					ptr++;
+					break;
+				}
+				else
+					ptr++;
+			}
+
+			appendStringInfoChar(&buf, '?');
+		}
+		else if (*ptr == '"')
+		{
+			/* copy quoted identifier */
+			appendStringInfoChar(&buf, *ptr++);
+			while (*ptr != '\0' && *ptr != '"')
+				appendStringInfoChar(&buf, *ptr++);
+
+			if (*ptr == '"')
+				appendStringInfoChar(&buf, *ptr++);
+		}
+		else if (isdigit((unsigned char) *ptr)
+				 && (ptr == query
+					 || !(isalnum((unsigned char) *(ptr - 1))
+						  || *(ptr - 1) == '_'
+						  || *(ptr - 1) == '.')))
+		{
+			/* skip numeric literal, including any fraction and exponent */
+			while (isdigit((unsigned char) *ptr) || *ptr == '.')
+				ptr++;
+
+			if ((*ptr == 'e' || *ptr == 'E')
+				&& (isdigit((unsigned char) *(ptr + 1))
+					|| ((*(ptr + 1) == '+' || *(ptr + 1) == '-')
+						&& isdigit((unsigned char) *(ptr + 2)))))
+			{
+				ptr += 2;
+				while (isdigit((unsigned char) *ptr))
+					ptr++;
+			}
+
+			appendStringInfoChar(&buf, '?');
+		}
+		else
+			appendStringInfoChar(&buf, *ptr++);
+	}
+
+	return buf.data;
+}
+
 #if PG_VERSION_NUM >= 90500
 
 /*
@@ -0,0 +1,4 @@
+CREATE FUNCTION ifx_fdw_truncate(IN foreign_table regclass)
+RETURNS void
+AS 'MODULE_PATHNAME', 'ifxTruncateTable'
+LANGUAGE C VOLATILE STRICT;
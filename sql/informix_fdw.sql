@@ -279,6 +279,42 @@ SET client_min_messages TO ERROR;
 -- should succeed
 ANALYZE inttest;
 
+--
+-- ANALYZE importing the Informix catalog statistics
+--
+ALTER FOREIGN TABLE inttest OPTIONS (ADD import_statistics 'true');
+
+SELECT histogram_bounds::text AS f1_bounds FROM pg_stats
+WHERE schemaname = 'public' AND tablename = 'inttest' AND attname = 'f1' \gset
+
+-- syscolumns records the second smallest and second largest value
+-- of the bigint column f1 as an INTEGER, so they can't replace the
+-- histogram sampled before
+ANALYZE inttest;
+
+SELECT attname, histogram_bounds::text = :'f1_bounds' AS kept
+FROM pg_stats
+WHERE schemaname = 'public' AND tablename = 'inttest' AND attname = 'f1';
+
+ALTER FOREIGN TABLE inttest OPTIONS (DROP import_statistics);
+
+CREATE FOREIGN TABLE ifx_systables(tabname varchar(128), owner char(32),
+                                   partnum integer, tabid integer)
+SERVER test_server
+OPTIONS (table 'systables',
+         client_locale :'CLIENT_LOCALE',
+         db_locale :'DB_LOCALE',
+         database :'INFORMIXDB',
+         import_statistics 'true');
+
+-- tabid is declared NOT NULL and has a unique index
+ANALYZE ifx_systables;
+
+SELECT attname, null_frac, n_distinct FROM pg_stats
+WHERE schemaname = 'public' AND tablename = 'ifx_systables' AND attname = 'tabid';
+
+DROP FOREIGN TABLE ifx_systables;
+
 --
 -- ALTER FOREIGN TABLE ... DROP COLUMN
 --
@@ -129,6 +129,19 @@ DELETE FROM weird_table WHERE ival10 BETWEEN interval '3 days' AND interval '3 d
 --
 SELECT * FROM weird_table ORDER BY id ASC;
 
+--
+-- INTERVAL constants are pushed down only when compared with
+-- an interval of the same class
+--
+
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT id FROM weird_table WHERE ival7 = interval '3 years 3 months';
+
+-- a YEAR TO MONTH constant can't be compared with a DAY TO SECOND
+-- interval by the Informix server, evaluated locally
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT id FROM weird_table WHERE ival10 = interval '3 years';
+
 --------------------------------------------------------------------------------
 -- Regression Tests End, Cleanup
 --------------------------------------------------------------------------------
@@ -903,6 +903,770 @@ COMMIT;
 --
 ALTER FOREIGN TABLE inttest OPTIONS(DROP disable_rowid);
 
+--------------------------------------------------------------------------------
+-- Aggregate pushdown
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 10, 2), (3, 20, 3), (4, 20, NULL), (5, 30, 5);
+
+-- GROUP BY and aggregates are evaluated by the Informix server
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT f2, count(*), sum(f3) FROM inttest WHERE f1 > 1 GROUP BY f2;
+
+SELECT f2, count(*), sum(f3) FROM inttest WHERE f1 > 1 GROUP BY f2 ORDER BY f2;
+
+-- HAVING is evaluated remotely, too
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT f2, count(*) FROM inttest GROUP BY f2 HAVING count(*) > 1;
+
+SELECT f2, count(*) FROM inttest GROUP BY f2 HAVING count(*) > 1 ORDER BY f2;
+
+-- DISTINCT aggregates and NULL values
+SELECT count(DISTINCT f2), count(f3), min(f3), max(f3) FROM inttest;
+
+-- AVG() returns NUMERIC, which is mapped to a DECIMAL
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT f2, avg(f3) FROM inttest GROUP BY f2;
+
+SELECT f2, avg(f3) FROM inttest GROUP BY f2 ORDER BY f2;
+
+-- partial aggregation of a foreign table partition
+CREATE TABLE inttest_agg(f1 bigint not null, f2 integer, f3 smallint)
+PARTITION BY RANGE (f1);
+CREATE TABLE inttest_agg_local PARTITION OF inttest_agg
+FOR VALUES FROM (100) TO (MAXVALUE);
+ALTER TABLE inttest_agg ATTACH PARTITION inttest FOR VALUES FROM (MINVALUE) TO (100);
+INSERT INTO inttest_agg_local VALUES(100, 10, 10), (101, 40, 40);
+
+SET enable_partitionwise_aggregate = on;
+
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT f2, count(*), sum(f3) FROM inttest_agg GROUP BY f2;
+
+SELECT f2, count(*), sum(f3) FROM inttest_agg GROUP BY f2 ORDER BY f2;
+
+RESET enable_partitionwise_aggregate;
+
+-- without predicate pushdown, the WHERE condition and the aggregates
+-- are evaluated locally
+ALTER FOREIGN TABLE inttest OPTIONS (ADD disable_predicate_pushdown '1');
+
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT f2, count(*), sum(f3) FROM inttest WHERE f1 > 1 GROUP BY f2;
+
+SELECT f2, count(*), sum(f3) FROM inttest WHERE f1 > 1 GROUP BY f2 ORDER BY f2;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Join pushdown
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, 2), (3, 30, 3);
+INSERT INTO varchar_test VALUES(1, 'one', 'eins', 'un'), (2, 'two', 'zwei', 'deux'),
+       (4, 'four', 'vier', 'quatre');
+
+-- inner join, the conditions of both tables are evaluated remotely
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT t.f1, t.f2, v.v1 FROM inttest t JOIN varchar_test v ON t.f1 = v.id WHERE t.f2 > 10;
+
+SELECT t.f1, t.f2, v.v1 FROM inttest t JOIN varchar_test v ON t.f1 = v.id ORDER BY t.f1;
+
+-- left join
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT t.f1, v.v1 FROM inttest t LEFT JOIN varchar_test v ON t.f1 = v.id;
+
+SELECT t.f1, v.v1 FROM inttest t LEFT JOIN varchar_test v ON t.f1 = v.id ORDER BY t.f1;
+
+-- semi join
+SELECT f1 FROM inttest t WHERE EXISTS (SELECT 1 FROM varchar_test v WHERE v.id = t.f1) ORDER BY f1;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Direct modify
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, 2), (3, 30, 3);
+
+-- UPDATE and DELETE are executed by the Informix server directly
+EXPLAIN (VERBOSE, COSTS OFF) UPDATE inttest SET f2 = f2 + 1 WHERE f1 > 1;
+
+UPDATE inttest SET f2 = f2 + 1 WHERE f1 > 1;
+
+SELECT * FROM inttest ORDER BY f1;
+
+EXPLAIN (VERBOSE, COSTS OFF) DELETE FROM inttest WHERE f3 = 3;
+
+DELETE FROM inttest WHERE f3 = 3;
+
+SELECT * FROM inttest ORDER BY f1;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- INSERT with batch_size and insert_buffer_size
+--------------------------------------------------------------------------------
+
+-- should fail
+ALTER FOREIGN TABLE inttest OPTIONS (ADD batch_size '0');
+
+-- should fail
+ALTER FOREIGN TABLE inttest OPTIONS (ADD insert_buffer_size 'abc');
+
+BEGIN;
+
+ALTER FOREIGN TABLE inttest OPTIONS (ADD batch_size '2', ADD insert_buffer_size '4096');
+
+-- the rows are flushed after every second row and at the end
+INSERT INTO inttest SELECT t.id, t.id * 10, t.id FROM generate_series(1, 5) AS t(id);
+
+SELECT * FROM inttest ORDER BY f1;
+
+-- RETURNING executes the INSERT for each row, without buffering
+INSERT INTO inttest VALUES(6, 60, 6) RETURNING f1, f2;
+
+SELECT count(*) FROM inttest;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- COPY FROM and tuple routing into foreign table partitions
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+COPY inttest FROM STDIN;
+1	10	1
+2	20	\N
+\.
+
+SELECT * FROM inttest ORDER BY f1;
+
+CREATE TABLE inttest_parted(f1 bigint not null, f2 integer, f3 smallint)
+PARTITION BY RANGE (f1);
+CREATE TABLE inttest_parted_local PARTITION OF inttest_parted
+FOR VALUES FROM (100) TO (MAXVALUE);
+ALTER TABLE inttest_parted ATTACH PARTITION inttest FOR VALUES FROM (MINVALUE) TO (100);
+
+INSERT INTO inttest_parted VALUES(3, 30, 3), (100, 1000, NULL);
+
+COPY inttest_parted FROM STDIN;
+4	40	4
+101	1010	\N
+\.
+
+SELECT tableoid::regclass AS part, * FROM inttest_parted ORDER BY f1;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- ROWID based UPDATE and DELETE in batches
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+ALTER FOREIGN TABLE inttest OPTIONS (ADD batch_size '3');
+
+INSERT INTO inttest SELECT t.id, t.id * 10, t.id FROM generate_series(1, 5) AS t(id);
+
+-- random() isn't shippable, so the rows are modified by their ROWID
+EXPLAIN (VERBOSE, COSTS OFF) UPDATE inttest SET f2 = 0 WHERE random() >= 0;
+
+-- a full batch of three rows and a partial one
+UPDATE inttest SET f2 = 0 WHERE random() >= 0;
+
+SELECT * FROM inttest ORDER BY f1;
+
+-- different values for each row, every batch holds a single row
+UPDATE inttest SET f2 = f1 * 2 WHERE random() >= 0;
+
+SELECT * FROM inttest ORDER BY f1;
+
+EXPLAIN (VERBOSE, COSTS OFF) DELETE FROM inttest WHERE random() >= 0;
+
+DELETE FROM inttest WHERE random() >= 0 AND f1 > 1;
+
+SELECT * FROM inttest ORDER BY f1;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Statement cache
+--------------------------------------------------------------------------------
+
+-- should fail
+ALTER SERVER test_server OPTIONS (ADD statement_cache_size '-1');
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, 2), (3, 30, 3);
+
+-- the second and third execution reuse the cached statement
+SELECT * FROM inttest WHERE f1 > 1 ORDER BY f1;
+
+SELECT * FROM inttest WHERE f1 > 1 ORDER BY f1;
+
+UPDATE inttest SET f2 = f2 + 1 WHERE f1 = 3;
+
+SELECT * FROM inttest WHERE f1 > 1 ORDER BY f1;
+
+-- both scans use the same query, the second one can't use the cached
+-- statement while the first one keeps its cursor open
+SELECT f1 FROM inttest WHERE f1 > 1 UNION ALL SELECT f1 FROM inttest WHERE f1 > 1 ORDER BY f1;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Cached statements with prepared plans
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, 2), (3, 30, 3);
+
+-- the generic plan refers to the cached statement across executions
+PREPARE ifx_cached_scan AS SELECT * FROM inttest WHERE f1 > 1 ORDER BY f1;
+
+EXECUTE ifx_cached_scan;
+
+INSERT INTO inttest VALUES(4, 40, 4);
+
+EXECUTE ifx_cached_scan;
+
+DEALLOCATE ifx_cached_scan;
+
+CREATE FUNCTION pg_temp.ifx_sum_loop(n integer) RETURNS bigint
+LANGUAGE plpgsql AS $$
+DECLARE
+  result bigint := 0;
+  i      integer;
+BEGIN
+  FOR i IN 1..n LOOP
+    result := result + (SELECT f2 FROM inttest WHERE f1 = 1);
+  END LOOP;
+  RETURN result;
+END;
+$$;
+
+SELECT pg_temp.ifx_sum_loop(10);
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Cached remote estimates
+--------------------------------------------------------------------------------
+
+-- should fail
+ALTER FOREIGN TABLE inttest OPTIONS (ADD estimate_cache_ttl '-1');
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, 2), (3, 30, 3);
+
+SELECT * FROM inttest WHERE f1 = 1;
+
+-- same query shape, planned from the cached estimates but the remote
+-- query must carry the actual constant
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE f1 = 3;
+
+SELECT * FROM inttest WHERE f1 = 3;
+
+-- the column widths cached with the estimates are used by each
+-- query planned with the same shape
+SELECT f2 FROM inttest WHERE f1 = 1;
+
+SELECT f2 FROM inttest WHERE f1 = 2;
+
+SELECT f2 FROM inttest WHERE f1 = 3;
+
+ALTER FOREIGN TABLE inttest OPTIONS (ADD estimate_cache_ttl '0');
+
+SELECT * FROM inttest WHERE f1 = 2;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Planning from local statistics
+--------------------------------------------------------------------------------
+
+-- should fail
+ALTER FOREIGN TABLE inttest OPTIONS (ADD use_remote_estimate 'maybe');
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, 2), (3, 30, 3);
+
+ALTER FOREIGN TABLE inttest OPTIONS (ADD use_remote_estimate 'false');
+
+-- the remote query is generated without contacting the Informix server
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE f1 >= 2;
+
+-- the statement is prepared when the scan begins
+SELECT * FROM inttest WHERE f1 >= 2 ORDER BY f1;
+
+-- UPDATE still plans remotely
+UPDATE inttest SET f2 = f2 * 2 WHERE f1 = 1;
+
+SELECT * FROM inttest ORDER BY f1;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Cost model options
+--------------------------------------------------------------------------------
+
+-- should fail
+ALTER FOREIGN TABLE inttest OPTIONS (ADD fdw_startup_cost '-1');
+
+-- should fail
+ALTER FOREIGN TABLE inttest OPTIONS (ADD remote_cost_factor 'abc');
+
+BEGIN;
+
+-- local estimates of a table never analyzed don't depend on the
+-- Informix server, so the costs are stable
+ALTER FOREIGN TABLE inttest OPTIONS (ADD use_remote_estimate 'false');
+
+EXPLAIN SELECT * FROM inttest WHERE f2 IS NOT NULL;
+
+ALTER SERVER test_server OPTIONS (ADD fdw_startup_cost '1000', ADD fdw_tuple_cost '2');
+
+EXPLAIN SELECT * FROM inttest WHERE f2 IS NOT NULL;
+
+-- options of the foreign table override those of the foreign server
+ALTER FOREIGN TABLE inttest OPTIONS (ADD fdw_startup_cost '10', ADD fdw_tuple_cost '0.5');
+
+EXPLAIN SELECT * FROM inttest WHERE f2 IS NOT NULL;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Row estimates corrected by executed scans
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+ALTER FOREIGN TABLE inttest OPTIONS (ADD use_remote_estimate 'false');
+
+INSERT INTO inttest VALUES(1, 10, NULL), (2, 20, NULL), (3, 30, 3);
+
+EXPLAIN SELECT * FROM inttest WHERE f3 IS NOT NULL;
+
+SELECT * FROM inttest WHERE f3 IS NOT NULL;
+
+-- the estimate is blended with the single row returned by the scan above
+EXPLAIN SELECT * FROM inttest WHERE f3 IS NOT NULL;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- ANALYZE with remote sampling
+--------------------------------------------------------------------------------
+
+-- should fail
+ALTER FOREIGN TABLE inttest OPTIONS (ADD analyze_sampling 'maybe');
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, 2), (3, 30, NULL), (4, 40, 4), (5, 50, 5);
+
+-- the table is smaller than the sample, so all rows are analyzed
+ANALYZE inttest;
+
+SELECT reltuples FROM pg_class WHERE oid = 'inttest'::regclass;
+
+SELECT attname, null_frac FROM pg_stats
+WHERE schemaname = 'public' AND tablename = 'inttest' ORDER BY attname;
+
+ALTER FOREIGN TABLE inttest OPTIONS (ADD analyze_sampling 'false');
+
+ANALYZE inttest;
+
+SELECT reltuples FROM pg_class WHERE oid = 'inttest'::regclass;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- ANALYZE importing the Informix catalog statistics
+--------------------------------------------------------------------------------
+
+-- should fail
+ALTER FOREIGN TABLE inttest OPTIONS (ADD import_statistics 'maybe');
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, 2), (3, 30, NULL), (4, 40, 4), (5, 50, 5);
+
+ANALYZE inttest;
+
+ALTER FOREIGN TABLE inttest OPTIONS (ADD import_statistics 'true');
+
+-- Informix doesn't record NULL values, the NULL fraction sampled
+-- before must be kept
+ANALYZE inttest;
+
+SELECT attname, null_frac FROM pg_stats
+WHERE schemaname = 'public' AND tablename = 'inttest' ORDER BY attname;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Sorted foreign scans
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+-- plan from local statistics, so that sorting remotely is cheaper
+-- than sorting the estimated number of rows locally
+ALTER FOREIGN TABLE inttest OPTIONS (ADD use_remote_estimate 'false');
+
+INSERT INTO inttest VALUES(2, 20, 2), (3, 30, 3), (1, 10, 1), (4, NULL, 4);
+
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE f2 IS NOT NULL ORDER BY f1;
+
+SELECT * FROM inttest WHERE f2 IS NOT NULL ORDER BY f1;
+
+SELECT * FROM inttest WHERE f2 IS NOT NULL ORDER BY f1 DESC;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Pushdown of date/time constants
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+SET LOCAL DateStyle TO 'ISO, DMY';
+
+INSERT INTO datetime_test(v1, v2, v3) VALUES('2013-08-19 15:30:00', '2013-08-19', '15:30:00'),
+       ('2013-08-20 16:45:30', '2013-08-20', '16:45:30');
+
+-- the literals don't depend on the DATE and DATETIME formats
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT v2, v3 FROM datetime_test WHERE v2 = '2013-08-20' AND v3 > '16:00:00';
+
+SELECT v2, v3 FROM datetime_test WHERE v2 = '2013-08-20' AND v3 > '16:00:00';
+
+-- infinity has no Informix representation, evaluated locally
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT v2, v3 FROM datetime_test WHERE v2 < 'infinity';
+
+SELECT v2, v3 FROM datetime_test WHERE v2 < 'infinity' ORDER BY v2;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Predicate pushdown per restriction clause
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, NULL), (3, 30, 3);
+
+-- the shippable clause is pushed down, the other one is filtered locally
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE f1 > 1 AND random() >= 0;
+
+SELECT * FROM inttest WHERE f1 > 1 AND random() >= 0 ORDER BY f1;
+
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE (f1 = 1 OR f2 = 30) AND f3 IS NOT NULL;
+
+SELECT * FROM inttest WHERE (f1 = 1 OR f2 = 30) AND f3 IS NOT NULL ORDER BY f1;
+
+-- an OR expression with an argument not shippable is evaluated locally
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE f1 = 1 OR random() < 0;
+
+SELECT * FROM inttest WHERE f1 = 1 OR random() < 0;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Query parameters bound by outer plan nodes
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+INSERT INTO varchar_test(v1, v2, v3) VALUES('abc', 'def', 'ghi'), ('jkl', 'mno', 'pqr');
+
+-- the parameter of a correlated subquery is set by the outer plan only,
+-- so the cursor must not be opened before the first fetch
+EXPLAIN (VERBOSE, COSTS OFF) SELECT o.name, (SELECT v.v1 FROM varchar_test v WHERE v.v2 = o.name) FROM (VALUES('def'), ('mno'), ('xyz')) o(name);
+
+SELECT o.name, (SELECT v.v1 FROM varchar_test v WHERE v.v2 = o.name) FROM (VALUES('def'), ('mno'), ('xyz')) o(name);
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Pushdown of shippable operators and functions
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+INSERT INTO varchar_test(v1, v2, v3) VALUES('abc', 'def', 'ghi'), ('Abd', 'xyz', 'uvw');
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, NULL), (3, 30, 3);
+
+EXPLAIN (VERBOSE, COSTS OFF) SELECT v1, v2 FROM varchar_test WHERE upper(v1) = 'ABC';
+
+SELECT v1, v2 FROM varchar_test WHERE upper(v1) = 'ABC';
+
+EXPLAIN (VERBOSE, COSTS OFF) SELECT v1, v2 FROM varchar_test WHERE v1 ILIKE 'ab%';
+
+SELECT v1, v2 FROM varchar_test WHERE v1 ILIKE 'ab%' ORDER BY v2;
+
+EXPLAIN (VERBOSE, COSTS OFF) SELECT v1, v2 FROM varchar_test WHERE v1 || v2 = 'abcdef';
+
+SELECT v1, v2 FROM varchar_test WHERE v1 || v2 = 'abcdef';
+
+-- functions without an Informix equivalent are evaluated locally
+EXPLAIN (VERBOSE, COSTS OFF) SELECT v1, v2 FROM varchar_test WHERE reverse(v1) = 'cba';
+
+SELECT v1, v2 FROM varchar_test WHERE reverse(v1) = 'cba';
+
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE f2 % 20 = 0;
+
+SELECT * FROM inttest WHERE f2 % 20 = 0;
+
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE coalesce(f3, 0) = 0;
+
+SELECT * FROM inttest WHERE coalesce(f3, 0) = 0;
+
+-- implicit casts into NUMERIC get an explicit DECIMAL precision
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE f2 + 0.5 > 20;
+
+SELECT * FROM inttest WHERE f2 + 0.5 > 20 ORDER BY f1;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Key set tables
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, NULL), (3, 30, 3);
+
+ALTER FOREIGN TABLE inttest OPTIONS (ADD fdw_startup_cost '0');
+
+-- the name of the key set table doesn't change when the query is planned again
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE f2 = ANY(ARRAY(SELECT x FROM generate_series(10, 20, 10) x));
+
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE f2 = ANY(ARRAY(SELECT x FROM generate_series(10, 20, 10) x));
+
+SELECT * FROM inttest WHERE f2 = ANY(ARRAY(SELECT x FROM generate_series(10, 20, 10) x)) ORDER BY f1;
+
+-- each scan loads its keys into its own key set table
+SELECT * FROM inttest WHERE f2 = ANY(ARRAY(SELECT x FROM generate_series(20, 30, 10) x)) ORDER BY f1;
+
+SELECT * FROM inttest WHERE f2 = ANY(ARRAY(SELECT x FROM generate_series(10, 20, 10) x)) ORDER BY f1;
+
+-- scans open at the same time don't share their key set tables
+DECLARE c1 CURSOR FOR SELECT * FROM inttest WHERE f2 = ANY(ARRAY(SELECT x FROM generate_series(10, 20, 10) x));
+
+DECLARE c2 CURSOR FOR SELECT * FROM inttest WHERE f2 = ANY(ARRAY(SELECT x FROM generate_series(30, 40, 10) x));
+
+FETCH 1 FROM c1;
+
+FETCH ALL FROM c2;
+
+CLOSE c2;
+
+FETCH ALL FROM c1;
+
+CLOSE c1;
+
+-- the key set tables of a scan aborted by an error are dropped on rollback
+SAVEPOINT keyset_error;
+
+SELECT f1 / (f1 - 2) FROM inttest WHERE f2 = ANY(ARRAY(SELECT x FROM generate_series(10, 20, 10) x));
+
+ROLLBACK TO SAVEPOINT keyset_error;
+
+SELECT * FROM inttest WHERE f2 = ANY(ARRAY(SELECT x FROM generate_series(10, 20, 10) x)) ORDER BY f1;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Parameterized scans driven by small relations
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+INSERT INTO varchar_test(v1, v2, v3) VALUES('abc', 'def', 'ghi'), ('jkl', 'mno', 'pqr'), ('stu', 'vwx', 'yz');
+
+ALTER FOREIGN TABLE varchar_test OPTIONS (ADD join_filter_rows '10', ADD fdw_startup_cost '0');
+
+SET LOCAL enable_hashjoin TO off;
+
+SET LOCAL enable_mergejoin TO off;
+
+SET LOCAL enable_material TO off;
+
+-- the join key of each outer row is passed to the Informix server
+EXPLAIN (VERBOSE, COSTS OFF) SELECT l.name, v.v1 FROM (VALUES('def'), ('mno')) l(name) JOIN varchar_test v ON v.v2 = l.name;
+
+SELECT l.name, v.v1 FROM (VALUES('def'), ('mno')) l(name) JOIN varchar_test v ON v.v2 = l.name;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- Optimizer directives
+--------------------------------------------------------------------------------
+
+-- should fail
+ALTER FOREIGN TABLE inttest OPTIONS (ADD optimizer_directives '{+FULL(inttest)}');
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, NULL), (3, 30, 3);
+
+-- a query stopped early is optimized for its first rows
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest LIMIT 2;
+
+SELECT count(*) FROM (SELECT * FROM inttest LIMIT 2) AS t;
+
+ALTER FOREIGN TABLE inttest OPTIONS (ADD optimizer_directives 'FULL(inttest)');
+
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE f1 > 1;
+
+SELECT * FROM inttest WHERE f1 > 1 ORDER BY f1;
+
+-- an optimization goal given by the option takes precedence
+ALTER FOREIGN TABLE inttest OPTIONS (SET optimizer_directives 'FIRST_ROWS');
+
+EXPLAIN (VERBOSE, COSTS OFF) SELECT * FROM inttest WHERE f1 > 1;
+
+SELECT * FROM inttest WHERE f1 > 1 ORDER BY f1;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- INSERT ... SELECT between foreign tables of one connection
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+INSERT INTO inttest VALUES(1, 10, 1), (2, 20, NULL), (3, 30, 3);
+
+-- executed by the Informix server as a single statement
+EXPLAIN (VERBOSE, COSTS OFF) INSERT INTO serial8_test(id) SELECT f1 FROM inttest WHERE f1 > 1;
+
+INSERT INTO serial8_test(id) SELECT f1 FROM inttest WHERE f1 > 1;
+
+SELECT * FROM serial8_test ORDER BY id;
+
+-- a condition evaluated locally requires the rows to be fetched
+INSERT INTO serial8_test(id) SELECT f1 FROM inttest WHERE f1 = 1 AND random() >= 0;
+
+SELECT * FROM serial8_test ORDER BY id;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- INSERT ... RETURNING with SERIAL values generated by Informix
+--------------------------------------------------------------------------------
+
+BEGIN;
+
+EXPLAIN (VERBOSE, COSTS OFF) INSERT INTO serial_test VALUES(0) RETURNING id;
+
+-- a value given explicitly is returned as is
+INSERT INTO serial_test VALUES(42) RETURNING id;
+
+CREATE TEMP TABLE serial_returned(id integer) ON COMMIT DROP;
+
+-- 0 lets Informix generate the value, which must match the remote row
+WITH ins AS (INSERT INTO serial_test VALUES(0) RETURNING id)
+INSERT INTO serial_returned SELECT id FROM ins;
+
+SELECT r.id <> 0 AS generated, r.id = s.id AS matches
+FROM serial_returned r, serial_test s WHERE s.id <> 42;
+
+ROLLBACK;
+
+--------------------------------------------------------------------------------
+-- EXPLAIN of modify actions shows the Informix query with VERBOSE only
+--------------------------------------------------------------------------------
+
+EXPLAIN INSERT INTO inttest VALUES(1, 2, 3);
+
+EXPLAIN (VERBOSE, COSTS OFF) INSERT INTO inttest VALUES(1, 2, 3);
+
+--------------------------------------------------------------------------------
+-- TRUNCATE of the remote table by ifx_fdw_truncate()
+--------------------------------------------------------------------------------
+
+INSERT INTO inttest VALUES(1, 1, 1), (2, 2, 2), (3, 3, 3);
+
+BEGIN;
+
+SELECT ifx_fdw_truncate('inttest');
+
+ROLLBACK;
+
+-- the TRUNCATE TABLE was rolled back with the local transaction
+SELECT count(*) FROM inttest;
+
+BEGIN;
+
+SELECT ifx_fdw_truncate('inttest');
+
+COMMIT;
+
+SELECT count(*) FROM inttest;
+
+CREATE FOREIGN TABLE inttest_query(f1 bigint not null, f2 integer, f3 smallint)
+SERVER test_server
+OPTIONS (query 'SELECT * FROM inttest',
+         client_locale :'CLIENT_LOCALE',
+         db_locale :'DB_LOCALE',
+         database :'INFORMIXDB');
+
+-- should fail
+SELECT ifx_fdw_truncate('inttest_query');
+
+CREATE TEMP TABLE inttest_local(f1 bigint);
+
+-- should fail
+SELECT ifx_fdw_truncate('inttest_local');
+
+-- should fail, without locking the catalog
+SELECT ifx_fdw_truncate('pg_class');
+
+CREATE ROLE regress_ifx_truncate;
+
+SET ROLE regress_ifx_truncate;
+
+-- should fail, without the TRUNCATE privilege
+SELECT ifx_fdw_truncate('inttest');
+
+RESET ROLE;
+
+DROP ROLE regress_ifx_truncate;
+
+DROP FOREIGN TABLE inttest_query;
+
+DROP TABLE inttest_local;
+
+--------------------------------------------------------------------------------
+-- Date/time constants without an Informix literal
+--------------------------------------------------------------------------------
+
+-- TIME 24:00:00 is beyond HOUR TO SECOND, evaluated locally
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT v3 FROM datetime_test WHERE v3 < '24:00:00';
+
+-- the class of an interval column without fields is unknown,
+-- so INTERVAL constants are evaluated locally
+EXPLAIN (VERBOSE, COSTS OFF)
+SELECT f1 FROM interval_test WHERE f1 = '1 day';
+
 --------------------------------------------------------------------------------
 -- Regression Tests End, Cleanup
 --------------------------------------------------------------------------------